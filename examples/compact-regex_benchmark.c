@@ -0,0 +1,1291 @@
+#include <time.h>
+#include "compact-regex.h"
+
+/* number of iterations per measurement */
+#define BENCHMARK_ITERATIONS 20000
+
+/* returns the elapsed processor time since start_time in microseconds */
+double elapsed_microseconds(clock_t start_time)
+{
+    return (double)(clock() - start_time) * 1000000.0 / CLOCKS_PER_SEC;
+}
+
+/* example for measuring the latency of regex_compile() compared to a plain regcomp() */
+void benchmark_compile_latency()
+{
+    struct benchmark_pattern { char* name; char* pattern; char* posix_pattern; };
+    struct benchmark_pattern pattern_list[4] = {
+        { "no escapes", "^([01][0-9]|2[0-3]):[0-5][0-9]$", "^([01][0-9]|2[0-3]):[0-5][0-9]$" },
+        { "classes", "^\\w+\\s(\\d{2})[\\d|\\s]+\\W$", "^[A-Za-z0-9_]+[ ]([0-9]{2})[0-9| ]+[^A-Za-z0-9_]$" },
+        { "ascii", "\\x61\\x62\\x63 \\x31\\x32\\x33", "abc 123" },
+        { "mixed", "(\\d+)\\x2d(\\u\\l+)\\x3a\\s\\p+", "([0-9]+)-([A-Z][a-z]+):[ ][ -~]+" }
+    };
+
+    int i;
+    int j;
+    clock_t start_time;
+    double time_compile;
+    double time_regcomp;
+    regex_t compiled_regex;
+
+    printf("\nCompile latency (%d iterations):\n---------------------------------\n", BENCHMARK_ITERATIONS);
+    printf("%-12s %18s %18s\n", "Pattern", "regex_compile()", "regcomp() only");
+
+    for (i = 0; i < 4; i++)
+    {
+        start_time = clock();
+
+        for (j = 0; j < BENCHMARK_ITERATIONS; j++)
+        {
+            RegEx regex_data = regex_compile(pattern_list[i].pattern, REG_DEFAULT);
+            regex_close(regex_data);
+        }
+
+        time_compile = elapsed_microseconds(start_time) / BENCHMARK_ITERATIONS;
+        start_time = clock();
+
+        for (j = 0; j < BENCHMARK_ITERATIONS; j++)
+        {
+            regcomp(&compiled_regex, pattern_list[i].posix_pattern, REG_EXTENDED | REG_NEWLINE);
+            regfree(&compiled_regex);
+        }
+
+        time_regcomp = elapsed_microseconds(start_time) / BENCHMARK_ITERATIONS;
+
+        printf("%-12s %15.2f us %15.2f us\n", pattern_list[i].name, time_compile, time_regcomp);
+    }
+}
+
+/* example for measuring regex_match() and regex_replace() with and without the compiled-pattern cache */
+void benchmark_pattern_cache()
+{
+    char* input_string = "2025-06-14 12:01:33 INFO  [worker-7] GET /api/v1/items?id=4711 200 0.012s";
+    char pattern_list[40][32];
+
+    int i;
+    int j;
+    int cache_enabled;
+    clock_t start_time;
+    double time_match;
+    double time_replace;
+    cregcache_stats_t cache_stats;
+
+    /* 40 distinct patterns */
+    for (i = 0; i < 40; i++)
+    {
+        sprintf(pattern_list[i], "(\\d+):(\\d+)|id=%d|\\[\\w+-%d\\]", i, i);
+    }
+
+    printf("\nPattern cache (%d iterations, 40 patterns):\n-------------------------------------------\n", BENCHMARK_ITERATIONS);
+    printf("%-12s %18s %18s %10s %10s\n", "Cache", "regex_match()", "regex_replace()", "Hits", "Misses");
+
+    for (cache_enabled = 0; cache_enabled <= 1; cache_enabled++)
+    {
+        regex_cache_init(cache_enabled ? 64 : 0);
+        regex_cache_clear();
+        start_time = clock();
+
+        for (j = 0; j < BENCHMARK_ITERATIONS; j++)
+        {
+            RegEx regex_data = regex_match(input_string, pattern_list[j % 40], REG_DEFAULT);
+            regex_close(regex_data);
+        }
+
+        time_match = elapsed_microseconds(start_time) / BENCHMARK_ITERATIONS;
+        start_time = clock();
+
+        for (j = 0; j < BENCHMARK_ITERATIONS; j++)
+        {
+            free(regex_replace(input_string, pattern_list[j % 40], "#", REG_DEFAULT));
+        }
+
+        time_replace = elapsed_microseconds(start_time) / BENCHMARK_ITERATIONS;
+        cache_stats = regex_cache_stats();
+
+        printf("%-12s %15.2f us %15.2f us %10lu %10lu\n", cache_enabled ? "enabled" : "disabled", time_match, time_replace, cache_stats.hits, cache_stats.misses);
+    }
+
+    regex_cache_init(0);
+}
+
+/* creates a word list text with one word per line, every 32nd word ends with "ion" */
+char* create_word_list(int num_lines)
+{
+    char* syllables[8] = { "ka", "lo", "mer", "sti", "pu", "dra", "ne", "vox" };
+    char* text_string = malloc((num_lines * 16 + 1) * sizeof(char));
+    char* write_ptr = text_string;
+    unsigned long seed = 12345;
+    int i;
+    int j;
+
+    for (i = 0; i < num_lines; i++)
+    {
+        for (j = 0; j < 3; j++)
+        {
+            seed = seed * 1103515245UL + 12345UL;
+            strcpy(write_ptr, syllables[(seed >> 16) % 8]);
+            write_ptr += strlen(write_ptr);
+        }
+        if (i % 32 == 0)
+        {
+            strcpy(write_ptr, "ion");
+            write_ptr += 3;
+        }
+        *write_ptr++ = '\n';
+    }
+
+    *write_ptr = '\0';
+
+    return text_string;
+}
+
+/* example for measuring a global search with many matches on a word list */
+void benchmark_global_search()
+{
+    int num_lines[3] = { 50000, 200000, 466550 };
+    int i;
+    clock_t start_time;
+    double time_exec;
+
+    printf("\nGlobal search on a word list (\"^.*ion.*$\"):\n--------------------------------------------\n");
+    printf("%-10s %-10s %-10s %18s\n", "Lines", "Bytes", "Matches", "regex_exec()");
+
+    for (i = 0; i < 3; i++)
+    {
+        char* text_string = create_word_list(num_lines[i]);
+        RegEx regex_data = regex_compile("^.*ion.*$", REG_GLOBAL | REG_ICASE);
+
+        start_time = clock();
+        regex_exec(text_string, regex_data);
+        time_exec = elapsed_microseconds(start_time) / 1000.0;
+
+        printf("%-10d %-10d %-10d %15.2f ms\n", num_lines[i], (int)strlen(text_string), regex_data->num_matches, time_exec);
+
+        regex_close(regex_data);
+        free(text_string);
+    }
+}
+
+/* example for measuring the time per match of a global search with sub-expressions */
+void benchmark_match_slots()
+{
+    struct benchmark_flags { char* name; int option_flags; };
+    struct benchmark_flags flags_list[2] = {
+        { "groups", REG_DEFAULT },
+        { "REG_NOSUBEXP", REG_NOSUBEXP }
+    };
+
+    char* text_string = malloc(4000 * 16 + 1);
+    char* write_ptr = text_string;
+    int i;
+    int j;
+    clock_t start_time;
+    double time_exec;
+
+    MAX_NUM_MATCHES = 16000;
+
+    /* 4000 key-value pairs */
+    for (i = 0; i < 4000; i++)
+    {
+        write_ptr += sprintf(write_ptr, "key%d=%d ", i, i * 7);
+    }
+
+    printf("\nTime per match of \"(\\w+)=(\\d+)\" (MAX_NUM_MATCHES = %d):\n----------------------------------------------------------\n", MAX_NUM_MATCHES);
+    printf("%-14s %-10s %18s\n", "Flags", "Results", "per match");
+
+    for (i = 0; i < 2; i++)
+    {
+        RegEx regex_data = regex_compile("(\\w+)=(\\d+)", flags_list[i].option_flags);
+        int num_results = 0;
+
+        start_time = clock();
+
+        for (j = 0; j < 10; j++)
+        {
+            regex_exec(text_string, regex_data);
+            num_results = regex_data->num_matches;
+            regex_close(regex_data);
+            regex_data = regex_compile("(\\w+)=(\\d+)", flags_list[i].option_flags);
+        }
+
+        time_exec = elapsed_microseconds(start_time) / (10 * 4000);
+
+        printf("%-14s %-10d %15.2f us\n", flags_list[i].name, num_results, time_exec);
+
+        regex_close(regex_data);
+    }
+
+    free(text_string);
+}
+
+/* callback for benchmark_foreach(): counts the matches */
+int count_match(int number_match, int number_submatch, int start, int end, void* userdata)
+{
+    *(int*)userdata += 1;
+
+    return 0;
+}
+
+/* example for comparing regex_exec() with the callback search of regex_foreach() for counting matches */
+void benchmark_foreach()
+{
+    int num_lines[3] = { 50000, 200000, 466550 };
+    int i;
+    int num_results;
+    clock_t start_time;
+    double time_exec;
+    double time_foreach;
+
+    printf("\nCounting matches on a word list (\"^.*ion.*$\"):\n------------------------------------------------\n");
+    printf("%-10s %-10s %18s %18s\n", "Lines", "Matches", "regex_exec()", "regex_foreach()");
+
+    for (i = 0; i < 3; i++)
+    {
+        char* text_string = create_word_list(num_lines[i]);
+        RegEx regex_data = regex_compile("^.*ion.*$", REG_GLOBAL | REG_ICASE);
+
+        start_time = clock();
+        regex_exec(text_string, regex_data);
+        time_exec = elapsed_microseconds(start_time) / 1000.0;
+
+        num_results = 0;
+        start_time = clock();
+        regex_foreach(text_string, regex_data, count_match, &num_results);
+        time_foreach = elapsed_microseconds(start_time) / 1000.0;
+
+        printf("%-10d %-10d %15.2f ms %15.2f ms\n", num_lines[i], num_results, time_exec, time_foreach);
+
+        regex_close(regex_data);
+        free(text_string);
+    }
+}
+
+/* example for comparing regex_match() with regex_test() and regex_count() */
+void benchmark_test_count()
+{
+    char* text_string = create_word_list(200000);
+    char* pattern_list[3] = { "^kaka.*ion$", "^(\\w+)(ion)$", "vox(vox)+" };
+
+    int i;
+    int num_matches;
+    int num_count;
+    clock_t start_time;
+    double time_match;
+    double time_test;
+    double time_count;
+
+    printf("\nMatch, test and count on a word list (200000 lines):\n----------------------------------------------------\n");
+    printf("%-14s %-10s %15s %15s %15s\n", "Pattern", "Matches", "regex_match()", "regex_test()", "regex_count()");
+
+    for (i = 0; i < 3; i++)
+    {
+        RegEx regex_data;
+
+        start_time = clock();
+        regex_data = regex_match(text_string, pattern_list[i], REG_DEFAULT);
+        time_match = elapsed_microseconds(start_time) / 1000.0;
+
+        start_time = clock();
+        regex_test(text_string, pattern_list[i], REG_DEFAULT);
+        time_test = elapsed_microseconds(start_time) / 1000.0;
+
+        start_time = clock();
+        num_count = regex_count(text_string, pattern_list[i], REG_DEFAULT);
+        time_count = elapsed_microseconds(start_time) / 1000.0;
+
+        num_matches = regex_data->num_matches > 0 ? regex_data->matches[regex_data->num_matches - 1].number_match : 0;
+
+        printf("%-14s %-10d %12.2f ms %12.2f ms %12.2f ms\n", pattern_list[i], num_count, time_match, time_test, time_count);
+
+        if (num_matches != num_count)
+        {
+            printf("regex_count() differs from regex_match(): %d\n", num_matches);
+        }
+
+        regex_close(regex_data);
+    }
+
+    free(text_string);
+}
+
+#ifdef REGEX_PARALLEL_SEARCH
+/* returns the elapsed wall-clock time since start_time in milliseconds */
+double elapsed_wall_milliseconds(struct timespec* start_time)
+{
+    struct timespec end_time;
+
+    clock_gettime(CLOCK_MONOTONIC, &end_time);
+
+    return (end_time.tv_sec - start_time->tv_sec) * 1000.0 + (end_time.tv_nsec - start_time->tv_nsec) / 1000000.0;
+}
+
+/* example for comparing the global search with the parallel search of REG_PARALLEL */
+void benchmark_parallel_search()
+{
+    unsigned int num_threads[4] = { 1, 2, 4, 8 };
+    char* text_string = create_word_list(2000000);
+    int i;
+    struct timespec start_time;
+    double time_global;
+    double time_parallel;
+
+    printf("\nParallel search on a word list (\"^.*ion.*$\", %d bytes, %ld processors):\n----------------------------------------------------------------------------\n",
+        (int)strlen(text_string), sysconf(_SC_NPROCESSORS_ONLN));
+    printf("%-10s %-10s %-10s %18s %18s\n", "Threads", "Matches", "Matches", "REG_GLOBAL", "REG_PARALLEL");
+
+    for (i = 0; i < 4; i++)
+    {
+        RegEx regex_global = regex_compile("^.*ion.*$", REG_GLOBAL);
+        RegEx regex_parallel = regex_compile("^.*ion.*$", REG_GLOBAL | REG_PARALLEL);
+
+        NUM_THREADS = num_threads[i];
+
+        clock_gettime(CLOCK_MONOTONIC, &start_time);
+        regex_exec(text_string, regex_global);
+        time_global = elapsed_wall_milliseconds(&start_time);
+
+        clock_gettime(CLOCK_MONOTONIC, &start_time);
+        regex_exec(text_string, regex_parallel);
+        time_parallel = elapsed_wall_milliseconds(&start_time);
+
+        printf("%-10u %-10d %-10d %15.2f ms %15.2f ms\n", num_threads[i], regex_global->num_matches, regex_parallel->num_matches, time_global, time_parallel);
+
+        regex_close(regex_global);
+        regex_close(regex_parallel);
+    }
+
+    free(text_string);
+
+    /* the anchors of the text start and end are searched sequentially, they would match at each chunk bound */
+    text_string = malloc(400000 * 4 + 2);
+
+    for (i = 0; i < 400000; i++)
+    {
+        memcpy(text_string + i * 4, "abc\n", 4);
+    }
+    strcpy(text_string + 400000 * 4, "x");
+
+    printf("\nAnchors of the text bounds on 400000 lines \"abc\" and \"x\" with 4 threads:\n---------------------------------------------------------------------\n");
+    printf("%-10s %-22s %-22s\n", "Pattern", "REG_GLOBAL", "REG_PARALLEL");
+
+    NUM_THREADS = 4;
+
+    for (i = 0; i < 2; i++)
+    {
+        char* patterns[2] = { "c\\'", "\\'" };
+        RegEx regex_global = regex_compile(patterns[i], REG_GLOBAL);
+        RegEx regex_parallel = regex_compile(patterns[i], REG_GLOBAL | REG_PARALLEL);
+        char result_global[32] = "no match";
+        char result_parallel[32] = "no match";
+
+        if (regex_exec(text_string, regex_global) == REGEX_MATCH_SUCCESS)
+        {
+            sprintf(result_global, "%d at %d", regex_global->num_matches, regex_global->matches[0].start);
+        }
+        if (regex_exec(text_string, regex_parallel) == REGEX_MATCH_SUCCESS)
+        {
+            sprintf(result_parallel, "%d at %d", regex_parallel->num_matches, regex_parallel->matches[0].start);
+        }
+
+        printf("%-10s %-22s %-22s\n", patterns[i], result_global, result_parallel);
+
+        regex_close(regex_global);
+        regex_close(regex_parallel);
+    }
+
+    NUM_THREADS = 0;
+    free(text_string);
+}
+#endif
+
+/* example for comparing regex_exec_r() per record with regex_match_batch() on short records */
+void benchmark_match_batch()
+{
+    int num_threads[4] = { 1, 2, 4, 8 };
+    int num_records = 200000;
+    char* record_buffer = malloc(num_records * 48 * sizeof(char));
+    const char** records = malloc(num_records * sizeof(char*));
+    cregbatch_result_t* batch_results = malloc(num_records * sizeof(cregbatch_result_t));
+    char* write_ptr = record_buffer;
+    RegEx regex_data = regex_compile("^(\\d+),(\\w+),\\w*ion,", REG_DEFAULT);
+    cregresults_t results;
+    int i;
+    int num_results;
+    clock_t start_time;
+    double time_exec;
+    double time_batch;
+
+    /* CSV records, every 7th record has a name ending with "ion" */
+    for (i = 0; i < num_records; i++)
+    {
+        records[i] = write_ptr;
+        write_ptr += sprintf(write_ptr, "%d,user%d,%s,%d", i, i % 977, (i % 7 == 0) ? "station" : "stationary", i * 31 % 1000) + 1;
+    }
+
+    printf("\nMatching %d CSV records (\"^(\\d+),(\\w+),\\w*ion,\"):\n------------------------------------------------------\n", num_records);
+    printf("%-10s %-10s %18s %20s\n", "Threads", "Matches", "regex_exec_r()", "regex_match_batch()");
+
+    for (i = 0; i < 4; i++)
+    {
+        int j;
+
+        num_results = 0;
+        regex_results_init(&results);
+        start_time = clock();
+
+        for (j = 0; j < num_records; j++)
+        {
+            if (regex_exec_r((char*)records[j], regex_data, &results) == REGEX_MATCH_SUCCESS)
+            {
+                num_results++;
+            }
+        }
+
+        time_exec = elapsed_microseconds(start_time) / 1000.0;
+        regex_results_free(&results);
+
+#ifdef REGEX_PARALLEL_SEARCH
+        {
+            struct timespec wall_start_time;
+
+            clock_gettime(CLOCK_MONOTONIC, &wall_start_time);
+            num_results = regex_match_batch(regex_data, records, num_records, batch_results, num_threads[i]);
+            time_batch = elapsed_wall_milliseconds(&wall_start_time);
+        }
+#else
+        start_time = clock();
+        num_results = regex_match_batch(regex_data, records, num_records, batch_results, num_threads[i]);
+        time_batch = elapsed_microseconds(start_time) / 1000.0;
+#endif
+
+        printf("%-10d %-10d %15.2f ms %17.2f ms\n", num_threads[i], num_results, time_exec, time_batch);
+    }
+
+    regex_close(regex_data);
+    free(batch_results);
+    free(records);
+    free(record_buffer);
+}
+
+/* example for comparing freed and reused result memory of repeated regex_exec_r() calls */
+void benchmark_result_memory()
+{
+    int num_lines[3] = { 1000, 10000, 50000 };
+    int i;
+    int j;
+    clock_t start_time;
+    double time_free;
+    double time_reuse;
+    cregresults_t results;
+
+    printf("\nRepeated regex_exec_r() on a word list (\"^(\\w+)(ion)$\", 50 iterations):\n------------------------------------------------------------------------\n");
+    printf("%-10s %-10s %18s %18s\n", "Lines", "Results", "freed", "reused");
+
+    for (i = 0; i < 3; i++)
+    {
+        char* text_string = create_word_list(num_lines[i]);
+        RegEx regex_data = regex_compile("^(\\w+)(ion)$", REG_GLOBAL);
+
+        regex_results_init(&results);
+        start_time = clock();
+
+        for (j = 0; j < 50; j++)
+        {
+            regex_exec_r(text_string, regex_data, &results);
+            regex_results_free(&results);
+        }
+
+        time_free = elapsed_microseconds(start_time) / 50000.0;
+        start_time = clock();
+
+        for (j = 0; j < 50; j++)
+        {
+            regex_exec_r(text_string, regex_data, &results);
+        }
+
+        time_reuse = elapsed_microseconds(start_time) / 50000.0;
+
+        printf("%-10d %-10d %15.3f ms %15.3f ms\n", num_lines[i], results.num_matches, time_free, time_reuse);
+
+        regex_results_free(&results);
+        regex_close(regex_data);
+        free(text_string);
+    }
+}
+
+/* example for comparing a RegEx object per input with a reused RegEx object */
+void benchmark_regex_reuse()
+{
+    int num_texts = 100000;
+    char text_string[64];
+    int i;
+    int num_results_compile = 0;
+    int num_results_reuse = 0;
+    clock_t start_time;
+    double time_compile;
+    double time_reuse;
+    RegEx regex_data;
+
+    printf("\nregex_exec() on %d short texts (\"(\\w+)=(\\d+)\", REG_GLOBAL):\n-----------------------------------------------------------\n", num_texts);
+
+    start_time = clock();
+
+    /* compile, execute and close for each text */
+    for (i = 0; i < num_texts; i++)
+    {
+        sprintf(text_string, "id=%d user=%d session=%d", i, i % 1000, i % 77);
+        regex_data = regex_compile("(\\w+)=(\\d+)", REG_GLOBAL);
+        regex_exec(text_string, regex_data);
+        num_results_compile += regex_data->num_matches;
+        regex_close(regex_data);
+    }
+
+    time_compile = elapsed_microseconds(start_time) / 1000.0;
+    start_time = clock();
+
+    /* one RegEx object for all texts, the memory of the matches is reused */
+    regex_data = regex_compile("(\\w+)=(\\d+)", REG_GLOBAL);
+
+    for (i = 0; i < num_texts; i++)
+    {
+        sprintf(text_string, "id=%d user=%d session=%d", i, i % 1000, i % 77);
+        regex_exec(text_string, regex_data);
+        num_results_reuse += regex_data->num_matches;
+    }
+
+    regex_close(regex_data);
+    time_reuse = elapsed_microseconds(start_time) / 1000.0;
+
+    printf("%-28s %10d results %12.3f ms\n", "compile/exec/close per text", num_results_compile, time_compile);
+    printf("%-28s %10d results %12.3f ms\n", "reused RegEx object", num_results_reuse, time_reuse);
+}
+
+/* example for comparing the copied input text with the borrowed input text of REG_NOCOPY */
+void benchmark_borrowed_input()
+{
+    int option_flags[2] = { REG_GLOBAL | REG_NEWLINE, REG_GLOBAL | REG_NEWLINE | REG_NOCOPY };
+    char* flag_names[2] = { "copied input", "REG_NOCOPY" };
+    char* text_string = create_word_list(2000000);
+    int text_length = (int)strlen(text_string);
+    int i;
+    int j;
+    clock_t start_time;
+    double time_exec;
+
+    printf("\nregex_exec_buffer() on a word list of %d bytes (\"^\\w+ion$\", 10 iterations):\n------------------------------------------------------------------------------\n", text_length);
+    printf("%-14s %-10s %18s %16s\n", "Input", "Results", "time", "text buffer");
+
+    for (i = 0; i < 2; i++)
+    {
+        RegEx regex_data = regex_compile("^\\w+ion$", option_flags[i]);
+
+        start_time = clock();
+
+        for (j = 0; j < 10; j++)
+        {
+            regex_exec_buffer(text_string, text_length, regex_data);
+        }
+
+        time_exec = elapsed_microseconds(start_time) / 10000.0;
+
+        printf("%-14s %-10d %15.3f ms %10d bytes\n", flag_names[i], regex_data->num_matches, time_exec, regex_data->text_capacity);
+
+        regex_close(regex_data);
+    }
+
+    free(text_string);
+}
+
+#ifdef REGEX_FILE_MAPPING
+/* example for comparing regex_readfile() with the memory mapping of regex_mapfile() */
+void benchmark_file_mapping()
+{
+    char* file_name = "compact-regex_benchmark.tmp";
+    char* text_string = create_word_list(4000000);
+    FILE* file_ptr = fopen(file_name, "wb");
+    unsigned int max_text_length = MAX_TEXT_LENGTH;
+    int i;
+    clock_t start_time;
+    double time_read;
+    double time_map;
+    RegExFile regex_file;
+    RegEx regex_data;
+
+    if (file_ptr == NULL)
+    {
+        printf("Could not write %s.\n", file_name);
+        free(text_string);
+        return;
+    }
+
+    fwrite(text_string, strlen(text_string), 1, file_ptr);
+    fclose(file_ptr);
+
+    printf("\nReading and searching a file of %d bytes (\"^\\w+ion$\", 10 iterations):\n----------------------------------------------------------------------\n", (int)strlen(text_string));
+
+    MAX_TEXT_LENGTH = 104857600;
+    start_time = clock();
+
+    /* read the file into a buffer, the RegEx object copies the text */
+    for (i = 0; i < 10; i++)
+    {
+        regex_file = regex_readfile(file_name);
+        regex_data = regex_compile("^\\w+ion$", REG_GLOBAL | REG_NEWLINE);
+        regex_exec_buffer(regex_file->content, regex_file->length, regex_data);
+        regex_close(regex_data);
+        regex_closefile(regex_file);
+    }
+
+    time_read = elapsed_microseconds(start_time) / 10000.0;
+    start_time = clock();
+
+    /* map the file into memory and search it without a copy */
+    for (i = 0; i < 10; i++)
+    {
+        regex_file = regex_mapfile(file_name);
+        regex_data = regex_compile("^\\w+ion$", REG_GLOBAL | REG_NEWLINE | REG_NOCOPY);
+        regex_exec_buffer(regex_file->content, regex_file->length, regex_data);
+        regex_close(regex_data);
+        regex_closefile(regex_file);
+    }
+
+    time_map = elapsed_microseconds(start_time) / 10000.0;
+
+    printf("%-32s %12.3f ms\n", "regex_readfile() + copy", time_read);
+    printf("%-32s %12.3f ms\n", "regex_mapfile() + REG_NOCOPY", time_map);
+
+    MAX_TEXT_LENGTH = max_text_length;
+    remove(file_name);
+    free(text_string);
+}
+#endif
+
+/* callback for benchmark_stream(): counts the matches */
+int count_stream_match(int number_match, int number_submatch, long start, long end, char* match_text, void* userdata)
+{
+    *(int*)userdata += 1;
+
+    return 0;
+}
+
+/* example for comparing regex_readfile() with the chunks of regex_foreach_stream() */
+void benchmark_stream()
+{
+    char* file_name = "compact-regex_benchmark.tmp";
+    char* text_string = create_word_list(4000000);
+    FILE* file_ptr = fopen(file_name, "wb");
+    unsigned int max_text_length = MAX_TEXT_LENGTH;
+    int num_results_read = 0;
+    int num_results_stream = 0;
+    int buffer_size;
+    clock_t start_time;
+    double time_read;
+    double time_stream;
+    RegExFile regex_file;
+    RegExStream regex_stream;
+    RegEx regex_data = regex_compile("^\\w+ion$", REG_GLOBAL | REG_NEWLINE);
+
+    if (file_ptr == NULL)
+    {
+        printf("Could not write %s.\n", file_name);
+        regex_close(regex_data);
+        free(text_string);
+        return;
+    }
+
+    fwrite(text_string, strlen(text_string), 1, file_ptr);
+    fclose(file_ptr);
+
+    printf("\nSearching a file of %d bytes (\"^\\w+ion$\"):\n-------------------------------------------------\n", (int)strlen(text_string));
+    printf("%-28s %-10s %15s %16s\n", "Input", "Results", "time", "buffer");
+
+    /* read the whole file into a buffer */
+    MAX_TEXT_LENGTH = 104857600;
+    start_time = clock();
+    regex_file = regex_readfile(file_name);
+    regex_foreach(regex_file->content, regex_data, count_match, &num_results_read);
+    time_read = elapsed_microseconds(start_time) / 1000.0;
+    printf("%-28s %-10d %12.3f ms %10d bytes\n", "regex_readfile()", num_results_read, time_read, regex_file->length + 1);
+    regex_closefile(regex_file);
+    MAX_TEXT_LENGTH = max_text_length;
+
+    /* read the file in chunks */
+    start_time = clock();
+    regex_stream = regex_openstream(file_name);
+    regex_foreach_stream(regex_stream, regex_data, count_stream_match, &num_results_stream);
+    buffer_size = regex_stream->buffer_size;
+    regex_closestream(regex_stream);
+    time_stream = elapsed_microseconds(start_time) / 1000.0;
+    printf("%-28s %-10d %12.3f ms %10d bytes\n", "regex_foreach_stream()", num_results_stream, time_stream, buffer_size);
+
+    regex_close(regex_data);
+    remove(file_name);
+    free(text_string);
+}
+
+#if defined(REGEX_TREE_SEARCH) && defined(REGEX_PARALLEL_SEARCH)
+/* callback for benchmark_search_tree(): counts the files with matches */
+int count_tree_file(char* file_name, cregtree_match_t* matches, int num_matches, void* userdata)
+{
+    *(int*)userdata += 1;
+
+    return 0;
+}
+
+/* example for comparing the threads of regex_search_tree() on a directory of log files */
+void benchmark_search_tree()
+{
+    unsigned int num_threads[4] = { 1, 2, 4, 8 };
+    char* directory_name = "compact-regex_benchmark.dir";
+    char* text_string = create_word_list(200000);
+    char file_name[64];
+    int num_files = 64;
+    int num_results_files;
+    long num_results;
+    int i;
+    struct timespec start_time;
+    double time_search;
+    FILE* file_ptr;
+    RegEx regex_data = regex_compile("^\\w+ion$", REG_GLOBAL | REG_NEWLINE);
+
+    mkdir(directory_name, 0755);
+
+    for (i = 0; i < num_files; i++)
+    {
+        sprintf(file_name, "%s/file-%d.log", directory_name, i);
+
+        if ((file_ptr = fopen(file_name, "wb")) != NULL)
+        {
+            fwrite(text_string, strlen(text_string), 1, file_ptr);
+            fclose(file_ptr);
+        }
+    }
+
+    printf("\nregex_search_tree() on %d files of %d bytes (\"^\\w+ion$\"):\n-------------------------------------------------------------\n", num_files, (int)strlen(text_string));
+    printf("%-10s %-10s %-10s %15s\n", "Threads", "Files", "Results", "wall time");
+
+    for (i = 0; i < 4; i++)
+    {
+        NUM_THREADS = num_threads[i];
+        num_results_files = 0;
+
+        clock_gettime(CLOCK_MONOTONIC, &start_time);
+        num_results = regex_search_tree(directory_name, regex_data, REGEX_TREE_DEFAULT, count_tree_file, &num_results_files);
+        time_search = elapsed_wall_milliseconds(&start_time);
+
+        printf("%-10u %-10d %-10ld %12.3f ms\n", num_threads[i], num_results_files, num_results, time_search);
+    }
+
+    NUM_THREADS = 0;
+
+    for (i = 0; i < num_files; i++)
+    {
+        sprintf(file_name, "%s/file-%d.log", directory_name, i);
+        remove(file_name);
+    }
+
+    rmdir(directory_name);
+    regex_close(regex_data);
+    free(text_string);
+}
+#endif
+
+/* example for measuring regex_writefile() with an increasing number of results */
+void benchmark_print_output()
+{
+    int num_lines[3] = { 1000, 4000, 15000 };
+    int print_layouts[4] = { REGEX_PRINT_PLAIN, REGEX_PRINT_CSV, REGEX_PRINT_TABLE, REGEX_PRINT_JSON };
+    char* layout_names[4] = { "REGEX_PRINT_PLAIN", "REGEX_PRINT_CSV", "REGEX_PRINT_TABLE", "REGEX_PRINT_JSON" };
+    char* file_name = "compact-regex_benchmark.tmp";
+    unsigned int max_num_matches = MAX_NUM_MATCHES;
+    double time_write[3][4];
+    int num_results[3];
+    int i;
+    int j;
+    clock_t start_time;
+
+    MAX_NUM_MATCHES = 16000;
+
+    for (i = 0; i < 3; i++)
+    {
+        char* text_string = create_word_list(num_lines[i]);
+        RegEx regex_data = regex_compile("^\\w+$", REG_GLOBAL | REG_NEWLINE);
+
+        regex_exec(text_string, regex_data);
+        num_results[i] = regex_data->num_matches;
+
+        for (j = 0; j < 4; j++)
+        {
+            start_time = clock();
+            regex_writefile(regex_data, print_layouts[j] | REGEX_PRINT_NOTEXT, file_name);
+            time_write[i][j] = elapsed_microseconds(start_time) / 1000.0;
+        }
+
+        regex_close(regex_data);
+        free(text_string);
+    }
+
+    remove(file_name);
+    MAX_NUM_MATCHES = max_num_matches;
+
+    printf("\nregex_writefile() of the results of \"^\\w+$\" on a word list:\n--------------------------------------------------------------\n");
+    printf("%-20s %12d %12d %12d results\n", "Layout", num_results[0], num_results[1], num_results[2]);
+
+    for (j = 0; j < 4; j++)
+    {
+        printf("%-20s %9.2f ms %9.2f ms %9.2f ms\n", layout_names[j], time_write[0][j], time_write[1][j], time_write[2][j]);
+    }
+}
+
+/* example for comparing regex_writefile() with the written matches of regex_export() */
+void benchmark_export()
+{
+    int print_layouts[3] = { REGEX_PRINT_CSV, REGEX_PRINT_NDJSON, REGEX_PRINT_BINARY };
+    char* layout_names[3] = { "regex_export() REGEX_PRINT_CSV", "regex_export() REGEX_PRINT_NDJSON", "regex_export() REGEX_PRINT_BINARY" };
+    char* file_name = "compact-regex_benchmark.tmp";
+    char* text_string = create_word_list(200000);
+    long num_results;
+    long file_size;
+    int i;
+    clock_t start_time;
+    double time_write;
+    FILE* file_ptr;
+    RegEx regex_data = regex_compile("^(\\w+)$", REG_GLOBAL | REG_NEWLINE);
+
+    start_time = clock();
+    regex_exec(text_string, regex_data);
+    regex_writefile(regex_data, REGEX_PRINT_CSV | REGEX_PRINT_NOTEXT | REGEX_PRINT_NOSTATS, file_name);
+    time_write = elapsed_microseconds(start_time) / 1000.0;
+    num_results = regex_data->num_matches;
+
+    printf("\nExport of the results on a word list of %d bytes (\"^(\\w+)$\"):\n----------------------------------------------------------------\n", (int)strlen(text_string));
+    printf("%-36s %-10s %15s %12s\n", "Function", "Results", "time", "file size");
+
+    if ((file_ptr = fopen(file_name, "rb")) != NULL)
+    {
+        fseek(file_ptr, 0, SEEK_END);
+        file_size = ftell(file_ptr);
+        fclose(file_ptr);
+        printf("%-36s %-10ld %12.3f ms %9ld KB\n", "regex_exec() and regex_writefile()", num_results, time_write, file_size / 1024);
+    }
+
+    for (i = 0; i < 3; i++)
+    {
+        regex_close(regex_data);
+        regex_data = regex_compile("^(\\w+)$", REG_GLOBAL | REG_NEWLINE);
+
+        if ((file_ptr = fopen(file_name, "wb")) != NULL)
+        {
+            start_time = clock();
+            num_results = regex_export(text_string, regex_data, print_layouts[i], file_ptr);
+            time_write = elapsed_microseconds(start_time) / 1000.0;
+            file_size = ftell(file_ptr);
+            fclose(file_ptr);
+            printf("%-36s %-10ld %12.3f ms %9ld KB\n", layout_names[i], num_results, time_write, file_size / 1024);
+        }
+    }
+
+    remove(file_name);
+    regex_close(regex_data);
+    free(text_string);
+}
+
+/* example for comparing regexec() with the Pike VM of REG_PIKEVM */
+void benchmark_pike_vm()
+{
+    int engine_flags[2] = { REG_DEFAULT, REG_PIKEVM };
+    char* engine_names[2] = { "regexec()", "REG_PIKEVM" };
+    int text_lengths[4] = { 1000, 2000, 4000, 8000 };
+    char* text_string = create_word_list(200000);
+    char* pathological_string;
+    int i;
+    int j;
+    clock_t start_time;
+    double time_exec;
+
+    printf("\nGlobal search on a word list of %d bytes (\"^(\\w+)(ion)?$\"):\n-------------------------------------------------------------\n", (int)strlen(text_string));
+    printf("%-12s %-10s %18s\n", "Engine", "Matches", "regex_exec()");
+
+    for (i = 0; i < 2; i++)
+    {
+        RegEx regex_data = regex_compile("^(\\w+)(ion)?$", REG_GLOBAL | REG_NEWLINE | engine_flags[i]);
+
+        start_time = clock();
+        regex_exec(text_string, regex_data);
+        time_exec = elapsed_microseconds(start_time) / 1000.0;
+
+        printf("%-12s %-10d %15.2f ms\n", engine_names[i], regex_data->num_matches, time_exec);
+
+        regex_close(regex_data);
+    }
+
+    free(text_string);
+
+    printf("\nNested repetitions \"(x+x+)+y\" on a text of x characters without a match:\n------------------------------------------------------------------------\n");
+    printf("%-12s %15d %15d %15d %15d bytes\n", "Engine", text_lengths[0], text_lengths[1], text_lengths[2], text_lengths[3]);
+
+    for (i = 0; i < 2; i++)
+    {
+        RegEx regex_data = regex_compile("(x+x+)+y", REG_EXTENDED | engine_flags[i]);
+
+        printf("%-12s", engine_names[i]);
+
+        for (j = 0; j < 4; j++)
+        {
+            pathological_string = malloc((text_lengths[j] + 1) * sizeof(char));
+            memset(pathological_string, 'x', text_lengths[j]);
+            pathological_string[text_lengths[j]] = '\0';
+
+            start_time = clock();
+            regex_exec(pathological_string, regex_data);
+            time_exec = elapsed_microseconds(start_time) / 1000.0;
+
+            printf(" %12.2f ms", time_exec);
+
+            free(pathological_string);
+        }
+
+        printf("\n");
+        regex_close(regex_data);
+    }
+}
+
+/* example for comparing the match-only functions with and without the lazy DFA of REG_LAZYDFA */
+void benchmark_lazy_dfa()
+{
+    int engine_flags[2] = { REG_DEFAULT, REG_LAZYDFA };
+    char* engine_names[2] = { "regexec()", "REG_LAZYDFA" };
+    char* text_string = create_word_list(1000000);
+    double text_megabytes = (double)strlen(text_string) / (1024.0 * 1024.0);
+    int result[3];
+    int i;
+    clock_t start_time;
+    double time_exec[3];
+    RegEx regex_data;
+
+    printf("\nMatch-only functions on a word list of %.1f MB:\n------------------------------------------------\n", text_megabytes);
+    printf("%-12s %33s %33s %33s\n", "Engine", "regex_test() no match", "regex_count() ^(ka|lo)\\w*ion$", "REG_NOSUBEXP ^(ka|lo)\\w*ion$");
+
+    for (i = 0; i < 2; i++)
+    {
+        start_time = clock();
+        result[0] = regex_test(text_string, "(ka|lo)(mer|sti)vox[0-9]", REG_EXTENDED | engine_flags[i]);
+        time_exec[0] = elapsed_microseconds(start_time) / 1000.0;
+
+        start_time = clock();
+        result[1] = regex_count(text_string, "^(ka|lo)\\w*ion$", REG_GLOBAL | REG_NEWLINE | engine_flags[i]);
+        time_exec[1] = elapsed_microseconds(start_time) / 1000.0;
+
+        regex_data = regex_compile("^(ka|lo)\\w*ion$", REG_GLOBAL | REG_NEWLINE | REG_NOSUBEXP | engine_flags[i]);
+
+        start_time = clock();
+        regex_exec(text_string, regex_data);
+        time_exec[2] = elapsed_microseconds(start_time) / 1000.0;
+        result[2] = regex_data->num_matches;
+
+        regex_close(regex_data);
+
+        printf("%-12s %7d %9.2f ms %5.0f MB/s %7d %9.2f ms %5.0f MB/s %7d %9.2f ms %5.0f MB/s\n", engine_names[i],
+            result[0], time_exec[0], text_megabytes * 1000.0 / time_exec[0],
+            result[1], time_exec[1], text_megabytes * 1000.0 / time_exec[1],
+            result[2], time_exec[2], text_megabytes * 1000.0 / time_exec[2]);
+    }
+
+    free(text_string);
+}
+
+/* example for comparing the match start of the reverse DFA with and without the sub-expressions of the exact search */
+void benchmark_reverse_dfa()
+{
+    int engine_flags[2] = { REG_DEFAULT, REG_LAZYDFA };
+    char* engine_names[2] = { "regexec()", "REG_LAZYDFA" };
+    int subexp_flags[2] = { REG_DEFAULT, REG_NOSUBEXP };
+    char* text_string = create_word_list(400000);
+    double time_exec;
+    int i;
+    int j;
+    clock_t start_time;
+    RegEx regex_data;
+
+    /* lines of 64 words with two words ending with "ion" */
+    for (i = 0, j = 0; text_string[i] != '\0'; i++)
+    {
+        if (text_string[i] == '\n' && ++j % 64 != 0)
+        {
+            text_string[i] = ' ';
+        }
+    }
+
+    printf("\nGlobal search of \"(\\w+)ion\\>\" in lines of 64 words, %d bytes:\n-----------------------------------------------------------------\n", (int)strlen(text_string));
+    printf("%-12s %-10s %18s %18s\n", "Engine", "Matches", "groups", "REG_NOSUBEXP");
+
+    for (i = 0; i < 2; i++)
+    {
+        printf("%-12s", engine_names[i]);
+
+        for (j = 0; j < 2; j++)
+        {
+            regex_data = regex_compile("(\\w+)ion\\>", REG_GLOBAL | REG_NEWLINE | engine_flags[i] | subexp_flags[j]);
+
+            start_time = clock();
+            regex_exec(text_string, regex_data);
+            time_exec = elapsed_microseconds(start_time) / 1000.0;
+
+            if (j == 0)
+            {
+                printf(" %-10d", regex_data->num_matches);
+            }
+
+            printf(" %15.2f ms", time_exec);
+
+            regex_close(regex_data);
+        }
+
+        printf("\n");
+    }
+
+    free(text_string);
+}
+
+/* example for comparing the lazy DFA of REG_LAZYDFA with regexec() on many short records */
+void benchmark_short_records()
+{
+    int engine_flags[2] = { REG_DEFAULT, REG_LAZYDFA };
+    char* engine_names[2] = { "regexec()", "REG_LAZYDFA" };
+    char* pattern = "(GET|POST) /(\\w+)\\.html HTTP/1\\.[01] 404";
+    int num_records = 200000;
+    char* record_buffer = malloc(num_records * 64 * sizeof(char));
+    char** records = malloc(num_records * sizeof(char*));
+    char* write_ptr = record_buffer;
+    cregresults_t results;
+    RegEx regex_data;
+    int num_results[3];
+    double time_exec[3];
+    clock_t start_time;
+    int i;
+    int j;
+
+    /* HTTP log lines of about 56 bytes, every 9th request is not found */
+    for (i = 0; i < num_records; i++)
+    {
+        records[i] = write_ptr;
+        write_ptr += sprintf(write_ptr, "10.0.%d.%d - %s /page%d.html HTTP/1.1 %d %d \"curl/7.%d\"", i % 256, i * 7 % 256,
+            (i % 3 == 0) ? "POST" : "GET", i % 1000, (i % 9 == 0) ? 404 : 200, 1000 + i % 9000, i % 90) + 1;
+    }
+
+    printf("\nShort records, %d HTTP log lines of about %d bytes (\"%s\"):\n", num_records, (int)strlen(records[1]), pattern);
+    printf("--------------------------------------------------------------------------------------------\n");
+    printf("%-12s %28s %28s %28s\n", "Engine", "regex_exec_r() REG_NOSUBEXP", "regex_exec() with groups", "regex_test()");
+
+    for (i = 0; i < 2; i++)
+    {
+        /* one RegEx object and one result object for all records */
+        regex_data = regex_compile(pattern, REG_NOSUBEXP | engine_flags[i]);
+        regex_results_init(&results);
+        num_results[0] = 0;
+        start_time = clock();
+
+        for (j = 0; j < num_records; j++)
+        {
+            num_results[0] += (regex_exec_r(records[j], regex_data, &results) == REGEX_MATCH_SUCCESS);
+        }
+
+        time_exec[0] = elapsed_microseconds(start_time) / 1000.0;
+        regex_results_free(&results);
+        regex_close(regex_data);
+
+        regex_data = regex_compile(pattern, engine_flags[i]);
+        num_results[1] = 0;
+        start_time = clock();
+
+        for (j = 0; j < num_records; j++)
+        {
+            num_results[1] += (regex_exec(records[j], regex_data) == REGEX_MATCH_SUCCESS);
+        }
+
+        time_exec[1] = elapsed_microseconds(start_time) / 1000.0;
+        regex_close(regex_data);
+
+        /* regex_test() compiles the pattern once and takes it from the compiled-pattern cache */
+        num_results[2] = 0;
+        start_time = clock();
+
+        for (j = 0; j < num_records; j++)
+        {
+            num_results[2] += regex_test(records[j], pattern, engine_flags[i]);
+        }
+
+        time_exec[2] = elapsed_microseconds(start_time) / 1000.0;
+
+        printf("%-12s %10d %14.2f ms %10d %14.2f ms %10d %14.2f ms\n", engine_names[i],
+            num_results[0], time_exec[0], num_results[1], time_exec[1], num_results[2], time_exec[2]);
+    }
+
+    free(records);
+    free(record_buffer);
+}
+
+/* micro-benchmarks of the library functions */
+int main(int argc, char* argv[])
+{
+    int selection_number = argc > 1 ? atoi(argv[1]) : -1;
+
+    if (argc == 1)
+    {
+        printf(" [1] benchmark_compile_latency()\n\
+ [2] benchmark_pattern_cache()\n\
+ [3] benchmark_global_search()\n\
+ [4] benchmark_match_slots()\n\
+ [5] benchmark_foreach()\n\
+ [6] benchmark_test_count()\n\
+ [7] benchmark_parallel_search()\n\
+ [8] benchmark_match_batch()\n\
+ [9] benchmark_result_memory()\n\
+ [10] benchmark_regex_reuse()\n\
+ [11] benchmark_borrowed_input()\n\
+ [12] benchmark_file_mapping()\n\
+ [13] benchmark_stream()\n\
+ [14] benchmark_search_tree()\n\
+ [15] benchmark_print_output()\n\
+ [16] benchmark_export()\n\
+ [17] benchmark_pike_vm()\n\
+ [18] benchmark_lazy_dfa()\n\
+ [19] benchmark_reverse_dfa()\n\
+ [20] benchmark_short_records()\n\n\
+ [0] exit\n\
+\n\
+Select a benchmark function by the number: ");
+
+        if (scanf("%d", &selection_number) != 1)
+        {
+            selection_number = -1;
+        }
+    }
+
+    switch (selection_number)
+    {
+        case 1:
+        {
+            benchmark_compile_latency();
+            break;
+        }
+        case 2:
+        {
+            benchmark_pattern_cache();
+            break;
+        }
+        case 3:
+        {
+            benchmark_global_search();
+            break;
+        }
+        case 4:
+        {
+            benchmark_match_slots();
+            break;
+        }
+        case 5:
+        {
+            benchmark_foreach();
+            break;
+        }
+        case 6:
+        {
+            benchmark_test_count();
+            break;
+        }
+        case 7:
+        {
+#ifdef REGEX_PARALLEL_SEARCH
+            benchmark_parallel_search();
+#else
+            printf("REG_PARALLEL needs -pthread.\n");
+#endif
+            break;
+        }
+        case 8:
+        {
+            benchmark_match_batch();
+            break;
+        }
+        case 9:
+        {
+            benchmark_result_memory();
+            break;
+        }
+        case 10:
+        {
+            benchmark_regex_reuse();
+            break;
+        }
+        case 11:
+        {
+            benchmark_borrowed_input();
+            break;
+        }
+        case 12:
+        {
+#ifdef REGEX_FILE_MAPPING
+            benchmark_file_mapping();
+#else
+            printf("regex_mapfile() needs mmap() and REG_STARTEND.\n");
+#endif
+            break;
+        }
+        case 13:
+        {
+            benchmark_stream();
+            break;
+        }
+        case 14:
+        {
+#if defined(REGEX_TREE_SEARCH) && defined(REGEX_PARALLEL_SEARCH)
+            benchmark_search_tree();
+#else
+            printf("regex_search_tree() with threads needs -pthread and the POSIX directory functions.\n");
+#endif
+            break;
+        }
+        case 15:
+        {
+            benchmark_print_output();
+            break;
+        }
+        case 16:
+        {
+            benchmark_export();
+            break;
+        }
+        case 17:
+        {
+            benchmark_pike_vm();
+            break;
+        }
+        case 18:
+        {
+            benchmark_lazy_dfa();
+            break;
+        }
+        case 19:
+        {
+            benchmark_reverse_dfa();
+            break;
+        }
+        case 20:
+        {
+            benchmark_short_records();
+            break;
+        }
+        case 0:
+        {
+            exit(EXIT_SUCCESS);
+            break;
+        }
+        default:
+        {
+            break;
+        }
+    }
+
+    return 0;
+}
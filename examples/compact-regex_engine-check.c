@@ -0,0 +1,312 @@
+#include "compact-regex.h"
+#include <signal.h>
+
+/* Differential check of the matching engines: random extended regular expressions over a small
+   alphabet are searched with regexec() and with the engines of REG_PIKEVM and REG_LAZYDFA,
+   and the spans of the whole matches are compared. */
+
+#define CHECK_MAX_PATTERN_LENGTH 64
+#define CHECK_MAX_TEXT_LENGTH 24
+#define CHECK_NUM_ENGINES 3
+#define CHECK_TIMEOUT_SECONDS 10
+
+/* option flags of the compared engines, the results of regexec() are the reference */
+int CHECK_ENGINE_FLAGS[CHECK_NUM_ENGINES] = { REG_PIKEVM, REG_LAZYDFA, REG_LAZYDFA | REG_NOSUBEXP };
+char* CHECK_ENGINE_NAMES[CHECK_NUM_ENGINES] = { "REG_PIKEVM", "REG_LAZYDFA", "REG_LAZYDFA | REG_NOSUBEXP" };
+
+/* the pattern and text of the running search, printed if a search does not return */
+char* CHECK_PATTERN = "";
+char* CHECK_TEXT = "";
+int CHECK_NEWLINE = 0;
+
+/* random number below a limit */
+int random_below(int limit)
+{
+    return rand() % limit;
+}
+
+/* appends a random atom or group to a pattern, the anchors ^ and $ only with check_anchors */
+void append_random_atom(char* pattern, int depth, int check_anchors)
+{
+    char* atoms[8] = { "a", "b", "c", ".", "[ab]", "[^a]", "^", "$" };
+    int num_atoms = check_anchors ? 8 : 6;
+
+    if (depth < 3 && random_below(4) == 0)
+    {
+        int num_alternatives = 1 + random_below(2);
+        int i;
+
+        strcat(pattern, "(");
+
+        for (i = 0; i < num_alternatives; i++)
+        {
+            int num_atoms_in_sequence = 1 + random_below(3);
+            int j;
+
+            if (i > 0)
+            {
+                strcat(pattern, "|");
+            }
+
+            for (j = 0; j < num_atoms_in_sequence; j++)
+            {
+                append_random_atom(pattern, depth + 1, check_anchors);
+            }
+        }
+
+        strcat(pattern, ")");
+    }
+    else
+    {
+        strcat(pattern, atoms[random_below(num_atoms)]);
+    }
+
+    /* the anchors are not repeated, a repetition of an anchor is not an extended regular expression */
+    if (pattern[strlen(pattern) - 1] != '^' && pattern[strlen(pattern) - 1] != '$')
+    {
+        char* repetitions[6] = { "*", "+", "?", "{1,2}", "{2}", "{0,2}" };
+
+        if (random_below(3) == 0)
+        {
+            strcat(pattern, repetitions[random_below(6)]);
+        }
+    }
+}
+
+/* creates a random pattern of one to four atoms, or two alternatives */
+void create_random_pattern(char* pattern, int check_anchors)
+{
+    int num_atoms = 1 + random_below(4);
+    int i;
+
+    strcpy(pattern, "");
+
+    for (i = 0; i < num_atoms && strlen(pattern) < CHECK_MAX_PATTERN_LENGTH / 2; i++)
+    {
+        append_random_atom(pattern, 0, check_anchors);
+    }
+
+    if (random_below(5) == 0 && strlen(pattern) < CHECK_MAX_PATTERN_LENGTH / 2)
+    {
+        strcat(pattern, "|");
+        append_random_atom(pattern, 0, check_anchors);
+    }
+}
+
+/* creates a random text of the alphabet with some newline characters, an empty text is not searched */
+void create_random_text(char* text)
+{
+    char alphabet[5] = { 'a', 'b', 'c', 'a', '\n' };
+    int length = 1 + random_below(CHECK_MAX_TEXT_LENGTH);
+    int i;
+
+    for (i = 0; i < length; i++)
+    {
+        text[i] = alphabet[random_below(5)];
+    }
+
+    text[length] = '\0';
+}
+
+/* prints a text with escaped newline characters */
+void print_escaped(char* text)
+{
+    for (; *text != '\0'; text++)
+    {
+        if (*text == '\n')
+        {
+            printf("\\n");
+        }
+        else
+        {
+            putchar(*text);
+        }
+    }
+}
+
+#if defined(__unix__)
+/* ends the check if a search does not return, regexec() of the GNU C library loops for some anchors in repetitions */
+void stop_search(int signal_number)
+{
+    printf("/%s/%s on \"", CHECK_PATTERN, CHECK_NEWLINE ? " REG_NEWLINE" : "");
+    print_escaped(CHECK_TEXT);
+    printf("\":\n  no result after %d seconds (signal %d), the check is stopped\n", CHECK_TIMEOUT_SECONDS, signal_number);
+    fflush(stdout);
+    _exit(2);
+}
+#endif
+
+/* returns 1 if an entry is a whole match, it is the first entry of its match number */
+int is_whole_match(RegEx regex_data, int index)
+{
+    return (index == 0 || regex_data->matches[index].number_match != regex_data->matches[index - 1].number_match);
+}
+
+/* compares the whole matches of two executed RegEx objects, returns 1 if the spans are the same */
+int compare_whole_matches(RegEx reference, RegEx engine)
+{
+    int i = 0;
+    int j = 0;
+
+    if (reference->return_code != engine->return_code)
+    {
+        return 0;
+    }
+
+    if (reference->return_code != REGEX_MATCH_SUCCESS)
+    {
+        return 1;
+    }
+
+    /* the sub-expressions of an ambiguous match may differ, the whole matches are compared */
+    while (1)
+    {
+        while (i < reference->num_matches && !is_whole_match(reference, i))
+        {
+            i++;
+        }
+        while (j < engine->num_matches && !is_whole_match(engine, j))
+        {
+            j++;
+        }
+
+        if (i == reference->num_matches || j == engine->num_matches)
+        {
+            return (i == reference->num_matches && j == engine->num_matches);
+        }
+
+        if (reference->matches[i].start != engine->matches[j].start ||
+            reference->matches[i].end != engine->matches[j].end)
+        {
+            return 0;
+        }
+
+        i++;
+        j++;
+    }
+}
+
+/* prints the whole matches of an executed RegEx object */
+void print_whole_matches(RegEx regex_data)
+{
+    int i;
+
+    for (i = 0; regex_data->return_code == REGEX_MATCH_SUCCESS && i < regex_data->num_matches; i++)
+    {
+        if (is_whole_match(regex_data, i))
+        {
+            printf(" [%d,%d)", regex_data->matches[i].start, regex_data->matches[i].end);
+        }
+    }
+
+    printf("\n");
+}
+
+/* searches random patterns and texts with all engines, returns the number of differences */
+int check_engines(int num_patterns, int check_anchors)
+{
+    char pattern[CHECK_MAX_PATTERN_LENGTH * 4];
+    char text[CHECK_MAX_TEXT_LENGTH + 1];
+    int option_flags[2] = { REG_GLOBAL | REG_EXTENDED, REG_GLOBAL | REG_EXTENDED | REG_NEWLINE };
+    int num_searches = 0;
+    int num_differences = 0;
+    int i, j, k, n;
+
+    for (i = 0; i < num_patterns; i++)
+    {
+        create_random_pattern(pattern, check_anchors);
+
+        for (j = 0; j < 2; j++)
+        {
+            RegEx reference = regex_compile(pattern, option_flags[j]);
+            RegEx engines[CHECK_NUM_ENGINES];
+
+            if (reference == NULL || reference->return_code != REGEX_COMP_SUCCESS)
+            {
+                regex_close(reference);
+                continue;
+            }
+
+            for (k = 0; k < CHECK_NUM_ENGINES; k++)
+            {
+                engines[k] = regex_compile(pattern, option_flags[j] | CHECK_ENGINE_FLAGS[k]);
+            }
+
+            for (n = 0; n < 8; n++)
+            {
+                create_random_text(text);
+#if defined(__unix__)
+                CHECK_PATTERN = pattern;
+                CHECK_TEXT = text;
+                CHECK_NEWLINE = j;
+                alarm(CHECK_TIMEOUT_SECONDS);
+#endif
+                regex_exec(text, reference);
+
+                for (k = 0; k < CHECK_NUM_ENGINES; k++)
+                {
+                    regex_exec(text, engines[k]);
+                    num_searches++;
+
+                    if (!compare_whole_matches(reference, engines[k]))
+                    {
+                        num_differences++;
+
+                        printf("/%s/%s on \"", pattern, j == 1 ? " REG_NEWLINE" : "");
+                        print_escaped(text);
+                        printf("\":\n  regexec():%*s", (int)strlen(CHECK_ENGINE_NAMES[k]) - 8, "");
+                        print_whole_matches(reference);
+                        printf("  %s:", CHECK_ENGINE_NAMES[k]);
+                        print_whole_matches(engines[k]);
+                    }
+                }
+#if defined(__unix__)
+                alarm(0);
+#endif
+            }
+
+            for (k = 0; k < CHECK_NUM_ENGINES; k++)
+            {
+                regex_close(engines[k]);
+            }
+
+            regex_close(reference);
+        }
+    }
+
+    printf("\n%d patterns, %d searches, %d differences of the whole matches\n", num_patterns, num_searches, num_differences);
+
+    return num_differences;
+}
+
+int main(int argc, char* argv[])
+{
+    int num_patterns = 2000;
+    int check_anchors = 0;
+    unsigned int seed = 1;
+
+    if (argc > 1)
+    {
+        num_patterns = atoi(argv[1]);
+    }
+    if (argc > 2)
+    {
+        seed = (unsigned int)atoi(argv[2]);
+    }
+    if (argc > 3 && strcmp(argv[3], "anchors") == 0)
+    {
+        check_anchors = 1;
+    }
+
+    /* the same seed repeats the same patterns and texts */
+    srand(seed);
+#if defined(__unix__)
+    signal(SIGALRM, stop_search);
+#endif
+
+    printf("Differential check of the matching engines against regexec() (%d patterns, seed %u%s):\n",
+        num_patterns, seed, check_anchors ? ", with anchors" : "");
+    printf("-------------------------------------------------------------------------------------\n");
+
+    return check_engines(num_patterns, check_anchors) == 0 ? 0 : 1;
+}
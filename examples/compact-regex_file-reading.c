@@ -54,8 +54,6 @@ void read_large_word_list_file()
 
     /* file length is 4862984 bytes */
     MAX_TEXT_LENGTH = 4862984;
-    /* more than 15000 matches */
-    MAX_NUM_MATCHES = 16000;
 
     regex_file = regex_readfile("example-text-files/words.txt");
 
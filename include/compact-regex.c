@@ -13,11 +13,96 @@
 
 #include "compact-regex.h"
 
+/* Compiled-pattern cache, ordered from the most to the least recently used entry */
+static cregcache_stats_t REGEX_CACHE_STATS = { 0, 0, 0, 0 };
+static cregcache_entry_t* REGEX_CACHE_FIRST = NULL;
+static cregcache_entry_t* REGEX_CACHE_LAST = NULL;
+
+/* Compile with -pthread to lock the compiled-pattern cache */
+#ifdef _REENTRANT
+static pthread_mutex_t REGEX_CACHE_MUTEX = PTHREAD_MUTEX_INITIALIZER;
+#define _CACHE__LOCK() pthread_mutex_lock(&REGEX_CACHE_MUTEX)
+#define _CACHE__UNLOCK() pthread_mutex_unlock(&REGEX_CACHE_MUTEX)
+#else
+#define _CACHE__LOCK()
+#define _CACHE__UNLOCK()
+#endif
+
+/* Serial number of the last compiled Pike VM program, the lazy DFAs of a results object are rebuilt for another program */
+static unsigned long REGEX_PIKE_SERIAL = 0;
+
+/* Compile with -pthread to number the Pike VM programs of several threads */
+#ifdef _REENTRANT
+static pthread_mutex_t REGEX_PIKE_MUTEX = PTHREAD_MUTEX_INITIALIZER;
+#define _PIKE__LOCK() pthread_mutex_lock(&REGEX_PIKE_MUTEX)
+#define _PIKE__UNLOCK() pthread_mutex_unlock(&REGEX_PIKE_MUTEX)
+#else
+#define _PIKE__LOCK()
+#define _PIKE__UNLOCK()
+#endif
+
+/* Compile with -pthread to match the texts of regex_match_batch() with several threads */
+#ifdef _REENTRANT
+#define _BATCH__LOCK(WORKER) pthread_mutex_lock(&(WORKER)->mutex)
+#define _BATCH__UNLOCK(WORKER) pthread_mutex_unlock(&(WORKER)->mutex)
+#else
+#define _BATCH__LOCK(WORKER)
+#define _BATCH__UNLOCK(WORKER)
+#endif
+
+/* Compile with -pthread to search the files of regex_search_tree() with several threads */
+#ifdef _REENTRANT
+#define _TREE__LOCK(TREE) pthread_mutex_lock(&(TREE)->mutex)
+#define _TREE__UNLOCK(TREE) pthread_mutex_unlock(&(TREE)->mutex)
+#else
+#define _TREE__LOCK(TREE)
+#define _TREE__UNLOCK(TREE)
+#endif
+
+/* Context of the calling thread, NULL = global limits and options */
+#if defined(REGEX_CONTEXT_KEY)
+static pthread_key_t REGEX_THREAD_CONTEXT_KEY;
+static pthread_once_t REGEX_THREAD_CONTEXT_ONCE = PTHREAD_ONCE_INIT;
+#define _CONTEXT__GET() (_CONTEXT__GET_KEY())
+#define _CONTEXT__SET(CONTEXT) (_CONTEXT__SET_KEY(CONTEXT))
+#else
+static REGEX_THREAD_LOCAL RegExContext REGEX_THREAD_CONTEXT = NULL;
+#define _CONTEXT__GET() (REGEX_THREAD_CONTEXT)
+#define _CONTEXT__SET(CONTEXT) (REGEX_THREAD_CONTEXT = (CONTEXT))
+#endif
+
+/* Value of a limit or option from the context of the calling thread or from the global variable */
+#define _CONTEXT(FIELD, GLOBAL) (_CONTEXT__GET() != NULL ? _CONTEXT__GET()->FIELD : (GLOBAL))
+
+/* Allocation functions of regex_set_allocator() */
+static cregallocator_t REGEX_ALLOCATOR = { NULL, NULL, NULL, NULL };
+
+/* (Internal) Memory allocation with the installed allocator, returns NULL on failure */
+static void* __TRY_MALLOC(size_t MEM_SIZE)
+{
+    if (REGEX_ALLOCATOR.malloc_function != NULL)
+    {
+        return REGEX_ALLOCATOR.malloc_function(MEM_SIZE, REGEX_ALLOCATOR.userdata);
+    }
+
+    return malloc(MEM_SIZE);
+}
+
+/* (Internal) Memory re-allocation with the installed allocator, returns NULL on failure */
+static void* __TRY_REALLOC(void* ptr, size_t MEM_SIZE)
+{
+    if (REGEX_ALLOCATOR.realloc_function != NULL)
+    {
+        return REGEX_ALLOCATOR.realloc_function(ptr, MEM_SIZE, REGEX_ALLOCATOR.userdata);
+    }
+
+    return realloc(ptr, MEM_SIZE);
+}
 
 /* (Internal) Memory allocation */
 static void* __MALLOC(size_t MEM_SIZE)
 {
-    void* ptr = malloc(MEM_SIZE);
+    void* ptr = __TRY_MALLOC(MEM_SIZE);
 
     if (ptr == NULL && MEM_SIZE)
     {
@@ -31,7 +116,7 @@ static void* __MALLOC(size_t MEM_SIZE)
 /* (Internal) Memory re-allocation */
 static void *__REALLOC(void* ptr, size_t MEM_SIZE)
 {
-    ptr = realloc(ptr, MEM_SIZE);
+    ptr = __TRY_REALLOC(ptr, MEM_SIZE);
 
     if (ptr == NULL && MEM_SIZE)
     {
@@ -47,7 +132,14 @@ static void __FREE(void* ptr)
 {
     if (ptr)
     {
-        free(ptr);
+        if (REGEX_ALLOCATOR.free_function != NULL)
+        {
+            REGEX_ALLOCATOR.free_function(ptr, REGEX_ALLOCATOR.userdata);
+        }
+        else
+        {
+            free(ptr);
+        }
         ptr = NULL;
     }
     else
@@ -57,6 +149,131 @@ static void __FREE(void* ptr)
     }
 }
 
+/* Size of a block header of an arena, rounded up to the alignment of the allocations */
+#define _ARENA__ALIGN(MEM_SIZE) (((MEM_SIZE) + REGEX_ARENA_ALIGNMENT - 1) / REGEX_ARENA_ALIGNMENT * REGEX_ARENA_ALIGNMENT)
+#define _ARENA__HEADER_SIZE _ARENA__ALIGN(sizeof(cregarena_block_t))
+
+/* (Internal) Initializes an empty arena. */
+static void _ARENA__INIT(cregarena_t* arena)
+{
+    arena->block = NULL;
+    arena->last_allocation = NULL;
+}
+
+/* (Internal) Allocates memory from the current block of an arena or from a new block, returns NULL on failure. */
+static void* _ARENA__ALLOC(cregarena_t* arena, size_t MEM_SIZE)
+{
+    cregarena_block_t* block = arena->block;
+    size_t BLOCK_SIZE = REGEX_ARENA_BLOCK_SIZE;
+
+    MEM_SIZE = _ARENA__ALIGN(MEM_SIZE);
+
+    if (block == NULL || block->size - block->used < MEM_SIZE)
+    {
+        /* each new block has twice the size of the previous block */
+        if (block != NULL)
+        {
+            BLOCK_SIZE = block->size * 2;
+        }
+        if (BLOCK_SIZE < MEM_SIZE)
+        {
+            BLOCK_SIZE = MEM_SIZE;
+        }
+
+        block = __TRY_MALLOC(_ARENA__HEADER_SIZE + BLOCK_SIZE);
+
+        if (block == NULL)
+        {
+            return NULL;
+        }
+
+        block->previous = arena->block;
+        block->size = BLOCK_SIZE;
+        block->used = 0;
+        arena->block = block;
+    }
+
+    arena->last_allocation = (char*)block + _ARENA__HEADER_SIZE + block->used;
+    block->used += MEM_SIZE;
+
+    return arena->last_allocation;
+}
+
+/* (Internal) Re-allocates arena memory, the last allocation grows in place. */
+static void* _ARENA__REALLOC(cregarena_t* arena, void* ptr, size_t OLD_SIZE, size_t MEM_SIZE)
+{
+    cregarena_block_t* block = arena->block;
+    void* new_ptr;
+
+    if (ptr != NULL && ptr == arena->last_allocation &&
+        block->size - (block->used - _ARENA__ALIGN(OLD_SIZE)) >= _ARENA__ALIGN(MEM_SIZE))
+    {
+        block->used = block->used - _ARENA__ALIGN(OLD_SIZE) + _ARENA__ALIGN(MEM_SIZE);
+        return ptr;
+    }
+
+    new_ptr = _ARENA__ALLOC(arena, MEM_SIZE);
+
+    if (ptr != NULL && new_ptr != NULL)
+    {
+        memcpy(new_ptr, ptr, OLD_SIZE < MEM_SIZE ? OLD_SIZE : MEM_SIZE);
+    }
+
+    return new_ptr;
+}
+
+/* (Internal) Marks all arena memory as unused and keeps one block of the total size for the next execution. */
+static void _ARENA__RESET(cregarena_t* arena)
+{
+    cregarena_block_t* block = arena->block;
+    size_t TOTAL_SIZE = 0;
+
+    if (block == NULL)
+    {
+        return;
+    }
+
+    /* several blocks: replace them with one block, so the next execution with the same memory use needs no allocation */
+    if (block->previous != NULL)
+    {
+        for (; block != NULL; block = block->previous)
+        {
+            TOTAL_SIZE += block->size;
+        }
+
+        _ARENA__FREE(arena);
+
+        /* without memory for the joined block the arena starts empty */
+        arena->block = __TRY_MALLOC(_ARENA__HEADER_SIZE + TOTAL_SIZE);
+
+        if (arena->block == NULL)
+        {
+            return;
+        }
+
+        arena->block->previous = NULL;
+        arena->block->size = TOTAL_SIZE;
+    }
+
+    arena->block->used = 0;
+    arena->last_allocation = NULL;
+}
+
+/* (Internal) Frees all blocks of an arena. */
+static void _ARENA__FREE(cregarena_t* arena)
+{
+    cregarena_block_t* previous;
+
+    while (arena->block != NULL)
+    {
+        previous = arena->block->previous;
+        __FREE(arena->block);
+        arena->block = previous;
+    }
+
+    arena->last_allocation = NULL;
+}
+
 /* (Internal) Function parameter check */
 static void __ASSERT_PARAM(void* parameter, char* name, int TYPE)
 {
@@ -78,7 +295,7 @@ static char* __SUBSTITUTE_STRING(char* input_text_string, char* search_substring
     const int STRLEN_INPUT = strlen(input_text_string);
     const int STRLEN_SEARCH = (int)strlen(search_substring);
     const int STRLEN_REPLACE = (int)strlen(replace_substring);
-    const int MAX_STRLEN = MAX_TEXT_LENGTH + 1;
+    const int MAX_STRLEN = _CONTEXT(max_text_length, MAX_TEXT_LENGTH) + 1;
 
     char* ptr_pos = 0;
     char* output_string = __MALLOC(MAX_STRLEN * sizeof(char));
@@ -168,69 +385,206 @@ static char* __SUBSTITUTE_STRING(char* input_text_string, char* search_substring
     return output_string;
 }
 
-/* (Internal) Converts the character classes in the regular expression. */
+/* (Internal) Converts the character classes in the regular expression, returns NULL without memory. */
 static char* _COMPILE__CONVERT_SEQUENCES(char* regex_pattern_string)
 {
-    struct replace_substrings { char* search; char* replace; };
-    struct replace_substrings replace_substring_list[12] = {
-        { "\\w", "A-Za-z0-9_" },    /* Alphanumeric characters plus "_" */
-        { "\\W", "^A-Za-z0-9_" },   /* Non-word characters */
-        { "\\a", "A-Za-z" },        /* Alphabetic characters */
-        { "\\s", " " },             /* Space */
-        { "\\t", "   " },           /* Space and tab */
-        { "\\d", "0-9" },           /* Digits */
-        { "\\D", "^0-9" },          /* Non-Digits */
-        { "\\l", "a-z" },           /* Lowercase letters */
-        { "\\p", "\\x20-\\x7E" },   /* Visible characters and the space character */
-        { "\\u", "A-Z" },           /* Uppercase letters */
-        { "\\r", "\r" },            /* Carriage Return */
-        { "\\n", "\\n" },            /* Newline */
+    struct replace_substrings { char search; char* replace; };
+    static const struct replace_substrings replace_substring_list[12] = {
+        { 'w', "A-Za-z0-9_" },      /* Alphanumeric characters plus "_" */
+        { 'W', "^A-Za-z0-9_" },     /* Non-word characters */
+        { 'a', "A-Za-z" },          /* Alphabetic characters */
+        { 's', " " },               /* Space */
+        { 't', "   " },             /* Space and tab */
+        { 'd', "0-9" },             /* Digits */
+        { 'D', "^0-9" },            /* Non-Digits */
+        { 'l', "a-z" },             /* Lowercase letters */
+        { 'p', " -~" },             /* Visible characters and the space character (\x20-\x7E) */
+        { 'u', "A-Z" },             /* Uppercase letters */
+        { 'r', "\r" },              /* Carriage Return */
+        { 'n', "\n" },              /* Newline */
     };
 
     int i;
-    char converted_sequence[2][8];
-    char* converted_regex_pattern_string = __MALLOC(MAX_PATTERN_LENGTH * sizeof(char));
+    int IN_LIST = 0;                    /* inside of a bracket expression [...] */
+    const size_t STRLEN_PATTERN = strlen(regex_pattern_string);
+    const char* read_ptr = regex_pattern_string;
+    char* write_ptr;
+    char* converted_regex_pattern_string;
+
+    /* no escape sequences: the pattern is already in POSIX form */
+    if (strchr(regex_pattern_string, '\\') == NULL)
+    {
+        converted_regex_pattern_string = __TRY_MALLOC((STRLEN_PATTERN + 1) * sizeof(char));
+
+        if (converted_regex_pattern_string != NULL)
+        {
+            memcpy(converted_regex_pattern_string, regex_pattern_string, STRLEN_PATTERN + 1);
+        }
 
-    strcpy(converted_regex_pattern_string, regex_pattern_string);
+        return converted_regex_pattern_string;
+    }
 
-    /* replace listed substrings */
-    for (i = 0; i < 12; i++)
+    /* the longest substitution "\W" -> "[^A-Za-z0-9_]" grows 2 characters to 13 */
+    converted_regex_pattern_string = __TRY_MALLOC((STRLEN_PATTERN * 7 + 1) * sizeof(char));
+
+    if (converted_regex_pattern_string == NULL)
     {
-        converted_regex_pattern_string = __SUBSTITUTE_STRING(converted_regex_pattern_string, replace_substring_list[i].search, replace_substring_list[i].replace, REPLACE_SET_BRACKETS, REPLACE_GLOBAL, 0);
+        return NULL;
     }
 
-    /* convert ascii sequences given as arguments */
-    for (i = 33; i < 128; i++)
+    write_ptr = converted_regex_pattern_string;
+
+    while (*read_ptr != '\0')
     {
-        sprintf(converted_sequence[0], "\\x%x", i);
-        converted_sequence[1][0] = i;
-        converted_sequence[1][1] = '\0';
-        converted_regex_pattern_string = __SUBSTITUTE_STRING(converted_regex_pattern_string, converted_sequence[0], converted_sequence[1], REPLACE_NO_BRACKETS, REPLACE_GLOBAL, 0);
+        if (*read_ptr == '\\' && read_ptr[1] != '\0')
+        {
+            /* ascii sequence \x21 ... \x7f */
+            if (read_ptr[1] == 'x' &&
+                isxdigit((unsigned char)read_ptr[2]) &&
+                isxdigit((unsigned char)read_ptr[3]))
+            {
+                char hex_string[3];
+                long value;
+
+                hex_string[0] = read_ptr[2];
+                hex_string[1] = read_ptr[3];
+                hex_string[2] = '\0';
+                value = strtol(hex_string, NULL, 16);
+
+                if (value > 0 && value < 128)
+                {
+                    *write_ptr++ = (char)value;
+                    read_ptr += 4;
+                    continue;
+                }
+            }
+
+            /* character class: set brackets around the substitution if it is not in a list */
+            for (i = 0; i < 12; i++)
+            {
+                if (read_ptr[1] == replace_substring_list[i].search)
+                {
+                    const size_t STRLEN_REPLACE = strlen(replace_substring_list[i].replace);
+
+                    if (!IN_LIST)
+                    {
+                        *write_ptr++ = '[';
+                    }
+
+                    memcpy(write_ptr, replace_substring_list[i].replace, STRLEN_REPLACE);
+                    write_ptr += STRLEN_REPLACE;
+
+                    if (!IN_LIST)
+                    {
+                        *write_ptr++ = ']';
+                    }
+
+                    break;
+                }
+            }
+
+            if (i < 12)
+            {
+                read_ptr += 2;
+                continue;
+            }
+
+            /* other escaped characters are kept as they are, a backslash inside of a list is a literal */
+            if (!IN_LIST)
+            {
+                *write_ptr++ = *read_ptr++;
+                *write_ptr++ = *read_ptr++;
+                continue;
+            }
+        }
+
+        if (!IN_LIST && *read_ptr == '[')
+        {
+            /* opening bracket, a "]" as first list item is a literal */
+            IN_LIST = 1;
+            *write_ptr++ = *read_ptr++;
+
+            if (*read_ptr == '^')
+            {
+                *write_ptr++ = *read_ptr++;
+            }
+            if (*read_ptr == ']')
+            {
+                *write_ptr++ = *read_ptr++;
+            }
+
+            continue;
+        }
+
+        if (IN_LIST && *read_ptr == '[' &&
+            (read_ptr[1] == ':' || read_ptr[1] == '.' || read_ptr[1] == '='))
+        {
+            /* copy character classes [:alpha:], collating symbols [.-.] and equivalence classes [=a=] */
+            const char DELIMITER = read_ptr[1];
+
+            *write_ptr++ = *read_ptr++;
+            *write_ptr++ = *read_ptr++;
+
+            while (*read_ptr != '\0' && !(read_ptr[0] == DELIMITER && read_ptr[1] == ']'))
+            {
+                *write_ptr++ = *read_ptr++;
+            }
+
+            if (*read_ptr != '\0')
+            {
+                *write_ptr++ = *read_ptr++;
+                *write_ptr++ = *read_ptr++;
+            }
+
+            continue;
+        }
+
+        if (IN_LIST && *read_ptr == ']')
+        {
+            IN_LIST = 0;
+        }
+
+        *write_ptr++ = *read_ptr++;
     }
 
+    *write_ptr = '\0';
+
     return converted_regex_pattern_string;
 }
 
-/* (Internal) Initializes a RegEx object. */
+/* (Internal) Initializes a RegEx object, returns NULL without memory. */
 static RegEx _COMPILE__INIT_REGEX(char* regex_pattern_string, int OPTION_FLAGS)
 { 
     int i = 0;
 
     /* initialize RegEx */
-    RegEx regex_data = __MALLOC(sizeof(compact_regex_t));
+    RegEx regex_data = __TRY_MALLOC(sizeof(compact_regex_t));
 
     __ASSERT_PARAM(regex_pattern_string, "regex_pattern_string", ASSERT_TYPE_PTR);
 
+    if (regex_data == NULL)
+    {
+        return NULL;
+    }
+
     /* get default flags */
     for (i = 0; i < (int)(sizeof(DEFAULT_REG_FLAGS) / sizeof(DEFAULT_REG_FLAGS[0])); i++)
     {
-        if ((OPTION_FLAGS & DEFAULT_REG_FLAGS[i]) != DEFAULT_REG_FLAGS[i])
+        if ((OPTION_FLAGS & _CONTEXT(default_reg_flags, DEFAULT_REG_FLAGS)[i]) != _CONTEXT(default_reg_flags, DEFAULT_REG_FLAGS)[i])
         {
-            OPTION_FLAGS += DEFAULT_REG_FLAGS[i];
+            OPTION_FLAGS += _CONTEXT(default_reg_flags, DEFAULT_REG_FLAGS)[i];
         }
     }
 
     regex_data->file = NULL;
+    regex_data->matches = NULL;
+    regex_data->regex_h.match_offsets = NULL;
+    regex_data->regex_h.match_strings = NULL;
+    regex_data->regex_h.match_capacity = 0;
+    regex_data->regex_h.cache_entry = NULL;
+    regex_data->regex_h.program = NULL;
+    _ARENA__INIT(&regex_data->regex_h.arena);
+    _DFA__INIT_SET(&regex_data->regex_h.dfas);
     
     /* set options */
     regex_data->flags.GLOBAL = ((OPTION_FLAGS & REG_GLOBAL) == REG_GLOBAL);
@@ -241,6 +595,10 @@ static RegEx _COMPILE__INIT_REGEX(char* regex_pattern_string, int OPTION_FLAGS)
     regex_data->flags.NEWLINE = ((OPTION_FLAGS & REG_NEWLINE) == REG_NEWLINE);
     regex_data->flags.MULTILINE = ((OPTION_FLAGS & REG_MULTILINE) == REG_MULTILINE);
     regex_data->flags.SUBEXP = ((OPTION_FLAGS & REG_SUBEXP) == REG_SUBEXP);
+    regex_data->flags.PARALLEL = ((OPTION_FLAGS & REG_PARALLEL) == REG_PARALLEL);
+    regex_data->flags.NOCOPY = ((OPTION_FLAGS & REG_NOCOPY) == REG_NOCOPY);
+    regex_data->flags.PIKEVM = ((OPTION_FLAGS & REG_PIKEVM) == REG_PIKEVM);
+    regex_data->flags.LAZYDFA = ((OPTION_FLAGS & REG_LAZYDFA) == REG_LAZYDFA);
 
     /* deactivate REG_NEWLINE if REG_MULTILINE is set, to catch newline-characters */
     if (regex_data->flags.MULTILINE == 1 && regex_data->flags.NEWLINE == 1)
@@ -270,8 +628,18 @@ static RegEx _COMPILE__INIT_REGEX(char* regex_pattern_string, int OPTION_FLAGS)
     regex_data->num_matches = 0;
     regex_data->num_pattern_subexpr = 0;
     regex_data->return_code = REGEX_INIT_SUCCESS;
-    regex_data->text = __MALLOC(16 * sizeof(char));
+    regex_data->text = __TRY_MALLOC(16 * sizeof(char));
+
+    if (regex_data->text == NULL)
+    {
+        __FREE(regex_data);
+        return NULL;
+    }
+
     strcpy(regex_data->text, "<No input text>");
+    regex_data->text_length = 0;
+    regex_data->text_capacity = 16;
+    regex_data->regex_h.text_buffer = regex_data->text;
     regex_data->pattern = regex_pattern_string;
     strcpy(regex_data->error_message, "");
     regex_data->regex_h.reglib_status = REGLIB_NOT_COMPILED;
@@ -279,1748 +647,6615 @@ static RegEx _COMPILE__INIT_REGEX(char* regex_pattern_string, int OPTION_FLAGS)
     return regex_data;
 }
 
-/* (Internal) Copies the strings from regex_h of regexec into RegEx-subobject. */
-static void _EXEC__GET_MATCHED_STRINGS(char* input_text_string, RegEx regex_data)
+/* (Internal) Compiles the regular expression pattern of an initialized RegEx object. */
+static void _COMPILE__REGEX(RegEx regex_data, char* regex_pattern_string)
 {
-    int i;
-    char* temp_string;
+    if (_CONTEXT(max_pattern_length, MAX_PATTERN_LENGTH) > 16384)
+    {
+        sprintf(regex_data->error_message, "MAX_PATTERN_LENGTH exceeds maximum size of 16384\n");
+        regex_data->return_code = REGEX_ERROR;
+    }
 
-    for (i = 0; i < regex_data->num_matches; i++)
+    if (regex_data != NULL && regex_data->return_code == REGEX_INIT_SUCCESS)
     {
-        int STR_SIZE = regex_data->regex_h.match_offsets[i].rm_eo - regex_data->regex_h.match_offsets[i].rm_so;
+        /* compile regular expression */
+        if (strlen(regex_pattern_string) < _CONTEXT(max_pattern_length, MAX_PATTERN_LENGTH))
+        {
+            /* convert regular expression character classes */
+            char* converted_regex_pattern_string = _COMPILE__CONVERT_SEQUENCES(regex_pattern_string);
+
+            /* the RegEx object is freed by the caller */
+            if (converted_regex_pattern_string == NULL)
+            {
+                regex_data->return_code = REGEX_ERROR_MEMORY;
+                return;
+            }
+
+            /*  int regcomp(regex_t * preg, const char*  pattern, int cflags);
+                --------------------------------------------------------------
+                Compiles the regular expression specified by pattern into an executable string of op-codes.
+
+                preg:       is a pointer to a compiled regular expression.
+                pattern:    is a pointer to a character string defining a source regular expression (described below).
+                cflags:     is a bit flag defining configurable attributes of compilation process:
+                            REG_EXTENDED: Support extended regular expressions.
+                            REG_ICASE:    Ignore case in match.
+                            REG_NEWLINE:  Eliminate any special significance to the newline character.
+                            REG_NOSUB:    Report only success or fail in regexec(), that is, verify the syntax of a regular expression.
+                                          If this flag is set, the regcomp() function sets re_nsub to the number of parenthesized sub-expressions found in pattern.
+                                          Otherwise, a sub-expression results in an error.
+
+                return:     If successful, regcomp() returns 0.
+                            If unsuccessful, regcomp() returns nonzero, and the content of preg is undefined. */
+            regex_data->return_code = regcomp(&regex_data->regex_h.compiled_regex, converted_regex_pattern_string, regex_data->regex_h.reglib_flags);
+            regex_data->num_pattern_subexpr = (int)regex_data->regex_h.compiled_regex.re_nsub;
 
-        regex_data->matches[i].start = (int)regex_data->regex_h.match_offsets[i].rm_so;
-        regex_data->matches[i].end = (int)regex_data->regex_h.match_offsets[i].rm_eo;
-        regex_data->matches[i].string = __MALLOC((STR_SIZE + 1) * sizeof(char));
+            /* without a Pike VM program for the pattern or without memory the RegEx object is searched by regexec() */
+            if (regex_data->return_code == REGEX_COMP_SUCCESS && (regex_data->flags.PIKEVM == 1 || regex_data->flags.LAZYDFA == 1))
+            {
+                regex_data->regex_h.program = _PIKE__COMPILE(converted_regex_pattern_string, regex_data->regex_h.reglib_flags, regex_data->num_pattern_subexpr);
+            }
 
-        /* copy substring to temp string */
-        temp_string = __MALLOC((strlen(input_text_string) + 1) * sizeof(char));
-        strcpy(temp_string, input_text_string + regex_data->matches[i].start);
-        temp_string[STR_SIZE] = '\0';
+            __FREE(converted_regex_pattern_string);
+        }
+        else
+        {
+            regex_data->return_code = REGEX_ERROR;
+            sprintf(regex_data->error_message, "Pattern string exceeds maximum length of %d\n", _CONTEXT(max_pattern_length, MAX_PATTERN_LENGTH));
+        }
 
-        /* copy temp string to match string */
-        strcpy(regex_data->matches[i].string, temp_string);
-        regex_data->matches[i].string[STR_SIZE] = '\0';
+        if (strlen(regex_pattern_string) == 0)
+        {
+            regex_data->return_code = REGEX_ERROR;
+            sprintf(regex_data->error_message, "Regular expression pattern is empty\n");
+        }
 
-        __FREE(temp_string);
+        /* set regex.h status */
+        if (regex_data->return_code == REGEX_COMP_SUCCESS)
+        {
+            strcpy(regex_data->error_message, "No error");
+            regex_data->regex_h.reglib_status = REGLIB_COMPILED;
+        }
+        else if (regex_data->return_code == REGEX_ERROR)
+        {
+            regex_data->regex_h.reglib_status = REGLIB_ERROR;
+        }
+    }
+    else
+    {
+        fprintf(stderr, "regex_compile() error: Regex object is not initialized.\n");
     }
 }
 
-/* (Internal) Searches for the first occurence of the regular expression pattern in the input text string. */
-static int _EXEC__SEARCH_LOCAL(char* input_text_string, RegEx regex_data)
+/* (Internal) Frees a RegEx object whose compilation failed without memory and returns NULL, otherwise the RegEx object. */
+static RegEx _COMPILE__CHECK_MEMORY(RegEx regex_data)
 {
-    int i = 0;
-    int ITEM_NUMBER = 0;
-    int MATCH_NUMBER = 0;
-    int return_code = -1;
+    if (regex_data->return_code == REGEX_ERROR_MEMORY)
+    {
+        fprintf(stderr, "regex_compile() error: Could not allocate memory.\n");
+        __FREE(regex_data->text);
+        __FREE(regex_data);
 
-    /* int regexec(const regex_t * preg, const char*  string, size_t nmatch, regmatch_t * pmatch, int eflags);
-    -------------------------------------------------------------------------------------------------------
-    Compares the NULL-terminated string specified by string against the compiled regular expression, preg. 
+        return NULL;
+    }
 
-    preg:   is a pointer to a compiled regular expression to compare against STRING.
-    string: is a pointer to a string to be matched.
-    nmatch: is the number of sub-expressions to match.
-    pmatch: is an array of offsets into STRING which matched the corresponding sub-expressions in preg.
-            typedef struct
-            {
-              regoff_t rm_so;  // Byte offset from string's start to substring's start.
-              regoff_t rm_eo;  // Byte offset from string's start to substring's end.
-            } regmatch_t;
+    return regex_data;
+}
 
-    eflags: is a bit flag defining customizable behavior of regexec():
-            REG_NOTBOL: Indicates that the first character of STRING is not the beginning of the line.
-            REG_NOTEOL: Indicates that the first character of STRING is not the end of the line. 
+/* (Internal) Hashes a pattern string together with its option flags. */
+static unsigned long _CACHE__HASH(char* regex_pattern_string, int reglib_flags)
+{
+    /* FNV-1a */
+    unsigned long hash = 2166136261UL;
 
-    return: if a match is found, regexec() returns 0. */
-    regmatch_t* match_iteration = __MALLOC(MAX_NUM_MATCHES * sizeof(regmatch_t));        /* match of one iteration */
-    regex_data->regex_h.match_offsets = __MALLOC(MAX_NUM_MATCHES * sizeof(regmatch_t));
-    regex_data->matches = __MALLOC(MAX_NUM_MATCHES * sizeof(cregmatches_t));
+    while (*regex_pattern_string != '\0')
+    {
+        hash ^= (unsigned char)*regex_pattern_string++;
+        hash *= 16777619UL;
+    }
 
-    /*return_code = regexec(&(regex_data->regex_h.compiled_regex), input_text_string, MAX_NUM_MATCHES, (regmatch_t*)regex_data->regex_h.match_offsets, 0);*/
+    hash ^= (unsigned long)reglib_flags;
+    hash *= 16777619UL;
 
-    return_code = regexec(&(regex_data->regex_h.compiled_regex), input_text_string, MAX_NUM_MATCHES, (regmatch_t*)match_iteration, 0);
+    return hash;
+}
 
-    /* copy matched strings */
-    if (return_code == REGEX_MATCH_SUCCESS)
+/* (Internal) Unlinks an entry from the recently used list of the compiled-pattern cache. */
+static void _CACHE__UNLINK(cregcache_entry_t* cache_entry)
+{
+    if (cache_entry->prev != NULL)
     {
-        /* next match successful */
-        MATCH_NUMBER += 1;
+        cache_entry->prev->next = cache_entry->next;
+    }
+    else
+    {
+        REGEX_CACHE_FIRST = cache_entry->next;
+    }
 
-        /* get number of matches */
-        for (i = 0; i < MAX_NUM_MATCHES; i++)
-        {
-            /* some library bug on (a)|(b) matching second group at next element instead of this */
-            if (match_iteration[i].rm_so == (size_t)-1)
-            {
-                break;
-            }
+    if (cache_entry->next != NULL)
+    {
+        cache_entry->next->prev = cache_entry->prev;
+    }
+    else
+    {
+        REGEX_CACHE_LAST = cache_entry->prev;
+    }
 
-            /* if this match is valid */
-            if (match_iteration[i].rm_so != (size_t)-1)
-            { 
-                /* set the item number to one lesser, if previous match was invalid, to step over invalid matches */
-                if (i > 0 && match_iteration[i-1].rm_so == -1)
-                {
-                    ITEM_NUMBER = i - 1;
-                }
-                else
-                {
-                    ITEM_NUMBER = i;
-                }
-
-                regex_data->matches[ITEM_NUMBER].number_match = MATCH_NUMBER;
-                regex_data->matches[ITEM_NUMBER].number_submatch = regex_data->flags.SUBEXP == 0 ? ITEM_NUMBER : ITEM_NUMBER + 1;
-
-                if ((regex_data->flags.SUBEXP == 0 && regex_data->flags.NOSUBEXP == 0) ||                       /* add every result, if SUBEXP = 0 */
-                    (regex_data->flags.SUBEXP == 0 && regex_data->flags.NOSUBEXP == 1 && ITEM_NUMBER == 0) ||   /* add just the main matches, if NOSUBEXP = 1 */
-                    (regex_data->flags.SUBEXP == 1 && ITEM_NUMBER > 0))                                    
-                {
-                    memcpy(&regex_data->regex_h.match_offsets[regex_data->num_matches], &match_iteration[i], sizeof(regmatch_t));
-                    regex_data->num_matches++;
-                }
-            }
-        }
+    cache_entry->prev = NULL;
+    cache_entry->next = NULL;
+}
 
-        __FREE(match_iteration);
+/* (Internal) Removes the least recently used entries until the cache fits into its capacity. */
+static void _CACHE__EVICT(unsigned int capacity)
+{
+    while (REGEX_CACHE_STATS.size > capacity && REGEX_CACHE_LAST != NULL)
+    {
+        cregcache_entry_t* cache_entry = REGEX_CACHE_LAST;
 
-        /* resize regex.h buffer from MAX_NUM_MATCHES to num_matches + 1 */
-        regex_data->regex_h.match_offsets = __REALLOC(regex_data->regex_h.match_offsets, (regex_data->num_matches + 1) * sizeof(regmatch_t));
+        _CACHE__UNLINK(cache_entry);
+        REGEX_CACHE_STATS.size--;
 
-        /* copy substrings from input text */
-        _EXEC__GET_MATCHED_STRINGS(input_text_string, regex_data);
-        regex_data->regex_h.reglib_status = REGLIB_EXECUTED;
+        /* entries still used by a RegEx object are freed by its regex_close() */
+        if (cache_entry->references == 0)
+        {
+            regfree(&cache_entry->compiled_regex);
+            _PIKE__FREE(cache_entry->program);
+            __FREE(cache_entry->pattern);
+            __FREE(cache_entry);
+        }
+        else
+        {
+            cache_entry->evicted = 1;
+        }
     }
-
-    return return_code;
 }
 
-/* (Internal) Searches for all occurences of the regular expression pattern in the input text string. */
-static int _EXEC__SEARCH_GLOBAL(char* input_text_string, RegEx regex_data)
+/* (Internal) Compiles a regular expression pattern, optionally with REG_NOSUB, or takes it from the compiled-pattern cache. */
+static RegEx _CACHE__COMPILE(char* regex_pattern_string, int OPTION_FLAGS, int NOSUB)
 {
-    int return_code_local = -1;         /* return code for loop */
-    int return_code_global = -1;        /* return code for function */ 
-
-    int i = 0;                          /* loop counters */
-    int j = 0;       
-    int BREAK = 0;                      /* loop break flag */
-    
-    int READ_POS_OFFSET = 0;            /* read position in input string */
-    int NEXT_VALID_MATCH_DISTANCE = 0;  /* distance to next valid match in regmatch_t array */
-    
-    int NUMBER_MATCH = 0;
-    int NUMBER_GROUP = 0;
-    int NUMBER_SUBMATCH = 0;
+    RegEx regex_data;
+    cregcache_entry_t* cache_entry;
+    unsigned long hash;
 
-    regmatch_t* match_iteration = __MALLOC(MAX_NUM_MATCHES * sizeof(regmatch_t));        /* match of one iteration */
-    regex_data->regex_h.match_offsets = __MALLOC(MAX_NUM_MATCHES * sizeof(regmatch_t)); /* matches of all iterations */
-    regex_data->matches = __MALLOC(MAX_NUM_MATCHES * sizeof(cregmatches_t));
+    _CACHE__LOCK();
 
-    /* full initialize regmatch_t array fields */
-    for (i = 0; i < MAX_NUM_MATCHES; i++)
+    if (REGEX_CACHE_STATS.capacity == 0 && NOSUB == 0)
     {
-        match_iteration[i].rm_so = -1;
-        match_iteration[i].rm_eo = -1;
-        
+        _CACHE__UNLOCK();
+        return regex_compile(regex_pattern_string, OPTION_FLAGS);
     }
 
-    /* fix segmentation fault in _REPLACE__PREPROCESS_GROUPS */
-    for (i = 0; i <= 99; i++)
+    regex_data = _COMPILE__INIT_REGEX(regex_pattern_string, OPTION_FLAGS);
+
+    if (regex_data == NULL)
     {
-        regex_data->matches[i].number_match = 0;
-        regex_data->matches[i].number_submatch = 0;
+        _CACHE__UNLOCK();
+        fprintf(stderr, "regex_compile() error: Could not allocate memory.\n");
+        return NULL;
     }
 
-    /* get next global match in: input string + read position offset */
-    while (1)
+    /* compile for a success or fail report of regexec() only */
+    if (NOSUB == 1)
     {
-        if (regex_data->return_code != REGEX_ERROR)
-        {
-            return_code_local = regexec(&regex_data->regex_h.compiled_regex, input_text_string + READ_POS_OFFSET, MAX_NUM_MATCHES, (regmatch_t*)match_iteration, 0);
-        }
-
-        /* copy single iteration match into regex_h matches, until no matches found */
-        if (return_code_local == REGEX_MATCH_SUCCESS)
-        {
-            /* set function return code to 0 */
-            return_code_global = REGEX_MATCH_SUCCESS;
+        regex_data->regex_h.reglib_flags |= REG_NOSUB;
+    }
 
-            /* this match successful */
-            NUMBER_MATCH += 1;
+    if (REGEX_CACHE_STATS.capacity == 0)
+    {
+        _CACHE__UNLOCK();
+        _COMPILE__REGEX(regex_data, regex_pattern_string);
+        return _COMPILE__CHECK_MEMORY(regex_data);
+    }
 
-            /* copy matches into regex.h buffer */
-            /* for each match found in regmatch_t array */
-            for (i = 0; i <= regex_data->num_pattern_subexpr; i++)
-            {
-                /* for each next match ahead */
-                for (j = i + 1; j <= regex_data->num_pattern_subexpr; j++)
-                {
-                    /* if first match /= set top match */
-                    if (i == 0)
-                    {
-                        NUMBER_GROUP = 0;
-                    }
-                    if (i == 1 && return_code_local == REGEX_MATCH_OFFSET_DIST)
-                    {
-                        NUMBER_GROUP = NEXT_VALID_MATCH_DISTANCE;
-                    }
-                    
-                    /* if one of the next matches is valid -> break */
-                    if (match_iteration[j].rm_so != (size_t) - 1)
-                    {   
-                        BREAK = 0;
-                        NEXT_VALID_MATCH_DISTANCE = j - i;
-                     
-                        /* if one of the next valid matches is more away, instead the next one */
-                        if (NEXT_VALID_MATCH_DISTANCE > 1)
-                        {
-                            return_code_local = REGEX_MATCH_OFFSET_DIST;
-                        }
+    hash = _CACHE__HASH(regex_pattern_string, regex_data->regex_h.reglib_flags);
 
-                        break;
-                    }
-                    
-                    /* break if maximum next possible matches checked */
-                    if (j == regex_data->num_pattern_subexpr)
-                    {
-                        BREAK = 1;
-                    }
-                }
+    for (cache_entry = REGEX_CACHE_FIRST; cache_entry != NULL; cache_entry = cache_entry->next)
+    {
+        if (cache_entry->hash == hash &&
+            cache_entry->reglib_flags == regex_data->regex_h.reglib_flags &&
+            (cache_entry->program_compiled == 1 || (regex_data->flags.PIKEVM == 0 && regex_data->flags.LAZYDFA == 0)) &&
+            strcmp(cache_entry->pattern, regex_pattern_string) == 0)
+        {
+            break;
+        }
+    }
 
-                /* -> break if match is invalid and no valid matches ahead */
-                if (match_iteration[i].rm_so == (size_t)-1 && BREAK == 1)
-                {
-                    break; 
-                }
+    if (cache_entry != NULL)
+    {
+        REGEX_CACHE_STATS.hits++;
 
-                /* if this match is valid */
-                if (match_iteration[i].rm_so != -1)
-                {
-                    /* get start and end positions in original string */
-                    match_iteration[i].rm_so += READ_POS_OFFSET;  /* add last read offset to start position */
-                    match_iteration[i].rm_eo += READ_POS_OFFSET;  /* add last read offset to end position */
+        /* move entry to the front of the recently used list */
+        if (cache_entry != REGEX_CACHE_FIRST)
+        {
+            _CACHE__UNLINK(cache_entry);
+            cache_entry->next = REGEX_CACHE_FIRST;
+            REGEX_CACHE_FIRST->prev = cache_entry;
+            REGEX_CACHE_FIRST = cache_entry;
+        }
 
-                    NUMBER_SUBMATCH = (return_code_local == REGEX_MATCH_OFFSET_DIST) ? NUMBER_GROUP : i;
+        /* the RegEx object shares the compiled regular expression of the entry */
+        cache_entry->references++;
+        regex_data->regex_h.compiled_regex = cache_entry->compiled_regex;
+        regex_data->regex_h.program = cache_entry->program;
+        regex_data->regex_h.cache_entry = cache_entry;
+        regex_data->num_pattern_subexpr = cache_entry->num_pattern_subexpr;
+        regex_data->return_code = REGEX_COMP_SUCCESS;
+        strcpy(regex_data->error_message, "No error");
+        regex_data->regex_h.reglib_status = REGLIB_COMPILED;
+        _CACHE__UNLOCK();
+
+        return regex_data;
+    }
 
-                    /* set the match number and group number */
-                    regex_data->matches[regex_data->num_matches].number_match = NUMBER_MATCH;
-                    regex_data->matches[regex_data->num_matches].number_submatch = NUMBER_SUBMATCH;
+    REGEX_CACHE_STATS.misses++;
+    _COMPILE__REGEX(regex_data, regex_pattern_string);
 
-                    if ((regex_data->flags.SUBEXP == 0 && regex_data->flags.NOSUBEXP == 0) ||                         /* add every result, if SUBEXP = 0 */
-                        (regex_data->flags.SUBEXP == 0 && regex_data->flags.NOSUBEXP == 1 && NUMBER_SUBMATCH == 0) || /* add just the main matches, if NOSUBEXP = 1 */
-                        (regex_data->flags.SUBEXP == 1 && NUMBER_SUBMATCH > 0))                                    
-                    {
-                        /* copy match data */
-                        memcpy(&regex_data->regex_h.match_offsets[regex_data->num_matches], &match_iteration[i], sizeof(regmatch_t));
+    if (_COMPILE__CHECK_MEMORY(regex_data) == NULL)
+    {
+        _CACHE__UNLOCK();
+        return NULL;
+    }
 
-                        if (regex_data->num_matches < MAX_NUM_MATCHES)
-                        {
-                            regex_data->num_matches++;
-                        }
-                        else
-                        {
-                            regex_data->return_code = REGEX_ERROR;
-                            return_code_local = REGEX_ERROR;
-                            fprintf(stderr, "regex_exec() error: Number of matches exceeds maximum numer of MAX_NUM_MATCHES: %d.\n", MAX_NUM_MATCHES);
-                            break;
-                        }
-                    }
-                }
-            }
+    /* without memory for a cache entry the RegEx object keeps its own compiled regular expression */
+    if (regex_data->return_code == REGEX_COMP_SUCCESS &&
+        (cache_entry = __TRY_MALLOC(sizeof(cregcache_entry_t))) != NULL &&
+        (cache_entry->pattern = __TRY_MALLOC((strlen(regex_pattern_string) + 1) * sizeof(char))) != NULL)
+    {
+        strcpy(cache_entry->pattern, regex_pattern_string);
+        cache_entry->reglib_flags = regex_data->regex_h.reglib_flags;
+        cache_entry->hash = hash;
+        cache_entry->references = 1;
+        cache_entry->evicted = 0;
+        cache_entry->num_pattern_subexpr = regex_data->num_pattern_subexpr;
+        cache_entry->compiled_regex = regex_data->regex_h.compiled_regex;
+        cache_entry->program = regex_data->regex_h.program;
+        cache_entry->program_compiled = (regex_data->flags.PIKEVM == 1 || regex_data->flags.LAZYDFA == 1);
+
+        /* insert entry at the front of the recently used list */
+        cache_entry->prev = NULL;
+        cache_entry->next = REGEX_CACHE_FIRST;
+
+        if (REGEX_CACHE_FIRST != NULL)
+        {
+            REGEX_CACHE_FIRST->prev = cache_entry;
         }
         else
         {
-            break;
+            REGEX_CACHE_LAST = cache_entry;
         }
 
-        /* end position of match = next read positon */
-        READ_POS_OFFSET = READ_POS_OFFSET + (match_iteration[0].rm_eo - READ_POS_OFFSET);
+        REGEX_CACHE_FIRST = cache_entry;
+        REGEX_CACHE_STATS.size++;
+        regex_data->regex_h.cache_entry = cache_entry;
 
-        /* if "^" or "$": only start or end of string -> break */
-        if (READ_POS_OFFSET == strlen(input_text_string) ||
-            match_iteration[0].rm_so == match_iteration[0].rm_eo)
-        {
-            break;
-        }
+        _CACHE__EVICT(REGEX_CACHE_STATS.capacity);
+    }
+    else if (cache_entry != NULL)
+    {
+        __FREE(cache_entry);
     }
 
-    __FREE(match_iteration);
+    _CACHE__UNLOCK();
 
-    /* resize regex.h buffer from MAX_NUM_MATCHES to num_matches + 1 */
-    regex_data->regex_h.match_offsets = __REALLOC(regex_data->regex_h.match_offsets, (regex_data->num_matches + 1) * sizeof(regmatch_t));
+    return regex_data;
+}
 
-    /* copy substrings from input text with match_offsets data */
-    if (return_code_local != REGEX_ERROR && return_code_global == REGEX_MATCH_SUCCESS)
-    {
-        _EXEC__GET_MATCHED_STRINGS(input_text_string, regex_data);
-        regex_data->regex_h.reglib_status = REGLIB_EXECUTED;
-    }
-    else
+/* (Internal) Releases the cache entry of a RegEx object. */
+static void _CACHE__RELEASE(RegEx regex_data)
+{
+    cregcache_entry_t* cache_entry = regex_data->regex_h.cache_entry;
+
+    _CACHE__LOCK();
+    cache_entry->references--;
+    regex_data->regex_h.cache_entry = NULL;
+
+    if (cache_entry->evicted == 1 && cache_entry->references == 0)
     {
-        return_code_global = return_code_local;
+        regfree(&cache_entry->compiled_regex);
+        _PIKE__FREE(cache_entry->program);
+        __FREE(cache_entry->pattern);
+        __FREE(cache_entry);
     }
 
-    return return_code_global;
+    _CACHE__UNLOCK();
 }
 
-/* (Internal) Replaces all group classifiers in a replacement string (\1, \2...) with the matched groups of a regular expression. */
-static char* _REPLACE__PREPROCESS_GROUPS(RegEx regex_data, char* replace_substring, int match_number)
+/* (Internal) Adds a node to the syntax tree of the Pike VM parser, returns -1 if the pattern is not supported. */
+static int _PIKE__NODE(cregpike_parser_t* parser, int type, int opcode, int arg, int child)
 {
-    int n = 0;
-    int group_classifier = 1;
-    int top_match = 0;
+    cregpike_node_t* node;
 
-    char* converted_replace_substring = __MALLOC(MAX_PATTERN_LENGTH * sizeof(char));
-    char* temp_string_1 = __MALLOC(MAX_PATTERN_LENGTH * sizeof(char));
-    char* temp_string_2 = __MALLOC(8 * sizeof(char));
+    if (parser->failed == 1 || parser->num_nodes == parser->max_nodes)
+    {
+        parser->failed = 1;
+        return -1;
+    }
 
-    strcpy(converted_replace_substring, replace_substring);
+    node = &parser->nodes[parser->num_nodes];
+    node->type = type;
+    node->opcode = opcode;
+    node->arg = arg;
+    node->min = 0;
+    node->max = 0;
+    node->child = child;
+    node->next = -1;
 
-    /* \1 ... \99 */
-    for (group_classifier = 1; group_classifier <= 99; group_classifier++)
+    return parser->num_nodes++;
+}
+
+/* (Internal) Adds an empty bracket expression to the Pike VM program, returns its index or -1 without memory. */
+static int _PIKE__NEW_CLASS(cregpike_parser_t* parser)
+{
+    cregpike_t* program = parser->program;
+    unsigned char* classes;
+
+    if (parser->failed == 1)
     {
-        n = match_number + group_classifier;
+        return -1;
+    }
 
-        strcpy(temp_string_1, "\\");
-        sprintf(temp_string_2, "%d", group_classifier);
-        strcat(temp_string_1, temp_string_2);
+    classes = __TRY_REALLOC(program->classes, (size_t)(program->num_classes + 1) * REGEX_PIKE_CLASS_SIZE);
 
-        if (top_match == 0)
-        {
-            if (regex_data->matches[n].number_submatch == 0)
-            {
-                top_match = 1;
-            }
-            else
-            {
-                converted_replace_substring = __SUBSTITUTE_STRING(converted_replace_substring, temp_string_1, regex_data->matches[n].string, REPLACE_NO_BRACKETS, REPLACE_GLOBAL, 0); 
-            }
-        }
-        if (top_match == 1)
-        {
-            converted_replace_substring = __SUBSTITUTE_STRING(converted_replace_substring, temp_string_1, "", REPLACE_NO_BRACKETS, REPLACE_GLOBAL, 0);
-        }
+    if (classes == NULL)
+    {
+        parser->failed = 1;
+        return -1;
     }
 
-    __FREE(temp_string_1);
-    __FREE(temp_string_2);
+    program->classes = classes;
+    memset(program->classes + (size_t)program->num_classes * REGEX_PIKE_CLASS_SIZE, 0, REGEX_PIKE_CLASS_SIZE);
 
-    return converted_replace_substring;
+    return program->num_classes++;
 }
 
-/* (Intenal) Concatinates substrings of option flag names to the option falgs string */
-static char* _PRINT__CONCAT_OPTION_FLAGS(RegEx regex_data)
+/* (Internal) Adds the characters of a character class name like "alpha" to a bracket expression, returns 0 for an unknown name. */
+static int _PIKE__ADD_POSIX_CLASS(unsigned char* class_set, char* name, int length)
 {
-    char* option_flags_string = __MALLOC(128 * sizeof(char));
-    strcpy(option_flags_string, "");
+    static const char* NAMES[12] = {
+        "alpha", "digit", "alnum", "upper", "lower", "space",
+        "blank", "punct", "print", "graph", "cntrl", "xdigit"
+    };
+    int i;
+    int c;
+    int is_member = 0;
 
-    if (regex_data->flags.GLOBAL == 1)
-    {
-        strcpy(option_flags_string, "REG_GLOBAL");
-    }
-    if (regex_data->flags.EXTENDED == 1)
+    for (i = 0; i < 12; i++)
     {
-        if (strcmp(option_flags_string, ""))
+        if ((int)strlen(NAMES[i]) == length && strncmp(name, NAMES[i], length) == 0)
         {
-            strcat(option_flags_string, " | ");
+            break;
         }
-        strcat(option_flags_string, "REG_EXTENDED");
     }
-    if (regex_data->flags.ICASE == 1)
+
+    if (i == 12)
     {
-        if (strcmp(option_flags_string, ""))
-        {
-            strcat(option_flags_string, " | ");
-        }
-        strcat(option_flags_string, "REG_ICASE");
+        return 0;
     }
-    if (regex_data->flags.MULTILINE == 1)
+
+    for (c = 0; c < 256; c++)
     {
-        if (strcmp(option_flags_string, ""))
+        switch (i)
         {
-            strcat(option_flags_string, " | ");
+            case 0: is_member = isalpha(c); break;
+            case 1: is_member = isdigit(c); break;
+            case 2: is_member = isalnum(c); break;
+            case 3: is_member = isupper(c); break;
+            case 4: is_member = islower(c); break;
+            case 5: is_member = isspace(c); break;
+            case 6: is_member = (c == ' ' || c == '\t'); break;
+            case 7: is_member = ispunct(c); break;
+            case 8: is_member = isprint(c); break;
+            case 9: is_member = isgraph(c); break;
+            case 10: is_member = iscntrl(c); break;
+            case 11: is_member = isxdigit(c); break;
         }
-        strcat(option_flags_string, "REG_MULTILINE");
-    }
-    if (regex_data->flags.NEWLINE == 1)
-    {
-        if (strcmp(option_flags_string, ""))
+
+        if (is_member)
         {
-            strcat(option_flags_string, " | ");
+            class_set[c >> 3] |= (unsigned char)(1 << (c & 7));
         }
-        strcat(option_flags_string, "REG_NEWLINE");
     }
-    if (regex_data->flags.NOSUB == 1)
+
+    return 1;
+}
+
+/* (Internal) Completes a bracket expression with REG_ICASE, a negation and REG_NEWLINE, returns its instruction node. */
+static int _PIKE__CLASS_NODE(cregpike_parser_t* parser, int class_index, int negate)
+{
+    unsigned char* class_set;
+    int c;
+
+    if (parser->failed == 1)
     {
-        if (strcmp(option_flags_string, ""))
-        {
-            strcat(option_flags_string, " | ");
-        }
-        strcat(option_flags_string, "!(REG_NOSUB)");
+        return -1;
     }
-    if (regex_data->flags.NOSUBEXP == 1)
+
+    class_set = parser->program->classes + (size_t)class_index * REGEX_PIKE_CLASS_SIZE;
+
+    /* a character matches in both cases with REG_ICASE */
+    if (parser->icase == 1)
     {
-        if (strcmp(option_flags_string, ""))
+        for (c = 0; c < 256; c++)
         {
-            strcat(option_flags_string, " | ");
+            if (class_set[c >> 3] & (1 << (c & 7)))
+            {
+                class_set[tolower(c) >> 3] |= (unsigned char)(1 << (tolower(c) & 7));
+                class_set[toupper(c) >> 3] |= (unsigned char)(1 << (toupper(c) & 7));
+            }
         }
-        strcat(option_flags_string, "REG_NOSUBEXP");
     }
-    if (regex_data->flags.SUBEXP == 1)
+
+    if (negate == 1)
     {
-        if (strcmp(option_flags_string, ""))
+        for (c = 0; c < REGEX_PIKE_CLASS_SIZE; c++)
         {
-            strcat(option_flags_string, " | ");
+            class_set[c] = (unsigned char)~class_set[c];
+        }
+
+        /* a negated list does not match a newline character with REG_NEWLINE */
+        if (parser->program->newline == 1)
+        {
+            class_set['\n' >> 3] &= (unsigned char)~(1 << ('\n' & 7));
         }
-        strcat(option_flags_string, "REG_SUBEXP");
     }
 
-    return option_flags_string;
+    return _PIKE__NODE(parser, REGEX_PIKE_NODE_INSTRUCTION, REGEX_PIKE_CLASS, class_index, -1);
 }
 
-/* (Internal) Processes the input text string for printing or writing  */
-static char* _PRINT__GET_TEXT_STRING(RegEx regex_data)
+/* (Internal) Returns the instruction node of a literal character, a bracket expression of both cases with REG_ICASE. */
+static int _PIKE__CHARACTER_NODE(cregpike_parser_t* parser, int c)
 {
-    char* text_string;
-    char* temp_string;
+    int class_index;
 
-    if (MAX_PRINT_TEXT_LENGTH > 0)
+    if (parser->icase == 1 && tolower(c) != toupper(c))
     {
-        text_string = __MALLOC((MAX_PRINT_TEXT_LENGTH + 512) * sizeof(char));
-        temp_string = __MALLOC((MAX_PRINT_TEXT_LENGTH + 512) * sizeof(char));
-
-        if (strlen(regex_data->text) > MAX_PRINT_TEXT_LENGTH)
+        if ((class_index = _PIKE__NEW_CLASS(parser)) < 0)
         {
-            memcpy(temp_string, regex_data->text, MAX_PRINT_TEXT_LENGTH * sizeof(char));
-        }
-        else
-        {
-            memcpy(temp_string, regex_data->text, strlen(regex_data->text) * sizeof(char));
+            return -1;
         }
+
+        parser->program->classes[(size_t)class_index * REGEX_PIKE_CLASS_SIZE + (c >> 3)] |= (unsigned char)(1 << (c & 7));
+
+        return _PIKE__CLASS_NODE(parser, class_index, 0);
     }
-    else
+
+    return _PIKE__NODE(parser, REGEX_PIKE_NODE_INSTRUCTION, REGEX_PIKE_CHAR, c, -1);
+}
+
+/* (Internal) Parses a bracket expression after its "[", collating elements and equivalence classes are not supported. */
+static int _PIKE__PARSE_BRACKET(cregpike_parser_t* parser)
+{
+    char* pattern = parser->pattern;
+    unsigned char* class_set;
+    char* name_end;
+    int class_index = _PIKE__NEW_CLASS(parser);
+    int negate = 0;
+    int first = 1;
+    int c;
+    int last;
+
+    if (class_index < 0)
+    {
+        return -1;
+    }
+
+    if (pattern[parser->position] == '^')
     {
-        text_string = __MALLOC((MAX_TEXT_LENGTH + 512) * sizeof(char));
-        temp_string = __MALLOC((MAX_TEXT_LENGTH + 512) * sizeof(char));
+        negate = 1;
+        parser->position++;
     }
 
-    if (MAX_PRINT_TEXT_LENGTH > 0 && (strlen(regex_data->text) > MAX_PRINT_TEXT_LENGTH))
+    while (1)
     {
-        if (PRINT_COLORED == 1)
+        class_set = parser->program->classes + (size_t)class_index * REGEX_PIKE_CLASS_SIZE;
+        c = (unsigned char)pattern[parser->position];
+
+        /* a "]" at the list start is a literal character */
+        if (c == '\0' || (c == '[' && (pattern[parser->position + 1] == '.' || pattern[parser->position + 1] == '=')))
         {
-            sprintf(text_string, "\033[34mText (first %d characters):\033[0m\n", MAX_PRINT_TEXT_LENGTH);
+            parser->failed = 1;
+            return -1;
         }
-        else
+        else if (c == ']' && first == 0)
         {
-            sprintf(text_string, "Text (first %d characters):\n", MAX_PRINT_TEXT_LENGTH);
+            parser->position++;
+            break;
         }
-        
-        temp_string[MAX_PRINT_TEXT_LENGTH] = '\0';
 
-        if (PRINT_COLORED == 1)
-        {
-            strcat(temp_string, "\033[90m[...]\n[...]\033[0m");
-        }
-        else
+        first = 0;
+
+        if (c == '[' && pattern[parser->position + 1] == ':')
         {
-            strcat(temp_string, "[...]\n[...]");
+            name_end = strstr(pattern + parser->position + 2, ":]");
+
+            if (name_end == NULL || _PIKE__ADD_POSIX_CLASS(class_set, pattern + parser->position + 2, (int)(name_end - pattern) - parser->position - 2) == 0)
+            {
+                parser->failed = 1;
+                return -1;
+            }
+
+            parser->position = (int)(name_end - pattern) + 2;
+            continue;
         }
 
-        strcat(text_string, temp_string);
-    }
-    else
-    {
-        text_string = __REALLOC(text_string, (MAX_TEXT_LENGTH + 512) * sizeof(char));
+        parser->position++;
 
-        if (PRINT_COLORED == 1)
+        /* range, a "-" before the closing "]" is a literal character */
+        if (pattern[parser->position] == '-' && pattern[parser->position + 1] != ']' && pattern[parser->position + 1] != '\0')
         {
-            sprintf(text_string, "\033[34mText:\033[0m\n");
+            last = (unsigned char)pattern[parser->position + 1];
+
+            if (last == '[' || last < c)
+            {
+                parser->failed = 1;
+                return -1;
+            }
+
+            parser->position += 2;
         }
         else
         {
-            sprintf(text_string, "Text:\n");
+            last = c;
         }
-        
-        strcat(text_string, regex_data->text);
-    }
 
-    if (PRINT_COLORED == 1)
-    {
-        sprintf(temp_string, "%s\n\n\033[36mString-length:\033[0m    %d\n\n", text_string, (int)strlen(regex_data->text));
+        for (; c <= last; c++)
+        {
+            class_set[c >> 3] |= (unsigned char)(1 << (c & 7));
+        }
     }
-    else
+
+    return _PIKE__CLASS_NODE(parser, class_index, negate);
+}
+
+/* (Internal) Returns the node of a "\w", "\W", "\s" or "\S" class escape. */
+static int _PIKE__ESCAPE_CLASS_NODE(cregpike_parser_t* parser, int escape)
+{
+    unsigned char* class_set;
+    int class_index = _PIKE__NEW_CLASS(parser);
+    int c;
+
+    if (class_index < 0)
     {
-        sprintf(temp_string, "%s\n\nString-length:    %d\n\n", text_string, (int)strlen(regex_data->text));
+        return -1;
     }
-   
-    strcpy(text_string, temp_string);
 
-    if (MAX_PRINT_TEXT_LENGTH > 0)
+    class_set = parser->program->classes + (size_t)class_index * REGEX_PIKE_CLASS_SIZE;
+
+    for (c = 0; c < 256; c++)
     {
-        text_string = __REALLOC(text_string, (MAX_PRINT_TEXT_LENGTH + MAX_FILENAME_LENGTH + 512) * sizeof(char));
+        if ((tolower(escape) == 'w') ? (isalnum(c) || c == '_') : isspace(c))
+        {
+            class_set[c >> 3] |= (unsigned char)(1 << (c & 7));
+        }
     }
-    else
+
+    /* the complement classes also match a newline character */
+    if (isupper(escape))
     {
-        text_string = __REALLOC(text_string, (MAX_TEXT_LENGTH + MAX_FILENAME_LENGTH + 512) * sizeof(char));
+        for (c = 0; c < REGEX_PIKE_CLASS_SIZE; c++)
+        {
+            class_set[c] = (unsigned char)~class_set[c];
+        }
     }
 
-    __FREE(temp_string);
-
-    return text_string;
+    return _PIKE__NODE(parser, REGEX_PIKE_NODE_INSTRUCTION, REGEX_PIKE_CLASS, class_index, -1);
 }
 
-/* (Internal) Processes the data string of the RegEx Object for printing or writing  */
-static char* _PRINT__GET_REGEX_STATS(RegEx regex_data, char* option_flags_string)
+/* (Internal) Parses a parenthesized expression, a bracket expression, an anchor, an escape or a literal character. */
+static int _PIKE__PARSE_ATOM(cregpike_parser_t* parser)
 {
-    char* regex_data_string = __MALLOC((MAX_PATTERN_LENGTH + 512) * sizeof(char));
-    char* temp_string = __MALLOC((MAX_PATTERN_LENGTH + 256) * sizeof(char));
-    char* filename_string;
+    int c = (unsigned char)parser->pattern[parser->position];
+    int number_group;
+    int child;
 
-    strcpy(temp_string, regex_data->pattern);
-    temp_string = __SUBSTITUTE_STRING(temp_string, "\r", "\\r", REPLACE_NO_BRACKETS, REPLACE_GLOBAL, 0);
-    temp_string = __SUBSTITUTE_STRING(temp_string, "\n", "\\n", REPLACE_NO_BRACKETS, REPLACE_GLOBAL, 0);
+    parser->position++;
 
-    if (PRINT_COLORED == 1)
+    switch (c)
     {
-        sprintf(regex_data_string, "\
-\033[34mRegex-Pattern:\033[0m    %s\n\
-\033[36mRegex-Flags:\033[0m      %s\n\
-\033[36mSub-Expressions:\033[0m  %d\n\
-\033[36mTotal Matches:\033[0m    %d\n\
-\033[36mReturn Code:\033[0m      %i\n\
-\033[36mError Message:\033[0m    %s\n\n",
-temp_string,
-option_flags_string,
-regex_data->num_pattern_subexpr,
-regex_data->num_matches,
-regex_data->return_code,
-regex_data->error_message);
+        case '(':
+            number_group = ++parser->num_groups;
+            parser->depth++;
+            child = _PIKE__PARSE_ALTERNATION(parser);
+
+            if (parser->failed == 1 || parser->pattern[parser->position] != ')')
+            {
+                parser->failed = 1;
+                return -1;
+            }
+
+            parser->position++;
+            parser->depth--;
+
+            return _PIKE__NODE(parser, REGEX_PIKE_NODE_GROUP, 0, number_group, child);
+
+        case '[':
+            return _PIKE__PARSE_BRACKET(parser);
+
+        case '.':
+            return _PIKE__NODE(parser, REGEX_PIKE_NODE_INSTRUCTION, REGEX_PIKE_ANY, 0, -1);
+
+        case '^':
+            return _PIKE__NODE(parser, REGEX_PIKE_NODE_INSTRUCTION, REGEX_PIKE_LINE_START, 0, -1);
+
+        case '$':
+            return _PIKE__NODE(parser, REGEX_PIKE_NODE_INSTRUCTION, REGEX_PIKE_LINE_END, 0, -1);
+
+        case '*':
+        case '+':
+        case '?':
+        case '{':
+        case '\0':
+            /* repetition without an expression */
+            parser->failed = 1;
+            return -1;
+
+        case '\\':
+            c = (unsigned char)parser->pattern[parser->position];
+
+            if (c == '\0' || (c >= '1' && c <= '9'))
+            {
+                /* back-references need the backtracking of regexec() */
+                parser->failed = 1;
+                return -1;
+            }
+
+            parser->position++;
+
+            switch (c)
+            {
+                case 'b': return _PIKE__NODE(parser, REGEX_PIKE_NODE_INSTRUCTION, REGEX_PIKE_WORD_BOUNDARY, 0, -1);
+                case 'B': return _PIKE__NODE(parser, REGEX_PIKE_NODE_INSTRUCTION, REGEX_PIKE_NOT_WORD_BOUNDARY, 0, -1);
+                case '<': return _PIKE__NODE(parser, REGEX_PIKE_NODE_INSTRUCTION, REGEX_PIKE_WORD_START, 0, -1);
+                case '>': return _PIKE__NODE(parser, REGEX_PIKE_NODE_INSTRUCTION, REGEX_PIKE_WORD_END, 0, -1);
+                case '`': return _PIKE__NODE(parser, REGEX_PIKE_NODE_INSTRUCTION, REGEX_PIKE_BUFFER_START, 0, -1);
+                case '\'': return _PIKE__NODE(parser, REGEX_PIKE_NODE_INSTRUCTION, REGEX_PIKE_BUFFER_END, 0, -1);
+                case 'w':
+                case 'W':
+                case 's':
+                case 'S':
+                    return _PIKE__ESCAPE_CLASS_NODE(parser, c);
+                default:
+                    return _PIKE__CHARACTER_NODE(parser, c);
+            }
+
+        default:
+            return _PIKE__CHARACTER_NODE(parser, c);
     }
-    else
+}
+
+/* (Internal) Parses the number of a repetition interval, returns -1 without digits. */
+static int _PIKE__PARSE_NUMBER(cregpike_parser_t* parser)
+{
+    int number = -1;
+
+    while (isdigit((unsigned char)parser->pattern[parser->position]))
     {
-        sprintf(regex_data_string, "\
-Regex-Pattern:    %s\n\
-Regex-Flags:      %s\n\
-Sub-Expressions:  %d\n\
-Total Matches:    %d\n\
-Return Code:      %i\n\
-Error Message:    %s\n\n",
-temp_string,
-option_flags_string,
-regex_data->num_pattern_subexpr,
-regex_data->num_matches,
-regex_data->return_code,
-regex_data->error_message);
+        number = (number < 0 ? 0 : number * 10) + (parser->pattern[parser->position] - '0');
+        parser->position++;
+
+        if (number > RE_DUP_MAX)
+        {
+            parser->failed = 1;
+            return -1;
+        }
     }
 
-    if (regex_data->file != NULL && regex_data->file->length > 0)
+    return number;
+}
+
+/* (Internal) Parses an atom and its repetition operators "*", "+", "?" and "{m,n}". */
+static int _PIKE__PARSE_PIECE(cregpike_parser_t* parser)
+{
+    int node = _PIKE__PARSE_ATOM(parser);
+    int min;
+    int max;
+    int c;
+
+    while (parser->failed == 0)
     {
-        filename_string = __MALLOC((MAX_FILENAME_LENGTH) * sizeof(char));
-        regex_data_string = __REALLOC(regex_data_string, (MAX_FILENAME_LENGTH + MAX_PATTERN_LENGTH + 512) * sizeof(char));
+        c = parser->pattern[parser->position];
 
-        /* shift and prepend */
-        if (PRINT_COLORED == 1)
+        if (c == '*' || c == '+' || c == '?')
         {
-            sprintf(filename_string, "\033[36mFilename:\033[0m         %s\n\n", regex_data->file->name);
+            parser->position++;
+            min = (c == '+');
+            max = (c == '?') ? 1 : -1;
+        }
+        else if (c == '{')
+        {
+            parser->position++;
+            min = _PIKE__PARSE_NUMBER(parser);
+            max = min;
+
+            if (parser->pattern[parser->position] == ',')
+            {
+                parser->position++;
+                max = _PIKE__PARSE_NUMBER(parser);
+            }
+
+            /* "{,n}" is "{0,n}" */
+            if (min < 0)
+            {
+                min = 0;
+            }
+
+            if (parser->pattern[parser->position] != '}' || (max >= 0 && max < min))
+            {
+                parser->failed = 1;
+                return -1;
+            }
+
+            parser->position++;
         }
         else
         {
-            sprintf(filename_string, "Filename:         %s\n\n", regex_data->file->name);
+            break;
+        }
+
+        node = _PIKE__NODE(parser, REGEX_PIKE_NODE_REPEAT, 0, 0, node);
+
+        if (node >= 0)
+        {
+            parser->nodes[node].min = min;
+            parser->nodes[node].max = max;
         }
-        
-        memmove(regex_data_string + strlen(filename_string), regex_data_string, strlen(regex_data_string) + 1);
-        memcpy(regex_data_string, filename_string, strlen(filename_string));
     }
 
-    __FREE(option_flags_string);
-    __FREE(temp_string);
+    return node;
+}
 
-    return regex_data_string;
+/* (Internal) Parses a concatenation of pieces until "|", a closing ")" or the pattern end. */
+static int _PIKE__PARSE_SEQUENCE(cregpike_parser_t* parser)
+{
+    int node = _PIKE__NODE(parser, REGEX_PIKE_NODE_SEQUENCE, 0, 0, -1);
+    int last = -1;
+    int piece;
+    char c;
+
+    while (parser->failed == 0)
+    {
+        c = parser->pattern[parser->position];
+
+        /* an unmatched ")" is a literal character */
+        if (c == '\0' || c == '|' || (c == ')' && parser->depth > 0))
+        {
+            break;
+        }
+
+        if ((piece = _PIKE__PARSE_PIECE(parser)) < 0)
+        {
+            return -1;
+        }
+
+        if (last < 0)
+        {
+            parser->nodes[node].child = piece;
+        }
+        else
+        {
+            parser->nodes[last].next = piece;
+        }
+
+        last = piece;
+    }
+
+    return node;
 }
 
-/* (Internal) Processes the result data string of the RegEx Object for printing or writing  */
-static char* _PRINT__GET_RESULTS(RegEx regex_data, int PRINT_LAYOUT, int print_header, int print_position)
+/* (Internal) Parses alternatives separated by "|". */
+static int _PIKE__PARSE_ALTERNATION(cregpike_parser_t* parser)
 {
-    int i;
-    char temp_str_buffer[4][32];
-    char PRINTF_FORMAT_STR[64];
-    char* result_string = __MALLOC(256 * sizeof(char));
-    char* output_string = __MALLOC(256 * sizeof(char));
-    char* substring = __MALLOC(256 * sizeof(char));
-    
-    strcpy(result_string, "");
-    
-    if (regex_data->num_matches > 0)
+    int node = _PIKE__NODE(parser, REGEX_PIKE_NODE_ALTERNATION, 0, 0, -1);
+    int last = -1;
+    int sequence;
+
+    while (parser->failed == 0)
     {
-        if (print_header == 1)
+        if ((sequence = _PIKE__PARSE_SEQUENCE(parser)) < 0)
         {
-            if (PRINT_COLORED == 1)
-            {
-                sprintf(result_string, "\033[34mResults:\033[0m\n");
-            }
-            else
-            {
-                sprintf(result_string, "Results:\n");
-            }
+            return -1;
         }
-        if (PRINT_LAYOUT == REGEX_PRINT_CSV)
+
+        if (last < 0)
         {
-            if (print_position)
+            parser->nodes[node].child = sequence;
+        }
+        else
+        {
+            parser->nodes[last].next = sequence;
+        }
+
+        last = sequence;
+
+        if (parser->pattern[parser->position] != '|')
+        {
+            break;
+        }
+
+        parser->position++;
+    }
+
+    return node;
+}
+
+/* (Internal) Appends an instruction to the Pike VM program, returns its index or -1 if the program is too large. */
+static int _PIKE__EMIT(cregpike_parser_t* parser, int opcode, int arg, int arg2)
+{
+    cregpike_t* program = parser->program;
+    cregpike_instruction_t* instructions;
+    int capacity;
+
+    if (parser->failed == 1 || program->num_instructions == REGEX_PIKE_MAX_INSTRUCTIONS)
+    {
+        parser->failed = 1;
+        return -1;
+    }
+
+    if (program->num_instructions == program->instruction_capacity)
+    {
+        capacity = program->instruction_capacity > 0 ? program->instruction_capacity * 2 : 64;
+        instructions = __TRY_REALLOC(program->instructions, (size_t)capacity * sizeof(cregpike_instruction_t));
+
+        if (instructions == NULL)
+        {
+            parser->failed = 1;
+            return -1;
+        }
+
+        program->instructions = instructions;
+        program->instruction_capacity = capacity;
+    }
+
+    program->instructions[program->num_instructions].opcode = opcode;
+    program->instructions[program->num_instructions].arg = arg;
+    program->instructions[program->num_instructions].arg2 = arg2;
+
+    return program->num_instructions++;
+}
+
+/* (Internal) Appends the instructions of a syntax tree node to the Pike VM program. */
+static void _PIKE__EMIT_NODE(cregpike_parser_t* parser, int node_index)
+{
+    cregpike_node_t* node = &parser->nodes[node_index];
+    cregpike_instruction_t* instructions;
+    int opcode = node->opcode;
+    int child;
+    int split = -1;
+    int jumps = -1;
+    int loop;
+    int i;
+
+    switch (node->type)
+    {
+        case REGEX_PIKE_NODE_INSTRUCTION:
+            /* the reversed pattern reads the text backwards, so the anchors of a start and of an end are swapped */
+            if (parser->reverse == 1)
             {
-                if (PRINT_COLORED == 1)
+                switch (node->opcode)
                 {
-                    strcat(result_string, "\033[36mnumber;match;submatch;start;end;substring;\033[0m\n");
-                }
-                else
-                {
-                    strcat(result_string, "number;match;submatch;start;end;substring;\n");
+                    case REGEX_PIKE_LINE_START:
+                        opcode = REGEX_PIKE_LINE_END;
+                        break;
+                    case REGEX_PIKE_LINE_END:
+                        opcode = REGEX_PIKE_LINE_START;
+                        break;
+                    case REGEX_PIKE_WORD_START:
+                        opcode = REGEX_PIKE_WORD_END;
+                        break;
+                    case REGEX_PIKE_WORD_END:
+                        opcode = REGEX_PIKE_WORD_START;
+                        break;
+                    case REGEX_PIKE_BUFFER_START:
+                        opcode = REGEX_PIKE_BUFFER_END;
+                        break;
+                    case REGEX_PIKE_BUFFER_END:
+                        opcode = REGEX_PIKE_BUFFER_START;
+                        break;
                 }
             }
-            else
+
+            _PIKE__EMIT(parser, opcode, node->arg, 0);
+            break;
+
+        case REGEX_PIKE_NODE_SEQUENCE:
+            if (parser->reverse == 1)
             {
-                if (PRINT_COLORED == 1)
-                {
-                    strcat(result_string, "\033[36mnumber;match;submatch;substring;\033[0m\n");
-                }
-                else
-                {
-                    strcat(result_string, "number;match;submatch;substring;\n");
-                }
-            }       
-        }
-        if (PRINT_LAYOUT == REGEX_PRINT_TABLE)
-        {
-            /* count number of digits to set space holder */
-            sprintf(temp_str_buffer[0], "%d", regex_data->matches[regex_data->num_matches-1].end);
-            
-            if (print_position)
+                node->child = _PIKE__REVERSE_LIST(parser, node->child);
+            }
+
+            for (child = node->child; child >= 0 && parser->failed == 0; child = parser->nodes[child].next)
             {
-                if (PRINT_COLORED == 1)
-                {
-                    sprintf(output_string, "\033[36m#   Match   Submatch    Start  %*sEnd     Substring\033[0m\n", (int)strlen(temp_str_buffer[0]), " ");
-                }
-                else
-                {
-                    sprintf(output_string, "#   Match   Submatch    Start  %*sEnd     Substring\n", (int)strlen(temp_str_buffer[0]), " ");
-                }
+                _PIKE__EMIT_NODE(parser, child);
             }
-            else
+
+            /* the list is restored for the next iteration of a repetition */
+            if (parser->reverse == 1)
+            {
+                node->child = _PIKE__REVERSE_LIST(parser, node->child);
+            }
+            break;
+
+        case REGEX_PIKE_NODE_ALTERNATION:
+            /* split to each alternative in order, the jumps to the end are linked by their targets until the end is known */
+            for (child = node->child; child >= 0 && parser->failed == 0; child = parser->nodes[child].next)
             {
-                if (PRINT_COLORED == 1)
+                if (parser->nodes[child].next >= 0)
                 {
-                    sprintf(output_string, "\033[36m#   Match   Submatch     Substring\033[0m\n");
+                    split = _PIKE__EMIT(parser, REGEX_PIKE_SPLIT, parser->program->num_instructions + 1, 0);
                 }
-                else
+
+                _PIKE__EMIT_NODE(parser, child);
+
+                if (parser->nodes[child].next >= 0 && parser->failed == 0)
                 {
-                    sprintf(output_string, "#   Match   Submatch     Substring\n");
+                    jumps = _PIKE__EMIT(parser, REGEX_PIKE_JUMP, jumps, 0);
+                    parser->program->instructions[split].arg2 = parser->program->num_instructions;
                 }
             }
 
-            strcat(result_string, output_string);
-        }
-        if (PRINT_LAYOUT == REGEX_PRINT_JSON)
-        {
-            output_string = __REALLOC(output_string, (MAX_PATTERN_LENGTH + 256) * sizeof(char));
-            result_string = __REALLOC(result_string, (MAX_PATTERN_LENGTH + 256) * sizeof(char));
-            substring = __REALLOC(substring, (MAX_PATTERN_LENGTH + 256) * sizeof(char));
-            /* temporary: use substring for pattern substitution */
-            strcpy(substring, regex_data->pattern);
-            substring = __SUBSTITUTE_STRING(substring, "\r", "\\r", REPLACE_NO_BRACKETS, REPLACE_GLOBAL, 0);
-            substring = __SUBSTITUTE_STRING(substring, "\n", "\\n", REPLACE_NO_BRACKETS, REPLACE_GLOBAL, 0);
-            substring = __SUBSTITUTE_STRING(substring, "\\", "\\\\", REPLACE_NO_BRACKETS, REPLACE_GLOBAL, 0);
+            for (instructions = parser->program->instructions; jumps >= 0 && parser->failed == 0; jumps = i)
+            {
+                i = instructions[jumps].arg;
+                instructions[jumps].arg = parser->program->num_instructions;
+            }
+            break;
 
-            if (PRINT_COLORED == 1)
+        case REGEX_PIKE_NODE_GROUP:
+            /* the reverse DFA has no capture slots */
+            if (parser->reverse == 1)
             {
-                sprintf(output_string, "{\n\
-\t\033[36m\"text-length\":\033[0m %d\033[90m,\033[0m\n\
-\t\033[36m\"regular expression\":\033[0m \"%s\"\033[90m,\033[0m\n\
-\t\033[36m\"sub-expressions\":\033[0m %d\033[90m,\033[0m\n\
-\t\033[36m\"total matches\":\033[0m %d\033[90m,\033[0m\n\
-\t\033[36m\"matches\":\033[0m",
-                (int)strlen(regex_data->text),
-                substring,
-                regex_data->num_pattern_subexpr,
-                regex_data->num_matches);
-                strcat(output_string, " [\n");
-                strcat(result_string, output_string);
+                _PIKE__EMIT_NODE(parser, node->child);
+                break;
             }
-            else
+
+            _PIKE__EMIT(parser, REGEX_PIKE_SAVE, 2 * node->arg, 0);
+            _PIKE__EMIT_NODE(parser, node->child);
+            _PIKE__EMIT(parser, REGEX_PIKE_SAVE, 2 * node->arg + 1, 0);
+            break;
+
+        case REGEX_PIKE_NODE_REPEAT:
+            /* the required iterations, the last one of an unlimited repetition is the loop body */
+            for (i = (node->max < 0) ? 1 : 0; i < node->min && parser->failed == 0; i++)
             {
-                sprintf(output_string, "{\n\
-\t\"text-length\": %d,\n\
-\t\"regular expression\": \"%s\",\n\
-\t\"sub-expressions\": %d,\n\
-\t\"total matches\": %d,\n\
-\t\"matches\":",
-                (int)strlen(regex_data->text),
-                substring,
-                regex_data->num_pattern_subexpr,
-                regex_data->num_matches);
-                strcat(output_string, " [\n");
-                strcat(result_string, output_string);
+                _PIKE__EMIT_NODE(parser, node->child);
             }
-        }
 
-        for (i = 0; i < regex_data->num_matches; i++)
-        {
-            /* substitute newline characters in substring */
-            substring = __REALLOC(substring, (strlen(regex_data->matches[i].string) + 256) * sizeof(char));
-            strcpy(substring, regex_data->matches[i].string);
-            substring = __SUBSTITUTE_STRING(substring, "\r", "\\r", REPLACE_NO_BRACKETS, REPLACE_GLOBAL, 0);
-            substring = __SUBSTITUTE_STRING(substring, "\n", "\\n", REPLACE_NO_BRACKETS, REPLACE_GLOBAL, 0);
-
-            if (PRINT_LAYOUT == REGEX_PRINT_TABLE)
+            if (node->max < 0)
             {
-                /* set placeholders for #   Match   Submatch */
-                if (i < 9)
-                {
-                    strcpy(PRINTF_FORMAT_STR, "%d    %4d       %4d");
-                }
-                if (i >= 9)
-                {
-                    strcpy(PRINTF_FORMAT_STR, "%d   %4d       %4d");
-                }
-                if (i >= 99)
+                /* "x*" is "(x+)?", so an empty iteration reaches the end before the loop is left like with regexec() */
+                split = (node->min == 0) ? _PIKE__EMIT(parser, REGEX_PIKE_SPLIT, parser->program->num_instructions + 1, 0) : -1;
+                loop = parser->program->num_instructions;
+                _PIKE__EMIT_NODE(parser, node->child);
+                _PIKE__EMIT(parser, REGEX_PIKE_SPLIT, loop, parser->program->num_instructions + 1);
+
+                if (split >= 0 && parser->failed == 0)
                 {
-                    strcpy(PRINTF_FORMAT_STR, "%d  %4d       %4d");
+                    parser->program->instructions[split].arg2 = parser->program->num_instructions;
                 }
-                if (i >= 999)
+                break;
+            }
+
+            /* the optional iterations split to the end, linked by their targets until the end is known */
+            for (i = node->min; i < node->max && parser->failed == 0; i++)
+            {
+                jumps = _PIKE__EMIT(parser, REGEX_PIKE_SPLIT, parser->program->num_instructions + 1, jumps);
+                _PIKE__EMIT_NODE(parser, node->child);
+            }
+
+            for (instructions = parser->program->instructions; jumps >= 0 && parser->failed == 0; jumps = i)
+            {
+                i = instructions[jumps].arg2;
+                instructions[jumps].arg2 = parser->program->num_instructions;
+            }
+            break;
+    }
+}
+
+/* (Internal) Reverses the child list of a sequence node, returns the new first child. */
+static int _PIKE__REVERSE_LIST(cregpike_parser_t* parser, int first_child)
+{
+    int previous = -1;
+    int child = first_child;
+    int next;
+
+    while (child >= 0)
+    {
+        next = parser->nodes[child].next;
+        parser->nodes[child].next = previous;
+        previous = child;
+        child = next;
+    }
+
+    return previous;
+}
+
+/* (Internal) Compiles the syntax tree of a single-line pattern reversed for the reverse DFA, returns NULL without memory. */
+static cregpike_t* _PIKE__COMPILE_REVERSE(cregpike_parser_t* parser, int root)
+{
+    cregpike_t* program = parser->program;
+    cregpike_t* reverse;
+    const size_t CLASSES_SIZE = (size_t)program->num_classes * REGEX_PIKE_CLASS_SIZE;
+
+    if ((reverse = __TRY_MALLOC(sizeof(cregpike_t))) == NULL)
+    {
+        return NULL;
+    }
+
+    reverse->instructions = NULL;
+    reverse->num_instructions = 0;
+    reverse->instruction_capacity = 0;
+    reverse->classes = (CLASSES_SIZE > 0) ? __TRY_MALLOC(CLASSES_SIZE) : NULL;
+    reverse->num_classes = program->num_classes;
+    reverse->num_captures = 2;
+    reverse->newline = program->newline;
+    reverse->reverse = NULL;
+    reverse->reversed = 1;
+    reverse->serial = 0;
+
+    if (CLASSES_SIZE > 0 && reverse->classes == NULL)
+    {
+        _PIKE__FREE(reverse);
+        return NULL;
+    }
+
+    if (CLASSES_SIZE > 0)
+    {
+        memcpy(reverse->classes, program->classes, CLASSES_SIZE);
+    }
+
+    /* the bracket expressions keep their indices */
+    parser->program = reverse;
+    parser->reverse = 1;
+    _PIKE__EMIT_NODE(parser, root);
+    _PIKE__EMIT(parser, REGEX_PIKE_MATCH, 0, 0);
+    parser->program = program;
+    parser->reverse = 0;
+
+    if (parser->failed == 1)
+    {
+        _PIKE__FREE(reverse);
+        return NULL;
+    }
+
+    _PIKE__BYTE_CLASSES(reverse);
+
+    return reverse;
+}
+
+/* (Internal) Compiles a converted extended regular expression into a Pike VM program, returns NULL if the pattern is not supported. */
+static cregpike_t* _PIKE__COMPILE(char* converted_pattern_string, int reglib_flags, int num_pattern_subexpr)
+{
+    cregpike_parser_t parser;
+    cregpike_t* program;
+    int root;
+
+    /* basic regular expressions are searched by regexec() */
+    if ((reglib_flags & REG_EXTENDED) != REG_EXTENDED || (program = __TRY_MALLOC(sizeof(cregpike_t))) == NULL)
+    {
+        return NULL;
+    }
+
+    program->instructions = NULL;
+    program->num_instructions = 0;
+    program->instruction_capacity = 0;
+    program->classes = NULL;
+    program->num_classes = 0;
+    program->num_captures = 2 * (num_pattern_subexpr + 1);
+    program->newline = ((reglib_flags & REG_NEWLINE) == REG_NEWLINE);
+    program->reverse = NULL;
+    program->reversed = 0;
+    program->serial = 0;
+
+    /* each character of the pattern adds at most two nodes */
+    parser.pattern = converted_pattern_string;
+    parser.position = 0;
+    parser.depth = 0;
+    parser.num_groups = 0;
+    parser.icase = ((reglib_flags & REG_ICASE) == REG_ICASE);
+    parser.failed = 0;
+    parser.reverse = 0;
+    parser.num_nodes = 0;
+    parser.max_nodes = 2 * (int)strlen(converted_pattern_string) + 4;
+    parser.nodes = __TRY_MALLOC((size_t)parser.max_nodes * sizeof(cregpike_node_t));
+    parser.program = program;
+
+    if (parser.nodes == NULL)
+    {
+        __FREE(program);
+        return NULL;
+    }
+
+    root = _PIKE__PARSE_ALTERNATION(&parser);
+
+    /* the whole match is sub-expression 0 */
+    if (parser.failed == 0 && parser.pattern[parser.position] == '\0' && parser.num_groups == num_pattern_subexpr)
+    {
+        _PIKE__EMIT(&parser, REGEX_PIKE_SAVE, 0, 0);
+        _PIKE__EMIT_NODE(&parser, root);
+        _PIKE__EMIT(&parser, REGEX_PIKE_SAVE, 1, 0);
+        _PIKE__EMIT(&parser, REGEX_PIKE_MATCH, 0, 0);
+    }
+    else
+    {
+        parser.failed = 1;
+    }
+
+    if (parser.failed == 0)
+    {
+        _PIKE__BYTE_CLASSES(program);
+
+        /* the match start of a pattern without newline characters is searched backwards in a line, without memory it is searched forwards */
+        if (program->single_line == 1)
+        {
+            program->reverse = _PIKE__COMPILE_REVERSE(&parser, root);
+            parser.failed = 0;
+        }
+    }
+
+    __FREE(parser.nodes);
+
+    if (parser.failed == 1)
+    {
+        _PIKE__FREE(program);
+        return NULL;
+    }
+
+    _PIKE__LOCK();
+    program->serial = ++REGEX_PIKE_SERIAL;
+    _PIKE__UNLOCK();
+
+    return program;
+}
+
+/* (Internal) Frees a Pike VM program. */
+static void _PIKE__FREE(cregpike_t* program)
+{
+    if (program != NULL)
+    {
+        if (program->instructions != NULL)
+        {
+            __FREE(program->instructions);
+        }
+        if (program->classes != NULL)
+        {
+            __FREE(program->classes);
+        }
+        _PIKE__FREE(program->reverse);
+        __FREE(program);
+    }
+}
+
+/* (Internal) Initializes the workspace of a search, the memory is allocated by the first execution. */
+static void _PIKE__INIT_WORKSPACE(cregpike_workspace_t* workspace)
+{
+    workspace->memory = NULL;
+}
+
+/* (Internal) Frees the memory of a workspace. */
+static void _PIKE__FREE_WORKSPACE(cregpike_workspace_t* workspace)
+{
+    if (workspace->memory != NULL)
+    {
+        __FREE(workspace->memory);
+        workspace->memory = NULL;
+    }
+}
+
+/* (Internal) Allocates the thread lists of a workspace for a Pike VM program, returns REGEX_ERROR_MEMORY without memory. */
+static int _PIKE__ALLOC_WORKSPACE(cregpike_t* program, cregpike_workspace_t* workspace)
+{
+    const size_t NUM_INSTRUCTIONS = (size_t)program->num_instructions;
+    const size_t NUM_CAPTURES = (size_t)program->num_captures;
+    const size_t LIST_SIZE = NUM_INSTRUCTIONS * (4 + NUM_CAPTURES);
+    int* memory;
+    int i;
+
+    if (NUM_CAPTURES + 4 > (size_t)-1 / sizeof(int) / 4 / (NUM_INSTRUCTIONS + 1))
+    {
+        return REGEX_ERROR_MEMORY;
+    }
+
+    memory = __TRY_MALLOC((2 * LIST_SIZE + 2 * (2 * NUM_INSTRUCTIONS + 1) + 2 * NUM_CAPTURES) * sizeof(int));
+
+    if (memory == NULL)
+    {
+        return REGEX_ERROR_MEMORY;
+    }
+
+    workspace->memory = memory;
+
+    /* the keys of the sparse sets are the instructions, and the instructions without a character after a "$" */
+    for (i = 0; i < 2; i++)
+    {
+        workspace->lists[i].dense = memory + (size_t)i * LIST_SIZE;
+        workspace->lists[i].sparse = workspace->lists[i].dense + 2 * NUM_INSTRUCTIONS;
+        workspace->lists[i].captures = workspace->lists[i].sparse + 2 * NUM_INSTRUCTIONS;
+        workspace->lists[i].num_threads = 0;
+
+        /* the sparse set does not need initialized indices, only defined values */
+        memset(workspace->lists[i].sparse, 0, 2 * NUM_INSTRUCTIONS * sizeof(int));
+    }
+
+    workspace->stack = memory + 2 * LIST_SIZE;
+    workspace->seed = workspace->stack + 2 * (2 * NUM_INSTRUCTIONS + 1);
+    workspace->best = workspace->seed + NUM_CAPTURES;
+
+    return REGEX_MATCH_SUCCESS;
+}
+
+/* (Internal) Checks a position of a match against an anchor or a word boundary instruction,
+   returns 2 for a "$" before a newline character without REG_NEWLINE, which the match has to consume like regexec(). */
+static int _PIKE__ASSERT(cregpike_t* program, int opcode, char* text, int match_start, int position, int end, int eflags)
+{
+    const int PREVIOUS_WORD = (position > 0 && (isalnum((unsigned char)text[position - 1]) || text[position - 1] == '_'));
+    const int NEXT_WORD = (position < end && (isalnum((unsigned char)text[position]) || text[position] == '_'));
+
+    switch (opcode)
+    {
+        case REGEX_PIKE_LINE_START:
+            /* without REG_NEWLINE regexec() also matches "^" after a newline character of the match */
+            return (position == 0 && (eflags & REG_NOTBOL) == 0) ||
+                   (position > 0 && text[position - 1] == '\n' && (program->newline == 1 || position > match_start));
+        case REGEX_PIKE_LINE_END:
+            /* ... and "$" inside of a match before a newline character, which the match consumes */
+            if (position == end)
+            {
+                return (eflags & REG_NOTEOL) == 0;
+            }
+            return (text[position] != '\n') ? 0 : (program->newline == 1 ? 1 : (position > match_start ? 2 : 0));
+        case REGEX_PIKE_WORD_BOUNDARY:
+            return PREVIOUS_WORD != NEXT_WORD;
+        case REGEX_PIKE_NOT_WORD_BOUNDARY:
+            return PREVIOUS_WORD == NEXT_WORD;
+        case REGEX_PIKE_WORD_START:
+            return !PREVIOUS_WORD && NEXT_WORD;
+        case REGEX_PIKE_WORD_END:
+            return PREVIOUS_WORD && !NEXT_WORD;
+        case REGEX_PIKE_BUFFER_START:
+            return position == 0;
+        case REGEX_PIKE_BUFFER_END:
+            return position == end;
+    }
+
+    return 0;
+}
+
+/* (Internal) Adds a thread and the threads of its following jumps, splits, capture slots and assertions to a thread list. */
+static void _PIKE__ADD_THREAD(cregpike_t* program, cregpike_workspace_t* workspace, cregpike_list_t* list, int pc,
+                              int* captures, int num_captures, char* text, int position, int end, int eflags)
+{
+    cregpike_instruction_t* instruction;
+    int* stack = workspace->stack;
+    int top = 0;
+    int newline_state;   /* 1 after a "$" whose newline character has to be consumed */
+    int assertion;
+    int key;
+    int slot;
+
+    /* stack entries are an instruction with its newline state, or a capture slot -1 - n with its previous value */
+    stack[top++] = pc;
+    stack[top++] = 0;
+
+    while (top > 0)
+    {
+        top -= 2;
+        pc = stack[top];
+        newline_state = stack[top + 1];
+
+        if (pc < 0)
+        {
+            captures[-1 - pc] = newline_state;
+            continue;
+        }
+
+        while (1)
+        {
+            instruction = &program->instructions[pc];
+
+            /* a match cannot end before the newline character of its "$" */
+            if (instruction->opcode == REGEX_PIKE_MATCH && newline_state == 1)
+            {
+                break;
+            }
+
+            /* an instruction takes one thread per position, the one of the highest priority,
+               the instructions without a character take another one after a "$" */
+            key = (instruction->opcode < REGEX_PIKE_MATCH) ? pc : pc + newline_state * program->num_instructions;
+            slot = list->sparse[key];
+
+            if (slot < list->num_threads && list->dense[slot] == key)
+            {
+                break;
+            }
+
+            slot = list->num_threads++;
+            list->sparse[key] = slot;
+            list->dense[slot] = key;
+
+            if (instruction->opcode == REGEX_PIKE_JUMP)
+            {
+                pc = instruction->arg;
+            }
+            else if (instruction->opcode == REGEX_PIKE_SPLIT)
+            {
+                stack[top++] = instruction->arg2;
+                stack[top++] = newline_state;
+                pc = instruction->arg;
+            }
+            else if (instruction->opcode == REGEX_PIKE_SAVE)
+            {
+                if (instruction->arg < num_captures)
                 {
-                    strcpy(PRINTF_FORMAT_STR, "%d %4d       %4d");
+                    stack[top++] = -1 - instruction->arg;
+                    stack[top++] = captures[instruction->arg];
+                    captures[instruction->arg] = position;
                 }
+                pc++;
+            }
+            else if (instruction->opcode <= REGEX_PIKE_MATCH)
+            {
+                memcpy(list->captures + (size_t)pc * num_captures, captures, (size_t)num_captures * sizeof(int));
+                break;
+            }
+            else if ((assertion = _PIKE__ASSERT(program, instruction->opcode, text, captures[0], position, end, eflags)) != 0)
+            {
+                newline_state |= (assertion == 2);
+                pc++;
+            }
+            else
+            {
+                break;
+            }
+        }
+    }
+}
 
-                if (print_position)
-                {
-                    /* set placeholders for Start  %*sEnd */
-                    if (PRINT_COLORED == 1)
+/* (Internal) Searches the leftmost-longest match of a Pike VM program in the bounds [start, end] of a text, like regexec() with REG_STARTEND. */
+static int _PIKE__EXEC(cregpike_t* program, cregpike_workspace_t* workspace, char* text, int start, int end,
+                       size_t nmatch, regmatch_t* pmatch, int eflags)
+{
+    const int NUM_CAPTURES = (nmatch > 1 && (int)nmatch * 2 < program->num_captures) ? (int)nmatch * 2 :
+                             (nmatch > 1 ? program->num_captures : 2);
+    cregpike_list_t* current;
+    cregpike_list_t* next;
+    cregpike_list_t* swap;
+    cregpike_instruction_t* instruction;
+    int* captures;
+    int* best;
+    int position;
+    int pc;
+    int c;
+    int i;
+
+    if (workspace->memory == NULL && _PIKE__ALLOC_WORKSPACE(program, workspace) != REGEX_MATCH_SUCCESS)
+    {
+        return REG_ESPACE;
+    }
+
+    current = &workspace->lists[0];
+    next = &workspace->lists[1];
+    current->num_threads = 0;
+    best = workspace->best;
+    best[0] = -1;
+
+    /* the threads of a list are ordered by their start position, then by priority */
+    for (position = start; position <= end; position++)
+    {
+        /* a new thread starts at each position until the leftmost match is found */
+        if (best[0] < 0)
+        {
+            for (i = 0; i < NUM_CAPTURES; i++)
+            {
+                workspace->seed[i] = -1;
+            }
+
+            _PIKE__ADD_THREAD(program, workspace, current, 0, workspace->seed, NUM_CAPTURES, text, position, end, eflags);
+        }
+
+        if (current->num_threads == 0)
+        {
+            if (best[0] >= 0)
+            {
+                break;
+            }
+
+            continue;
+        }
+
+        c = (position < end) ? (unsigned char)text[position] : -1;
+        next->num_threads = 0;
+
+        for (i = 0; i < current->num_threads; i++)
+        {
+            pc = current->dense[i];
+
+            /* the other instructions are only in the list to take one thread per position */
+            if (pc >= program->num_instructions || (instruction = &program->instructions[pc])->opcode > REGEX_PIKE_MATCH)
+            {
+                continue;
+            }
+
+            captures = current->captures + (size_t)pc * NUM_CAPTURES;
+
+            /* threads right of the leftmost match are cut */
+            if (best[0] >= 0 && captures[0] > best[0])
+            {
+                break;
+            }
+
+            switch (instruction->opcode)
+            {
+                case REGEX_PIKE_CHAR:
+                    if (c == instruction->arg)
                     {
-                        sprintf(temp_str_buffer[0], "%d", regex_data->matches[regex_data->num_matches-1].end);
-                        strcat(PRINTF_FORMAT_STR, " \033[90m%8d -> %");
-                        sprintf(temp_str_buffer[1], "%d", 1 + (int)strlen(temp_str_buffer[0]));
-                        strcat(PRINTF_FORMAT_STR, temp_str_buffer[1]);
-                        if (regex_data->num_pattern_subexpr > 0 && regex_data->matches[i].number_submatch == 0)
-                        {
-                            strcat(PRINTF_FORMAT_STR, "d\033[0m  %c  \033[35m%s\033[0m\n");
-                        }
-                        else
-                        {
-                            strcat(PRINTF_FORMAT_STR, "d\033[0m  %c  %s\n");
-                        }
+                        _PIKE__ADD_THREAD(program, workspace, next, pc + 1, captures, NUM_CAPTURES, text, position + 1, end, eflags);
                     }
-                    else
+                    break;
+
+                case REGEX_PIKE_ANY:
+                    if (c > 0 && (c != '\n' || program->newline == 0))
                     {
-                        sprintf(temp_str_buffer[0], "%d", regex_data->matches[regex_data->num_matches-1].end);
-                        strcat(PRINTF_FORMAT_STR, " %8d -> %");
-                        sprintf(temp_str_buffer[1], "%d", 1 + (int)strlen(temp_str_buffer[0]));
-                        strcat(PRINTF_FORMAT_STR, temp_str_buffer[1]);
-                        strcat(PRINTF_FORMAT_STR, "d  %c  %s\n");
+                        _PIKE__ADD_THREAD(program, workspace, next, pc + 1, captures, NUM_CAPTURES, text, position + 1, end, eflags);
                     }
-                }
-                else
-                {
-                    /* set placeholders for Start  %*sEnd */
-                    if (PRINT_COLORED == 1)
+                    break;
+
+                case REGEX_PIKE_CLASS:
+                    if (c >= 0 && (program->classes[(size_t)instruction->arg * REGEX_PIKE_CLASS_SIZE + (c >> 3)] & (1 << (c & 7))))
                     {
-                        sprintf(temp_str_buffer[0], "%d", regex_data->matches[regex_data->num_matches-1].end);
-                        strcat(PRINTF_FORMAT_STR, " \033[90m");
-                        sprintf(temp_str_buffer[1], " ");
-                        strcat(PRINTF_FORMAT_STR, temp_str_buffer[1]);
-                        if (regex_data->num_pattern_subexpr > 0 && regex_data->matches[i].number_submatch == 0)
-                        {
-                            strcat(PRINTF_FORMAT_STR, "\033[0m%c  \033[35m%s\033[0m\n");
-                        }
-                        else
-                        {
-                            strcat(PRINTF_FORMAT_STR, "\033[0m%c  %s\n");
-                        }
+                        _PIKE__ADD_THREAD(program, workspace, next, pc + 1, captures, NUM_CAPTURES, text, position + 1, end, eflags);
                     }
-                    else
+                    break;
+
+                case REGEX_PIKE_MATCH:
+                    /* leftmost match, then longest match, then the match of the highest priority */
+                    if (best[0] < 0 || captures[0] < best[0] || (captures[0] == best[0] && captures[1] > best[1]))
                     {
-                        sprintf(temp_str_buffer[0], "%d", regex_data->matches[regex_data->num_matches-1].end);
-                        strcat(PRINTF_FORMAT_STR, " ");
-                        sprintf(temp_str_buffer[1], " ");
-                        strcat(PRINTF_FORMAT_STR, temp_str_buffer[1]);
-                        strcat(PRINTF_FORMAT_STR, "%c  %s\n");
+                        memcpy(best, captures, (size_t)NUM_CAPTURES * sizeof(int));
                     }
-                }
+                    break;
+            }
+        }
 
-                /* set all values */
-                output_string = __REALLOC(output_string, (strlen(regex_data->matches[i].string) + 512) * sizeof(char));
-                if (print_position)
-                {
-                    sprintf(output_string, PRINTF_FORMAT_STR,
-                        i + 1,
-                        regex_data->matches[i].number_match,
-                        regex_data->matches[i].number_submatch,
-                        regex_data->matches[i].start,
-                        regex_data->matches[i].end,
-                        (regex_data->num_pattern_subexpr > 0 && regex_data->matches[i].number_submatch == 0 ? '*' : ' '),
-                        substring
-                    );
-                }
-                else
+        swap = current;
+        current = next;
+        next = swap;
+    }
+
+    if (best[0] < 0)
+    {
+        return REG_NOMATCH;
+    }
+
+    for (i = 0; i < (int)nmatch; i++)
+    {
+        if (2 * i + 1 < NUM_CAPTURES && best[2 * i] >= 0 && best[2 * i + 1] >= best[2 * i])
+        {
+            pmatch[i].rm_so = best[2 * i];
+            pmatch[i].rm_eo = best[2 * i + 1];
+        }
+        else
+        {
+            pmatch[i].rm_so = -1;
+            pmatch[i].rm_eo = -1;
+        }
+    }
+
+    return REGEX_MATCH_SUCCESS;
+}
+
+/* (Internal) Checks if an instruction of a Pike VM program takes a character. */
+static int _PIKE__TAKES(cregpike_t* program, cregpike_instruction_t* instruction, int c)
+{
+    switch (instruction->opcode)
+    {
+        case REGEX_PIKE_CHAR:
+            return c == instruction->arg;
+        case REGEX_PIKE_ANY:
+            return c > 0 && (c != '\n' || program->newline == 0);
+        case REGEX_PIKE_CLASS:
+            return (program->classes[(size_t)instruction->arg * REGEX_PIKE_CLASS_SIZE + (c >> 3)] & (1 << (c & 7))) != 0;
+    }
+
+    return 0;
+}
+
+/* (Internal) Splits the bytes into the classes of bytes which the instructions of a Pike VM program do not distinguish. */
+static void _PIKE__BYTE_CLASSES(cregpike_t* program)
+{
+    cregpike_instruction_t* instruction;
+    unsigned char boundaries[256];
+    int word_assertions = 0;
+    int i;
+    int c;
+
+    /* a class starts at each byte which an instruction takes differently than the byte before,
+       the newline character is also the context of the anchors */
+    memset(boundaries, 0, sizeof(boundaries));
+    boundaries['\n'] = 1;
+    boundaries['\n' + 1] = 1;
+    program->single_line = program->newline;
+
+    for (i = 0; i < program->num_instructions; i++)
+    {
+        instruction = &program->instructions[i];
+
+        if (instruction->opcode < REGEX_PIKE_MATCH)
+        {
+            for (c = 1; c < 256; c++)
+            {
+                if (_PIKE__TAKES(program, instruction, c) != _PIKE__TAKES(program, instruction, c - 1))
                 {
-                    sprintf(output_string, PRINTF_FORMAT_STR,
-                        i + 1,
-                        regex_data->matches[i].number_match,
-                        regex_data->matches[i].number_submatch,
-                        (regex_data->num_pattern_subexpr > 0 && regex_data->matches[i].number_submatch == 0 ? '*' : ' '),
-                        substring
-                    );
+                    boundaries[c] = 1;
                 }
-
-                /* concatinate strings to table row */
-                result_string = __REALLOC(result_string, (strlen(result_string) + strlen(output_string) + 32) * sizeof(char));
-                strcat(result_string, output_string);
             }
-            else if (PRINT_LAYOUT == REGEX_PRINT_LIST)
+
+            if (_PIKE__TAKES(program, instruction, '\n'))
             {
-                /* set all values */
-                output_string = __REALLOC(output_string, (strlen(regex_data->matches[i].string) + 256) * sizeof(char));
+                program->single_line = 0;
+            }
+        }
+        else if (instruction->opcode >= REGEX_PIKE_WORD_BOUNDARY && instruction->opcode <= REGEX_PIKE_WORD_END)
+        {
+            word_assertions = 1;
+        }
+    }
 
-                if (print_position)
-                {
-                    if (PRINT_COLORED == 1)
-                    {
-                        sprintf(temp_str_buffer[0], "\033[32m[%d]\033[0m", i+1);
-                        sprintf(temp_str_buffer[1], "\033[90m(%d-%d)\033[0m", regex_data->matches[i].start, regex_data->matches[i].end);
+    /* ... and the word characters of the word boundaries */
+    for (c = 1; c < 256 && word_assertions == 1; c++)
+    {
+        if ((isalnum(c) || c == '_') != (isalnum(c - 1) || c - 1 == '_'))
+        {
+            boundaries[c] = 1;
+        }
+    }
 
-                        if (regex_data->num_pattern_subexpr > 0 && regex_data->matches[i].number_submatch == 0)
-                        {
-                            sprintf(output_string, "%-4s %12s: \033[35m%s\033[0m", temp_str_buffer[0], temp_str_buffer[1], substring);
-                        }
-                        else
-                        {
-                            sprintf(output_string, "%-4s %12s: %s", temp_str_buffer[0], temp_str_buffer[1], substring);
-                        }
-                        
-                    }
-                    else
-                    {
-                        sprintf(temp_str_buffer[0], "[%d]", i+1);
-                        sprintf(temp_str_buffer[1], "(%d-%d)", regex_data->matches[i].start, regex_data->matches[i].end);
-                        sprintf(output_string, "%-4s %12s: %s", temp_str_buffer[0], temp_str_buffer[1], substring);
-                    }
-                }
-                else
-                {
-                    if (PRINT_COLORED == 1)
-                    {
-                        sprintf(temp_str_buffer[0], "\033[32m[%d]\033[0m", i+1);
+    program->num_byte_classes = 1;
+    program->byte_classes[0] = 0;
 
-                        if (regex_data->num_pattern_subexpr > 0 && regex_data->matches[i].number_submatch == 0)
-                        {
-                            sprintf(output_string, "%-4s: \033[35m%s\033[0m", temp_str_buffer[0], substring);
-                        }
-                        else
-                        {
-                            sprintf(output_string, "%-4s: %s", temp_str_buffer[0], substring);
-                        }
-                        
-                    }
-                    else
-                    {
-                        sprintf(temp_str_buffer[0], "[%d]", i+1);
-                        sprintf(output_string, "%-4s %12s: %s", temp_str_buffer[0], temp_str_buffer[1], substring);
-                    }
-                }
+    for (c = 1; c < 256; c++)
+    {
+        program->num_byte_classes += boundaries[c];
+        program->byte_classes[c] = (unsigned char)(program->num_byte_classes - 1);
+    }
+}
 
-                
-                
-                /* add Substring */
-                strcat(output_string, "\n");
+/* (Internal) Returns the Pike VM program which searches a RegEx object instead of regexec(), or NULL. */
+static cregpike_t* _PIKE__SEARCH_PROGRAM(RegEx regex_data)
+{
+    return (regex_data->flags.PIKEVM == 1) ? regex_data->regex_h.program : NULL;
+}
 
-                /* concatinate all strings to list entry */
-                result_string = __REALLOC(result_string, (strlen(result_string) + strlen(output_string) + 32) * sizeof(char));
-                strcat(result_string, output_string);
+/* (Internal) Removes REG_LAZYDFA from the option flags of a single search in a short text, which would not use the DFA. */
+static int _DFA__SEARCH_FLAGS(char* input_text_string, int OPTION_FLAGS)
+{
+    /* the Pike VM program of the DFA is not compiled for a search by regexec() */
+    if ((OPTION_FLAGS & REG_LAZYDFA) == REG_LAZYDFA && (OPTION_FLAGS & REG_PIKEVM) != REG_PIKEVM &&
+        strlen(input_text_string) < REGEX_DFA_MIN_TEXT_LENGTH)
+    {
+        OPTION_FLAGS &= ~REG_LAZYDFA;
+    }
+
+    return OPTION_FLAGS;
+}
+
+/* (Internal) Initializes the lazy DFA of a search, the memory is allocated by the first search. */
+static void _DFA__INIT(cregdfa_t* dfa, cregpike_t* program, int anchored)
+{
+    dfa->program = program;
+    dfa->failed = 0;
+    dfa->anchored = anchored;
+    dfa->states = NULL;
+    dfa->transitions = NULL;
+    dfa->elements = NULL;
+    dfa->buckets = NULL;
+    dfa->work = NULL;
+    dfa->num_states = 0;
+    dfa->state_capacity = 0;
+    dfa->num_elements = 0;
+    dfa->element_capacity = 0;
+    dfa->num_keys = 0;
+    dfa->match_row = 0;
+    dfa->flush_position = 0;
+}
+
+/* (Internal) Frees the memory of a lazy DFA. */
+static void _DFA__FREE(cregdfa_t* dfa)
+{
+    if (dfa->states != NULL)
+    {
+        __FREE(dfa->states);
+    }
+    if (dfa->transitions != NULL)
+    {
+        __FREE(dfa->transitions);
+    }
+    if (dfa->elements != NULL)
+    {
+        __FREE(dfa->elements);
+    }
+    if (dfa->buckets != NULL)
+    {
+        __FREE(dfa->buckets);
+    }
+    if (dfa->work != NULL)
+    {
+        __FREE(dfa->work);
+    }
+
+    _DFA__INIT(dfa, dfa->program, dfa->anchored);
+}
+
+/* (Internal) Initializes the lazy DFAs of a RegEx object, a results object or a thread without a program. */
+static void _DFA__INIT_SET(cregdfa_set_t* dfas)
+{
+    dfas->serial = 0;
+    _DFA__INIT(&dfas->dfa, NULL, 0);
+    _DFA__INIT(&dfas->reverse_dfa, NULL, 0);
+    _DFA__INIT(&dfas->anchored_dfa, NULL, 1);
+}
+
+/* (Internal) Frees the memory of the lazy DFAs of a set. */
+static void _DFA__FREE_SET(cregdfa_set_t* dfas)
+{
+    _DFA__FREE(&dfas->dfa);
+    _DFA__FREE(&dfas->reverse_dfa);
+    _DFA__FREE(&dfas->anchored_dfa);
+    _DFA__INIT_SET(dfas);
+}
+
+/* (Internal) Prepares the lazy DFAs of a set for a search with a Pike VM program, the states of the previous searches with the program are kept. */
+static void _DFA__PREPARE_SET(cregdfa_set_t* dfas, cregpike_t* program)
+{
+    /* the DFAs of another program are rebuilt, a freed program can leave its address to a new one */
+    if (dfas->serial != program->serial)
+    {
+        _DFA__FREE_SET(dfas);
+        _DFA__INIT(&dfas->dfa, program, 0);
+        _DFA__INIT(&dfas->reverse_dfa, program->reverse, 0);
+        _DFA__INIT(&dfas->anchored_dfa, program, 1);
+        dfas->serial = program->serial;
+    }
+
+    /* a DFA which gave up in a previous search is tried again */
+    dfas->dfa.failed = 0;
+    dfas->reverse_dfa.failed = 0;
+    dfas->anchored_dfa.failed = 0;
+}
+
+/* (Internal) Allocates the first states of a lazy DFA, returns REGEX_ERROR_MEMORY without memory. */
+static int _DFA__ALLOC(cregdfa_t* dfa)
+{
+    cregpike_t* program = dfa->program;
+    const size_t NUM_INSTRUCTIONS = (size_t)program->num_instructions;
+    int opcode;
+    int i;
+
+    dfa->num_columns = program->num_byte_classes;
+    dfa->context_mask = 0;
+
+    for (i = 0; i < program->num_instructions; i++)
+    {
+        opcode = program->instructions[i].opcode;
+
+        if (opcode == REGEX_PIKE_LINE_START)
+        {
+            dfa->context_mask |= REGEX_DFA_CONTEXT_BEGIN | REGEX_DFA_CONTEXT_NEWLINE;
+        }
+        else if (opcode >= REGEX_PIKE_WORD_BOUNDARY && opcode <= REGEX_PIKE_WORD_END)
+        {
+            dfa->context_mask |= REGEX_DFA_CONTEXT_WORD;
+        }
+        else if (opcode == REGEX_PIKE_BUFFER_START)
+        {
+            dfa->context_mask |= REGEX_DFA_CONTEXT_TEXT_START;
+        }
+    }
+
+    for (i = 255; i >= 0; i--)
+    {
+        dfa->class_bytes[program->byte_classes[i]] = (unsigned char)i;
+    }
+
+    /* a state takes its transitions, itself and about four instructions of the cache */
+    dfa->max_states = REGEX_DFA_CACHE_SIZE / (dfa->num_columns * sizeof(int) + sizeof(cregdfa_state_t) + 4 * sizeof(int));
+    dfa->max_elements = REGEX_DFA_CACHE_SIZE / sizeof(int);
+    dfa->state_capacity = (dfa->max_states < 16) ? dfa->max_states : 16;
+    dfa->element_capacity = 64;
+
+    /* the work memory is the sparse set of the keys, the stack of a closure and the marks of the next instructions */
+    if (NUM_INSTRUCTIONS + 1 > (size_t)-1 / sizeof(int) / 16 ||
+        (dfa->work = __TRY_MALLOC((10 * NUM_INSTRUCTIONS + 2) * sizeof(int))) == NULL ||
+        (dfa->states = __TRY_MALLOC((size_t)dfa->state_capacity * sizeof(cregdfa_state_t))) == NULL ||
+        (dfa->transitions = __TRY_MALLOC((size_t)dfa->state_capacity * dfa->num_columns * sizeof(int))) == NULL ||
+        (dfa->buckets = __TRY_MALLOC((size_t)dfa->state_capacity * 2 * sizeof(int))) == NULL ||
+        (dfa->elements = __TRY_MALLOC((size_t)dfa->element_capacity * sizeof(int))) == NULL)
+    {
+        _DFA__FREE(dfa);
+        dfa->failed = 1;
+        return REGEX_ERROR_MEMORY;
+    }
+
+    /* the sparse set does not need initialized indices, only defined values */
+    memset(dfa->work + 2 * NUM_INSTRUCTIONS, 0, 2 * NUM_INSTRUCTIONS * sizeof(int));
+    memset(dfa->work + 8 * NUM_INSTRUCTIONS + 2, 0, (NUM_INSTRUCTIONS + 1) * sizeof(int));
+
+    _DFA__FLUSH(dfa);
+
+    return REGEX_MATCH_SUCCESS;
+}
+
+/* (Internal) Removes all states and transitions of a lazy DFA. */
+static void _DFA__FLUSH(cregdfa_t* dfa)
+{
+    int i;
+
+    dfa->num_states = 0;
+    dfa->num_elements = 0;
+
+    for (i = 0; i < dfa->state_capacity * 2; i++)
+    {
+        dfa->buckets[i] = -1;
+    }
+}
+
+/* (Internal) Returns the row of the DFA state of a sorted instruction list and a context, REGEX_DFA_FAILED if the DFA is full. */
+static int _DFA__ADD_STATE(cregdfa_t* dfa, int* elements, int num_elements, int context)
+{
+    cregdfa_state_t* state;
+    void* resized;
+    unsigned long hash = (unsigned long)context;
+    int capacity;
+    int index;
+    int i;
+
+    for (i = 0; i < num_elements; i++)
+    {
+        hash = hash * 31 + (unsigned long)elements[i];
+    }
+
+    /* the bucket count is a power of two */
+    for (index = dfa->buckets[hash & (unsigned long)(dfa->state_capacity * 2 - 1)]; index >= 0; index = state->next)
+    {
+        state = &dfa->states[index];
+
+        if (state->hash == hash && state->context == context && state->num_elements == num_elements &&
+            (num_elements == 0 || memcmp(&dfa->elements[state->first_element], elements, (size_t)num_elements * sizeof(int)) == 0))
+        {
+            return index * dfa->num_columns;
+        }
+    }
+
+    /* grow the states and rebuild the buckets, or grow the instructions, up to REGEX_DFA_CACHE_SIZE */
+    if (dfa->num_states == dfa->state_capacity)
+    {
+        capacity = (dfa->state_capacity * 2 < dfa->max_states) ? dfa->state_capacity * 2 : dfa->max_states;
+
+        if (capacity <= dfa->state_capacity)
+        {
+            return REGEX_DFA_FAILED;
+        }
+
+        if ((resized = __TRY_REALLOC(dfa->states, (size_t)capacity * sizeof(cregdfa_state_t))) == NULL)
+        {
+            return REGEX_DFA_FAILED;
+        }
+        dfa->states = resized;
+
+        if ((resized = __TRY_REALLOC(dfa->transitions, (size_t)capacity * dfa->num_columns * sizeof(int))) == NULL)
+        {
+            return REGEX_DFA_FAILED;
+        }
+        dfa->transitions = resized;
+
+        if ((resized = __TRY_REALLOC(dfa->buckets, (size_t)capacity * 2 * sizeof(int))) == NULL)
+        {
+            return REGEX_DFA_FAILED;
+        }
+        dfa->buckets = resized;
+        dfa->state_capacity = capacity;
+
+        for (i = 0; i < capacity * 2; i++)
+        {
+            dfa->buckets[i] = -1;
+        }
+
+        for (i = 0; i < dfa->num_states; i++)
+        {
+            state = &dfa->states[i];
+            state->next = dfa->buckets[state->hash & (unsigned long)(capacity * 2 - 1)];
+            dfa->buckets[state->hash & (unsigned long)(capacity * 2 - 1)] = i;
+        }
+    }
+
+    if (dfa->num_elements + num_elements > dfa->element_capacity)
+    {
+        for (capacity = dfa->element_capacity; capacity < dfa->num_elements + num_elements; capacity *= 2)
+        {
+        }
+
+        if (capacity > dfa->max_elements || (resized = __TRY_REALLOC(dfa->elements, (size_t)capacity * sizeof(int))) == NULL)
+        {
+            return REGEX_DFA_FAILED;
+        }
+
+        dfa->elements = resized;
+        dfa->element_capacity = capacity;
+    }
+
+    index = dfa->num_states++;
+    state = &dfa->states[index];
+    state->first_element = dfa->num_elements;
+    state->num_elements = num_elements;
+    state->context = context;
+    state->hash = hash;
+    state->next = dfa->buckets[hash & (unsigned long)(dfa->state_capacity * 2 - 1)];
+    dfa->buckets[hash & (unsigned long)(dfa->state_capacity * 2 - 1)] = index;
+
+    /* the start state has no instructions, its list may be NULL */
+    if (num_elements > 0)
+    {
+        memcpy(&dfa->elements[dfa->num_elements], elements, (size_t)num_elements * sizeof(int));
+        dfa->num_elements += num_elements;
+    }
+
+    for (i = 0; i < dfa->num_columns; i++)
+    {
+        dfa->transitions[index * dfa->num_columns + i] = REGEX_DFA_UNKNOWN;
+    }
+
+    return index * dfa->num_columns;
+}
+
+/* (Internal) Checks an anchor or a word boundary instruction between the context of a DFA state and the next character, -1 at the text end.
+   Like _PIKE__ASSERT() it returns 2 for a "$" whose newline character the match has to consume, older threads started before the position. */
+static int _DFA__ASSERT(cregdfa_t* dfa, int opcode, int context, int next_byte, int older, int eflags)
+{
+    const int PREVIOUS_WORD = ((context & REGEX_DFA_CONTEXT_WORD) != 0);
+    const int NEXT_WORD = (next_byte >= 0 && (isalnum(next_byte) || next_byte == '_'));
+
+    switch (opcode)
+    {
+        case REGEX_PIKE_LINE_START:
+            return (context & REGEX_DFA_CONTEXT_BEGIN) != 0 ||
+                   ((context & REGEX_DFA_CONTEXT_NEWLINE) != 0 && (dfa->program->newline == 1 || older));
+        case REGEX_PIKE_LINE_END:
+            if (next_byte < 0)
+            {
+                return (eflags & REG_NOTEOL) == 0;
             }
-            else if (PRINT_LAYOUT == REGEX_PRINT_LIST_FULL)
+            return (next_byte != '\n') ? 0 : (dfa->program->newline == 1 ? 1 : (older ? 2 : 0));
+        case REGEX_PIKE_WORD_BOUNDARY:
+            return PREVIOUS_WORD != NEXT_WORD;
+        case REGEX_PIKE_NOT_WORD_BOUNDARY:
+            return PREVIOUS_WORD == NEXT_WORD;
+        case REGEX_PIKE_WORD_START:
+            return !PREVIOUS_WORD && NEXT_WORD;
+        case REGEX_PIKE_WORD_END:
+            return PREVIOUS_WORD && !NEXT_WORD;
+        case REGEX_PIKE_BUFFER_START:
+            return (context & REGEX_DFA_CONTEXT_TEXT_START) != 0;
+        case REGEX_PIKE_BUFFER_END:
+            return next_byte < 0;
+    }
+
+    return 0;
+}
+
+/* (Internal) Follows the instructions without a character of a DFA state and of a new thread before the next character, returns 1 if a match ends there.
+   The keys of the reached instructions stay in the sparse set of the work memory like in _PIKE__ADD_THREAD(). */
+static int _DFA__CLOSURE(cregdfa_t* dfa, int row, int next_byte, int eflags)
+{
+    cregpike_t* program = dfa->program;
+    cregdfa_state_t* state = &dfa->states[row / dfa->num_columns];
+    cregpike_instruction_t* instruction;
+    const int NUM_INSTRUCTIONS = program->num_instructions;
+    int* dense = dfa->work;
+    int* sparse = dense + 2 * NUM_INSTRUCTIONS;
+    int* stack = sparse + 2 * NUM_INSTRUCTIONS;
+    /* an anchored DFA only starts a new thread in its start state */
+    const int NUM_THREADS = state->num_elements + ((dfa->anchored == 0 || (state->context & REGEX_DFA_CONTEXT_START) != 0) ? 1 : 0);
+    int num_keys = 0;
+    int matched = 0;
+    int top;
+    int pc;
+    int newline_state;
+    int assertion;
+    int older;
+    int key;
+    int i;
+
+    /* the threads of the state started before the position, they reach an instruction before the new thread */
+    for (i = 0; i < NUM_THREADS; i++)
+    {
+        older = (i < state->num_elements);
+        stack[0] = older ? dfa->elements[state->first_element + i] : 0;
+        stack[1] = 0;
+        top = 2;
+
+        while (top > 0)
+        {
+            top -= 2;
+            pc = stack[top];
+            newline_state = stack[top + 1];
+
+            while (1)
             {
-                /* set all values and substring*/
-                output_string = __REALLOC(output_string, (strlen(regex_data->matches[i].string) + 256) * sizeof(char));
+                instruction = &program->instructions[pc];
 
-                if (print_position)
+                if (instruction->opcode == REGEX_PIKE_MATCH && newline_state == 1)
                 {
-                    if (PRINT_COLORED == 1)
-                    {
-                        if (regex_data->num_pattern_subexpr > 0 && regex_data->matches[i].number_submatch == 0)
-                        {
-                            sprintf(output_string, "\033[36m[%d]\033[0m\n\033[32mMatch:\033[0m     %d\n\033[32mSubmatch:\033[0m  %d\n\033[32mStart:\033[0m     %d\n\033[32mEnd:\033[0m       %d\n\033[32mSubstring:\033[0m \033[35m%s\033[0m\n",
-                                i + 1,
-                                regex_data->matches[i].number_match,
-                                regex_data->matches[i].number_submatch,
-                                regex_data->matches[i].start,
-                                regex_data->matches[i].end,
-                                regex_data->matches[i].string
-                            ); 
-                        }
-                        else
-                        {
-                            sprintf(output_string, "\033[36m[%d]\033[0m\n\033[32mMatch:\033[0m     %d\n\033[32mSubmatch:\033[0m  %d\n\033[32mStart:\033[0m     %d\n\033[32mEnd:\033[0m       %d\n\033[32mSubstring:\033[0m %s\n",
-                                i + 1,
-                                regex_data->matches[i].number_match,
-                                regex_data->matches[i].number_submatch,
-                                regex_data->matches[i].start,
-                                regex_data->matches[i].end,
-                                regex_data->matches[i].string
-                            ); 
-                        }
-                        
-                    }
-                    else
-                    {
-                        sprintf(output_string, "[%d]\nMatch      %d\nSubmatch:  %d\nStart:     %d\nEnd:       %d\nSubstring: %s\n",
-                            i + 1,
-                            regex_data->matches[i].number_match,
-                            regex_data->matches[i].number_submatch,
-                            regex_data->matches[i].start,
-                            regex_data->matches[i].end,
-                            regex_data->matches[i].string
-                        );
-                    } 
+                    break;
                 }
-                else
+
+                key = (instruction->opcode < REGEX_PIKE_MATCH) ? pc : pc + newline_state * NUM_INSTRUCTIONS;
+
+                if (sparse[key] < num_keys && dense[sparse[key]] == key)
                 {
-                    if (PRINT_COLORED == 1)
-                    {
-                        if (regex_data->num_pattern_subexpr > 0 && regex_data->matches[i].number_submatch == 0)
-                        {
-                            sprintf(output_string, "\033[36m[%d]\033[0m\n\033[32mMatch:\033[0m     %d\n\033[32mSubmatch:\033[0m  %d\n\033[32mSubstring:\033[0m \033[35m%s\033[0m\n",
-                                i + 1,
-                                regex_data->matches[i].number_match,
-                                regex_data->matches[i].number_submatch,
-                                regex_data->matches[i].string
-                            ); 
-                        }
-                        else
-                        {
-                            sprintf(output_string, "\033[36m[%d]\033[0m\n\033[32mMatch:\033[0m     %d\n\033[32mSubmatch:\033[0m  %d\n\033[32mSubstring:\033[0m %s\n",
-                                i + 1,
-                                regex_data->matches[i].number_match,
-                                regex_data->matches[i].number_submatch,
-                                regex_data->matches[i].string
-                            ); 
-                        }
-                        
-                    }
-                    else
-                    {
-                        sprintf(output_string, "[%d]\nMatch      %d\nSubmatch:  %d\nSubstring: %s\n",
-                            i + 1,
-                            regex_data->matches[i].number_match,
-                            regex_data->matches[i].number_submatch,
-                            regex_data->matches[i].string
-                        );
-                    } 
+                    break;
                 }
-                
 
-                if (i < regex_data->num_matches-1)
+                sparse[key] = num_keys;
+                dense[num_keys++] = key;
+
+                if (instruction->opcode == REGEX_PIKE_JUMP)
                 {
-                    strcat(output_string, "\n");
+                    pc = instruction->arg;
+                }
+                else if (instruction->opcode == REGEX_PIKE_SPLIT)
+                {
+                    stack[top++] = instruction->arg2;
+                    stack[top++] = newline_state;
+                    pc = instruction->arg;
+                }
+                else if (instruction->opcode == REGEX_PIKE_SAVE)
+                {
+                    pc++;
                 }
+                else if (instruction->opcode <= REGEX_PIKE_MATCH)
+                {
+                    matched |= (instruction->opcode == REGEX_PIKE_MATCH);
+                    break;
+                }
+                else if ((assertion = _DFA__ASSERT(dfa, instruction->opcode, state->context, next_byte, older, eflags)) != 0)
+                {
+                    newline_state |= (assertion == 2);
+                    pc++;
+                }
+                else
+                {
+                    break;
+                }
+            }
+        }
+    }
+
+    dfa->num_keys = num_keys;
+
+    return matched;
+}
+
+/* (Internal) Builds the transition of a DFA state by a byte class, returns the row of the next state, REGEX_DFA_MATCH_ROW(), REGEX_DFA_DEAD or REGEX_DFA_FAILED. */
+static int _DFA__TRANSITION(cregdfa_t* dfa, int row, int byte_class, int num_searched, int eflags)
+{
+    cregpike_t* program = dfa->program;
+    cregpike_instruction_t* instruction;
+    const int NUM_INSTRUCTIONS = program->num_instructions;
+    const int BYTE = dfa->class_bytes[byte_class];
+    int* dense = dfa->work;
+    int* next_elements = dense + 8 * NUM_INSTRUCTIONS + 2;
+    int num_next_elements = 0;
+    int matched;
+    int context;
+    int next_row;
+    int i;
+
+    matched = _DFA__CLOSURE(dfa, row, BYTE, eflags);
+
+    /* mark the instructions after the taken character, then list them in order */
+    for (i = 0; i < dfa->num_keys; i++)
+    {
+        if (dense[i] < NUM_INSTRUCTIONS && (instruction = &program->instructions[dense[i]])->opcode < REGEX_PIKE_MATCH &&
+            _PIKE__TAKES(program, instruction, BYTE))
+        {
+            next_elements[dense[i] + 1] = 1;
+        }
+    }
+
+    for (i = 0; i <= NUM_INSTRUCTIONS; i++)
+    {
+        if (next_elements[i] == 1)
+        {
+            next_elements[i] = 0;
+            dense[num_next_elements++] = i;
+        }
+    }
+
+    /* an anchored DFA without threads stops */
+    if (dfa->anchored == 1 && num_next_elements == 0 && matched == 0)
+    {
+        dfa->transitions[row + byte_class] = REGEX_DFA_DEAD;
+        return REGEX_DFA_DEAD;
+    }
+
+    context = ((BYTE == '\n') ? REGEX_DFA_CONTEXT_NEWLINE : 0) | ((isalnum(BYTE) || BYTE == '_') ? REGEX_DFA_CONTEXT_WORD : 0);
+    next_row = _DFA__ADD_STATE(dfa, dense, num_next_elements, context & dfa->context_mask);
+
+    if (next_row >= 0)
+    {
+        dfa->transitions[row + byte_class] = matched ? REGEX_DFA_MATCH_ROW(next_row) : next_row;
+        return dfa->transitions[row + byte_class];
+    }
+
+    /* a full cache is flushed, unless it fills up again after a few bytes per state */
+    if (num_searched - dfa->flush_position < REGEX_DFA_MIN_BYTES_PER_STATE * dfa->num_states)
+    {
+        dfa->failed = 1;
+        return REGEX_DFA_FAILED;
+    }
+
+    _DFA__FLUSH(dfa);
+    dfa->flush_position = num_searched;
+    next_row = _DFA__ADD_STATE(dfa, dense, num_next_elements, context & dfa->context_mask);
+
+    if (next_row < 0)
+    {
+        dfa->failed = 1;
+        return REGEX_DFA_FAILED;
+    }
+
+    return matched ? REGEX_DFA_MATCH_ROW(next_row) : next_row;
+}
+
+/* (Internal) Searches the end of the first match in the bounds [start, end] of a text, returns REGEX_DFA_NOMATCH or REGEX_DFA_FAILED without it.
+   A new thread starts at each position, so the end is the earliest end of all matches like the one of regexec() and the Pike VM. */
+static int _DFA__SEARCH(cregdfa_t* dfa, char* text, int start, int end, int eflags)
+{
+    const unsigned char* byte_classes;
+    int* transitions;
+    int context;
+    int position;
+    int row;
+    int next_row;
+
+    if (dfa->failed == 1 || (dfa->work == NULL && _DFA__ALLOC(dfa) != REGEX_MATCH_SUCCESS))
+    {
+        return REGEX_DFA_FAILED;
+    }
+
+    byte_classes = dfa->program->byte_classes;
+
+    /* the context of the start position comes from the character before it, like with REG_STARTEND */
+    if (start == 0)
+    {
+        context = REGEX_DFA_CONTEXT_TEXT_START | (((eflags & REG_NOTBOL) == 0) ? REGEX_DFA_CONTEXT_BEGIN : 0);
+    }
+    else
+    {
+        context = ((text[start - 1] == '\n') ? REGEX_DFA_CONTEXT_NEWLINE : 0) |
+                  ((isalnum((unsigned char)text[start - 1]) || text[start - 1] == '_') ? REGEX_DFA_CONTEXT_WORD : 0);
+    }
+
+    /* the states of the previous searches do not count as the states of this search for a flush */
+    dfa->flush_position = -REGEX_DFA_MIN_BYTES_PER_STATE * dfa->num_states;
+
+    if ((row = _DFA__ADD_STATE(dfa, NULL, 0, context & dfa->context_mask)) < 0)
+    {
+        _DFA__FLUSH(dfa);
+
+        if ((row = _DFA__ADD_STATE(dfa, NULL, 0, context & dfa->context_mask)) < 0)
+        {
+            dfa->failed = 1;
+            return REGEX_DFA_FAILED;
+        }
+    }
+
+    transitions = dfa->transitions;
+
+    for (position = start; position < end; position++)
+    {
+        next_row = transitions[row + byte_classes[(unsigned char)text[position]]];
+
+        if (next_row < 0)
+        {
+            if (next_row == REGEX_DFA_UNKNOWN)
+            {
+                next_row = _DFA__TRANSITION(dfa, row, byte_classes[(unsigned char)text[position]], position - start, eflags);
+                transitions = dfa->transitions;
+            }
+
+            if (next_row <= REGEX_DFA_MATCH_ROW(0))
+            {
+                dfa->match_row = row;
+                return position;
+            }
+            if (next_row == REGEX_DFA_FAILED)
+            {
+                return REGEX_DFA_FAILED;
+            }
+        }
+
+        row = next_row;
+    }
+
+    dfa->match_row = row;
+
+    return _DFA__CLOSURE(dfa, row, -1, eflags) ? end : REGEX_DFA_NOMATCH;
+}
+
+/* (Internal) Scans a text from the position from to the position to, backwards with a reversed program, returns the farthest position where a match ends, REGEX_DFA_NOMATCH or REGEX_DFA_FAILED.
+   The text end for the anchors is end, the first state has the sorted instruction list elements,
+   the threads of another DFA which started before the position from, and the new thread of the start. */
+static int _DFA__SEARCH_LONGEST(cregdfa_t* dfa, char* text, int from, int to, int end, int eflags, int* elements, int num_elements)
+{
+    const int STEP = (dfa->program->reversed == 1) ? -1 : 1;
+    const int OFFSET = (STEP == 1) ? 0 : -1;     /* offset of the next character of a position in the scan direction */
+    const unsigned char* byte_classes;
+    int* transitions;
+    int context;
+    int match = REGEX_DFA_NOMATCH;
+    int position;
+    int row;
+    int next_row;
+    int c;
+
+    if (dfa->failed == 1 || (dfa->work == NULL && _DFA__ALLOC(dfa) != REGEX_MATCH_SUCCESS))
+    {
+        return REGEX_DFA_FAILED;
+    }
+
+    byte_classes = dfa->program->byte_classes;
+
+    /* the context of the first position is the character before it in the scan direction, or the text start of the scan */
+    if ((STEP == 1) ? (from == 0) : (from == end))
+    {
+        context = REGEX_DFA_CONTEXT_TEXT_START | (((eflags & REG_NOTBOL) == 0) ? REGEX_DFA_CONTEXT_BEGIN : 0);
+    }
+    else
+    {
+        c = (unsigned char)text[from - 1 - OFFSET];
+        context = ((c == '\n') ? REGEX_DFA_CONTEXT_NEWLINE : 0) | ((isalnum(c) || c == '_') ? REGEX_DFA_CONTEXT_WORD : 0);
+    }
+
+    context = (context & dfa->context_mask) | ((dfa->anchored == 1) ? REGEX_DFA_CONTEXT_START : 0);
+    /* the states of the previous searches do not count as the states of this search for a flush */
+    dfa->flush_position = -REGEX_DFA_MIN_BYTES_PER_STATE * dfa->num_states;
+
+    if ((row = _DFA__ADD_STATE(dfa, elements, num_elements, context)) < 0)
+    {
+        _DFA__FLUSH(dfa);
+
+        if ((row = _DFA__ADD_STATE(dfa, elements, num_elements, context)) < 0)
+        {
+            dfa->failed = 1;
+            return REGEX_DFA_FAILED;
+        }
+    }
+
+    transitions = dfa->transitions;
+
+    for (position = from; position != to; position += STEP)
+    {
+        next_row = transitions[row + byte_classes[(unsigned char)text[position + OFFSET]]];
+
+        if (next_row < 0)
+        {
+            if (next_row == REGEX_DFA_UNKNOWN)
+            {
+                next_row = _DFA__TRANSITION(dfa, row, byte_classes[(unsigned char)text[position + OFFSET]], (position - from) * STEP, eflags);
+                transitions = dfa->transitions;
+            }
+
+            if (next_row == REGEX_DFA_FAILED)
+            {
+                return REGEX_DFA_FAILED;
+            }
+            if (next_row == REGEX_DFA_DEAD)
+            {
+                return match;
+            }
+            if (next_row <= REGEX_DFA_MATCH_ROW(0))
+            {
+                match = position;
+                next_row = REGEX_DFA_MATCH_ROW(next_row);
+            }
+        }
+
+        row = next_row;
+    }
+
+    /* the last position is followed by the next character of the text, or by the text start of the scan */
+    if ((STEP == 1) ? (to >= end) : (to <= 0))
+    {
+        return _DFA__CLOSURE(dfa, row, -1, eflags) ? to : match;
+    }
+
+    /* a match ends before the next character if its transition is a match, which is built only once */
+    c = byte_classes[(unsigned char)text[to + OFFSET]];
+    next_row = transitions[row + c];
+
+    if (next_row == REGEX_DFA_UNKNOWN)
+    {
+        next_row = _DFA__TRANSITION(dfa, row, c, (to - from) * STEP, eflags);
+    }
+    if (next_row == REGEX_DFA_FAILED)
+    {
+        return REGEX_DFA_FAILED;
+    }
+
+    return (next_row <= REGEX_DFA_MATCH_ROW(0)) ? to : match;
+}
+
+/* (Internal) Finds the start and the end of the leftmost-longest match of a single-line pattern after a match end of _DFA__SEARCH(), returns the end or REGEX_DFA_FAILED.
+   The leftmost match started before this first match end, so the threads of the DFA state of this end are followed by the anchored DFA to the farthest end
+   of these matches. The reverse DFA scans back from there to the leftmost start in the line, the anchored DFA scans from this start to the longest end.
+   match_start is set to the position where an exact search has to start. */
+static int _DFA__SEARCH_SPAN(cregdfa_t* dfa, cregdfa_t* reverse_dfa, cregdfa_t* anchored_dfa, char* text, int match_end, int start, int end, int eflags, int* match_start)
+{
+    const int REVERSE_EFLAGS = (((eflags & REG_NOTBOL) != 0) ? REG_NOTEOL : 0) | (((eflags & REG_NOTEOL) != 0) ? REG_NOTBOL : 0);
+    cregdfa_state_t* state = &dfa->states[dfa->match_row / dfa->num_columns];
+    int line_start = match_end;
+    int farthest_end = REGEX_DFA_FAILED;
+    int match_start_local = REGEX_DFA_FAILED;
+
+    while (line_start > start && text[line_start - 1] != '\n')
+    {
+        line_start--;
+    }
+
+    *match_start = line_start;
+
+    if (reverse_dfa->program == NULL)
+    {
+        return REGEX_DFA_FAILED;
+    }
+
+    farthest_end = _DFA__SEARCH_LONGEST(anchored_dfa, text, match_end, end, end, eflags, &dfa->elements[state->first_element], state->num_elements);
+
+    if (farthest_end >= 0)
+    {
+        match_start_local = _DFA__SEARCH_LONGEST(reverse_dfa, text, farthest_end, line_start, end, REVERSE_EFLAGS, NULL, 0);
+    }
+
+    if (match_start_local < 0)
+    {
+        return REGEX_DFA_FAILED;
+    }
+
+    *match_start = match_start_local;
+    match_end = _DFA__SEARCH_LONGEST(anchored_dfa, text, match_start_local, farthest_end, end, eflags, NULL, 0);
+
+    return (match_end >= 0) ? match_end : REGEX_DFA_FAILED;
+}
+
+/* (Internal) Copies the strings of the regexec offsets into the result data. */
+static int _EXEC__GET_MATCHED_STRINGS(char* input_text_string, RegExResults results)
+{
+    int i;
+    size_t STRINGS_SIZE = 0;
+    char* write_ptr;
+
+    /* set the spans into the input text and get the size of all substrings */
+    for (i = 0; i < results->num_matches; i++)
+    {
+        results->matches[i].start = (int)results->match_offsets[i].rm_so;
+        results->matches[i].end = (int)results->match_offsets[i].rm_eo;
+        results->matches[i].length = results->matches[i].end - results->matches[i].start;
+        STRINGS_SIZE += results->matches[i].length + 1;
+    }
+
+    /* copy all substrings into one buffer */
+    results->match_strings = _ARENA__ALLOC(&results->arena, (STRINGS_SIZE + 1) * sizeof(char));
+
+    if (results->match_strings == NULL)
+    {
+        results->return_code = REGEX_ERROR_MEMORY;
+        fprintf(stderr, "regex_exec() error: Could not allocate memory for the matched strings.\n");
+        return REGEX_ERROR_MEMORY;
+    }
+
+    write_ptr = results->match_strings;
+
+    for (i = 0; i < results->num_matches; i++)
+    {
+        results->matches[i].string = write_ptr;
+        memcpy(write_ptr, input_text_string + results->matches[i].start, results->matches[i].length);
+        write_ptr += results->matches[i].length;
+        *write_ptr++ = '\0';
+    }
+
+    return REGEX_MATCH_SUCCESS;
+}
+
+/* (Internal) Returns the number of regmatch_t slots for regexec(): the match and its sub-expressions, or only the match with REG_NOSUBEXP. */
+static size_t _EXEC__NUM_MATCH_SLOTS(RegEx regex_data)
+{
+    if (regex_data->flags.NOSUBEXP == 1)
+    {
+        return 1;
+    }
+
+    return (size_t)regex_data->num_pattern_subexpr + 1;
+}
+
+/* (Internal) Appends a match to the match arrays of the result data, which grow by doubling their capacity in the arena. */
+static int _EXEC__APPEND_MATCH(RegExResults results, regmatch_t* match_offset, int number_match, int number_submatch)
+{
+    const int INDEX = results->num_matches;
+    const int CAPACITY = INDEX > 0 ? INDEX * 2 : 16;
+    regmatch_t* match_offsets;
+    cregmatches_t* matches;
+
+    /* optional limit of the number of matches */
+    if (_CONTEXT(max_num_matches, MAX_NUM_MATCHES) > 0 && INDEX >= (int)_CONTEXT(max_num_matches, MAX_NUM_MATCHES))
+    {
+        fprintf(stderr, "regex_exec() error: Number of matches exceeds maximum numer of MAX_NUM_MATCHES: %d.\n", _CONTEXT(max_num_matches, MAX_NUM_MATCHES));
+        return REGEX_ERROR;
+    }
+
+    if (INDEX == results->match_capacity)
+    {
+        /* the previous arrays stay valid in the arena until both arrays are grown */
+        match_offsets = _ARENA__REALLOC(&results->arena, results->match_offsets, INDEX * sizeof(regmatch_t), CAPACITY * sizeof(regmatch_t));
+
+        if (match_offsets != NULL)
+        {
+            results->match_offsets = match_offsets;
+        }
+
+        matches = match_offsets != NULL ? _ARENA__REALLOC(&results->arena, results->matches, INDEX * sizeof(cregmatches_t), CAPACITY * sizeof(cregmatches_t)) : NULL;
+
+        if (matches == NULL)
+        {
+            fprintf(stderr, "regex_exec() error: Could not allocate memory for %d matches.\n", CAPACITY);
+            return REGEX_ERROR_MEMORY;
+        }
+
+        results->matches = matches;
+        results->match_capacity = CAPACITY;
+    }
+
+    results->match_offsets[INDEX] = *match_offset;
+    results->matches[INDEX].number_match = number_match;
+    results->matches[INDEX].number_submatch = number_submatch;
+    results->num_matches++;
+
+    return REGEX_MATCH_SUCCESS;
+}
+
+/* (Internal) Checks if the regular expression pattern matches the input text string, returns 0 or 1. */
+static int _EXEC__TEST(RegEx regex_data, char* input_text_string)
+{
+    const int TEXT_LENGTH = (int)strlen(input_text_string);
+    cregpike_workspace_t workspace;
+    cregdfa_t dfa;
+    int return_code = REGEX_DFA_FAILED;
+
+    /* the lazy DFA only needs the end of a match, its states are freed after the search,
+       so a short text is searched by the exact search without building them */
+    if (regex_data->flags.LAZYDFA == 1 && regex_data->regex_h.program != NULL && TEXT_LENGTH >= REGEX_DFA_MIN_TEXT_LENGTH)
+    {
+        _DFA__INIT(&dfa, regex_data->regex_h.program, 0);
+        return_code = _DFA__SEARCH(&dfa, input_text_string, 0, TEXT_LENGTH, 0);
+        _DFA__FREE(&dfa);
+    }
+
+    if (return_code != REGEX_DFA_FAILED)
+    {
+        return (return_code != REGEX_DFA_NOMATCH);
+    }
+
+    if (_PIKE__SEARCH_PROGRAM(regex_data) == NULL)
+    {
+        return (regexec(&regex_data->regex_h.compiled_regex, input_text_string, 0, NULL, 0) == REGEX_MATCH_SUCCESS);
+    }
+
+    _PIKE__INIT_WORKSPACE(&workspace);
+    return_code = _PIKE__EXEC(regex_data->regex_h.program, &workspace, input_text_string, 0, TEXT_LENGTH, 0, NULL, 0);
+    _PIKE__FREE_WORKSPACE(&workspace);
+
+    return (return_code == REGEX_MATCH_SUCCESS);
+}
+
+/* (Internal) Searches for the first occurence of the regular expression pattern in the input text string. */
+static int _EXEC__SEARCH_LOCAL(char* input_text_string, int input_text_length, RegEx regex_data, RegExResults results)
+{
+    const size_t NUM_MATCH_SLOTS = _EXEC__NUM_MATCH_SLOTS(regex_data);
+    int i = 0;
+    int ITEM_NUMBER = 0;
+    int MATCH_NUMBER = 0;
+    int return_code = -1;
+    int search_start = 0;
+    int match_end;
+    cregpike_workspace_t workspace;
+    cregdfa_set_t* dfas = &results->dfas;
+
+    /* int regexec(const regex_t * preg, const char*  string, size_t nmatch, regmatch_t * pmatch, int eflags);
+    -------------------------------------------------------------------------------------------------------
+    Compares the NULL-terminated string specified by string against the compiled regular expression, preg. 
+
+    preg:   is a pointer to a compiled regular expression to compare against STRING.
+    string: is a pointer to a string to be matched.
+    nmatch: is the number of sub-expressions to match.
+    pmatch: is an array of offsets into STRING which matched the corresponding sub-expressions in preg.
+            typedef struct
+            {
+              regoff_t rm_so;  // Byte offset from string's start to substring's start.
+              regoff_t rm_eo;  // Byte offset from string's start to substring's end.
+            } regmatch_t;
+
+    eflags: is a bit flag defining customizable behavior of regexec():
+            REG_NOTBOL: Indicates that the first character of STRING is not the beginning of the line.
+            REG_NOTEOL: Indicates that the first character of STRING is not the end of the line. 
+
+    return: if a match is found, regexec() returns 0. */
+    regmatch_t fixed_iteration[REGEX_CURSOR_SLOTS];
+    regmatch_t* match_iteration = (NUM_MATCH_SLOTS <= REGEX_CURSOR_SLOTS) ? fixed_iteration :
+                                  __TRY_MALLOC(NUM_MATCH_SLOTS * sizeof(regmatch_t));    /* match of one iteration */
+
+    if (match_iteration == NULL)
+    {
+        results->return_code = REGEX_ERROR_MEMORY;
+        fprintf(stderr, "regex_exec() error: Could not allocate memory.\n");
+        return REGEX_ERROR_MEMORY;
+    }
+
+    /*return_code = regexec(&(regex_data->regex_h.compiled_regex), input_text_string, MAX_NUM_MATCHES, (regmatch_t*)regex_data->regex_h.match_offsets, 0);*/
+
+    /* the lazy DFA skips a text without a match, a match of a pattern without newline characters is found in the line of its end
+       by the reverse DFA, so the exact search starts at the match start and only runs for the sub-expressions,
+       the states of the DFAs are kept with the result data for the next execution */
+    if (regex_data->flags.LAZYDFA == 1 && regex_data->regex_h.program != NULL)
+    {
+        _DFA__PREPARE_SET(dfas, regex_data->regex_h.program);
+        match_end = _DFA__SEARCH(&dfas->dfa, input_text_string, 0, input_text_length, 0);
+
+        if (match_end == REGEX_DFA_NOMATCH)
+        {
+            return_code = REG_NOMATCH;
+        }
+        else if (match_end >= 0 && regex_data->regex_h.program->single_line == 1)
+        {
+            match_end = _DFA__SEARCH_SPAN(&dfas->dfa, &dfas->reverse_dfa, &dfas->anchored_dfa, input_text_string, match_end, 0, input_text_length, 0, &search_start);
+
+            if (match_end >= 0 && NUM_MATCH_SLOTS == 1)
+            {
+                match_iteration[0].rm_so = search_start;
+                match_iteration[0].rm_eo = match_end;
+                return_code = REGEX_MATCH_SUCCESS;
+            }
+        }
+    }
+
+    if (return_code == REG_NOMATCH || return_code == REGEX_MATCH_SUCCESS)
+    {
+        /* no match of the lazy DFA, or the match of the DFAs without sub-expressions */
+    }
+    else if (_PIKE__SEARCH_PROGRAM(regex_data) != NULL)
+    {
+        _PIKE__INIT_WORKSPACE(&workspace);
+        return_code = _PIKE__EXEC(regex_data->regex_h.program, &workspace, input_text_string, search_start, input_text_length, NUM_MATCH_SLOTS, match_iteration, 0);
+        _PIKE__FREE_WORKSPACE(&workspace);
+    }
+#ifdef REG_STARTEND
+    else
+    {
+        /* search in the bounds of the input text length, which may contain NUL bytes */
+        match_iteration[0].rm_so = search_start;
+        match_iteration[0].rm_eo = input_text_length;
+        return_code = regexec(&(regex_data->regex_h.compiled_regex), input_text_string, NUM_MATCH_SLOTS, (regmatch_t*)match_iteration, REG_STARTEND);
+    }
+#else
+    else
+    {
+        return_code = regexec(&(regex_data->regex_h.compiled_regex), input_text_string, NUM_MATCH_SLOTS, (regmatch_t*)match_iteration, 0);
+    }
+#endif
+
+    /* copy matched strings */
+    if (return_code == REGEX_MATCH_SUCCESS)
+    {
+        /* next match successful */
+        MATCH_NUMBER += 1;
+
+        /* get number of matches */
+        for (i = 0; i < (int)NUM_MATCH_SLOTS; i++)
+        {
+            /* some library bug on (a)|(b) matching second group at next element instead of this */
+            if (match_iteration[i].rm_so == (size_t)-1)
+            {
+                break;
+            }
+
+            /* if this match is valid */
+            if (match_iteration[i].rm_so != (size_t)-1)
+            { 
+                /* set the item number to one lesser, if previous match was invalid, to step over invalid matches */
+                if (i > 0 && match_iteration[i-1].rm_so == -1)
+                {
+                    ITEM_NUMBER = i - 1;
+                }
+                else
+                {
+                    ITEM_NUMBER = i;
+                }
+
+                if ((regex_data->flags.SUBEXP == 0 && regex_data->flags.NOSUBEXP == 0) ||                       /* add every result, if SUBEXP = 0 */
+                    (regex_data->flags.SUBEXP == 0 && regex_data->flags.NOSUBEXP == 1 && ITEM_NUMBER == 0) ||   /* add just the main matches, if NOSUBEXP = 1 */
+                    (regex_data->flags.SUBEXP == 1 && ITEM_NUMBER > 0))                                    
+                {
+                    if ((return_code = _EXEC__APPEND_MATCH(results, &match_iteration[i], MATCH_NUMBER, ITEM_NUMBER)) != REGEX_MATCH_SUCCESS)
+                    {
+                        results->return_code = return_code;
+                        break;
+                    }
+                }
+            }
+        }
+
+        /* copy substrings from input text */
+        if (return_code == REGEX_MATCH_SUCCESS)
+        {
+            return_code = _EXEC__GET_MATCHED_STRINGS(input_text_string, results);
+        }
+    }
+
+    if (match_iteration != fixed_iteration)
+    {
+        __FREE(match_iteration);
+    }
+
+    return return_code;
+}
+
+/* (Internal) Initializes a cursor for the global search of a compiled RegEx object in a text, returns REGEX_ERROR_MEMORY without memory.
+   The lazy DFAs of REG_LAZYDFA are the DFAs of the caller, which keep their states for the next search, or NULL for DFAs of the cursor. */
+static int _EXEC__INIT_CURSOR(cregcursor_t* cursor, RegEx regex_data, char* input_text_string, int input_text_length, cregdfa_set_t* dfas)
+{
+    int i;
+
+    cursor->compiled_regex = &regex_data->regex_h.compiled_regex;
+    cursor->program = _PIKE__SEARCH_PROGRAM(regex_data);
+    _PIKE__INIT_WORKSPACE(&cursor->workspace);
+    cursor->dfas = NULL;
+
+    /* the DFAs of the cursor are only initialized if the caller has none */
+    if (regex_data->flags.LAZYDFA == 1 && regex_data->regex_h.program != NULL)
+    {
+        if (dfas == NULL)
+        {
+            _DFA__INIT_SET(&cursor->own_dfas);
+            dfas = &cursor->own_dfas;
+        }
+
+        cursor->dfas = dfas;
+        _DFA__PREPARE_SET(cursor->dfas, regex_data->regex_h.program);
+    }
+    cursor->text = input_text_string;
+    cursor->text_length = input_text_length;
+    cursor->read_position = 0;
+    cursor->number_match = 0;
+    cursor->num_match_slots = _EXEC__NUM_MATCH_SLOTS(regex_data);
+    cursor->newline = regex_data->flags.NEWLINE;
+    cursor->finished = 0;
+    cursor->eflags = 0;
+    cursor->dfa_matches = 0;
+    cursor->dfa_bytes = 0;
+
+    /* the buffers of patterns with few sub-expressions are part of the cursor */
+    if (cursor->num_match_slots <= REGEX_CURSOR_SLOTS)
+    {
+        cursor->match_offsets = cursor->fixed_offsets;
+        cursor->submatch_numbers = cursor->fixed_numbers;
+    }
+    else
+    {
+        cursor->match_offsets = __TRY_MALLOC(cursor->num_match_slots * sizeof(regmatch_t));
+        cursor->submatch_numbers = __TRY_MALLOC(cursor->num_match_slots * sizeof(int));
+    }
+
+    if (cursor->match_offsets == NULL || cursor->submatch_numbers == NULL)
+    {
+        if (cursor->match_offsets != NULL)
+        {
+            __FREE(cursor->match_offsets);
+        }
+        if (cursor->submatch_numbers != NULL)
+        {
+            __FREE(cursor->submatch_numbers);
+        }
+
+        fprintf(stderr, "regex_exec() error: Could not allocate memory.\n");
+        return REGEX_ERROR_MEMORY;
+    }
+
+    /* full initialize regmatch_t array fields */
+    for (i = 0; i < (int)cursor->num_match_slots; i++)
+    {
+        cursor->match_offsets[i].rm_so = -1;
+        cursor->match_offsets[i].rm_eo = -1;
+        cursor->submatch_numbers[i] = -1;
+    }
+
+    return REGEX_MATCH_SUCCESS;
+}
+
+/* (Internal) Frees the buffers of a cursor. */
+static void _EXEC__FREE_CURSOR(cregcursor_t* cursor)
+{
+    _PIKE__FREE_WORKSPACE(&cursor->workspace);
+
+    if (cursor->dfas == &cursor->own_dfas)
+    {
+        _DFA__FREE_SET(&cursor->own_dfas);
+    }
+
+    if (cursor->match_offsets != cursor->fixed_offsets)
+    {
+        __FREE(cursor->match_offsets);
+        __FREE(cursor->submatch_numbers);
+    }
+}
+
+/* (Internal) Sets the group numbers of the valid offsets of the last match, -1 for invalid offsets. */
+static void _EXEC__NUMBER_SUBMATCHES(cregcursor_t* cursor)
+{
+    int return_code_local = REGEX_MATCH_SUCCESS;
+    int i = 0;                          /* loop counters */
+    int j = 0;
+    int BREAK = 0;                      /* loop break flag */
+    int NEXT_VALID_MATCH_DISTANCE = 0;  /* distance to next valid match in regmatch_t array */
+    int NUMBER_GROUP = 0;
+    const int NUM_GROUPS = (int)cursor->num_match_slots - 1;   /* number of sub-expression slots in regmatch_t array */
+    regmatch_t* match_iteration = cursor->match_offsets;
+
+    for (i = 0; i <= NUM_GROUPS; i++)
+    {
+        cursor->submatch_numbers[i] = -1;
+    }
+
+    /* for each match found in regmatch_t array */
+    for (i = 0; i <= NUM_GROUPS; i++)
+    {
+        /* for each next match ahead */
+        for (j = i + 1; j <= NUM_GROUPS; j++)
+        {
+            /* if first match /= set top match */
+            if (i == 0)
+            {
+                NUMBER_GROUP = 0;
+            }
+            if (i == 1 && return_code_local == REGEX_MATCH_OFFSET_DIST)
+            {
+                NUMBER_GROUP = NEXT_VALID_MATCH_DISTANCE;
+            }
+
+            /* if one of the next matches is valid -> break */
+            if (match_iteration[j].rm_so != (size_t) - 1)
+            {
+                BREAK = 0;
+                NEXT_VALID_MATCH_DISTANCE = j - i;
+
+                /* if one of the next valid matches is more away, instead the next one */
+                if (NEXT_VALID_MATCH_DISTANCE > 1)
+                {
+                    return_code_local = REGEX_MATCH_OFFSET_DIST;
+                }
+
+                break;
+            }
+
+            /* break if maximum next possible matches checked */
+            if (j == NUM_GROUPS)
+            {
+                BREAK = 1;
+            }
+        }
+
+        /* -> break if match is invalid and no valid matches ahead */
+        if (match_iteration[i].rm_so == (size_t)-1 && BREAK == 1)
+        {
+            break;
+        }
+
+        /* if this match is valid */
+        if (match_iteration[i].rm_so != -1)
+        {
+            cursor->submatch_numbers[i] = (return_code_local == REGEX_MATCH_OFFSET_DIST) ? NUMBER_GROUP : i;
+        }
+    }
+}
+
+/* (Internal) Searches for the next occurence of the regular expression pattern from the read position of a cursor. */
+static int _EXEC__NEXT_MATCH(cregcursor_t* cursor)
+{
+    int return_code = REG_NOMATCH;
+    int match_end;
+#ifndef REG_STARTEND
+    int i;
+#endif
+
+    if (cursor->finished)
+    {
+        return REG_NOMATCH;
+    }
+
+    /* the lazy DFA skips the rest of a text without a match, a match of a pattern without newline characters
+       is found in the line of its end by the reverse DFA, so the exact search starts at the match start and only runs for the sub-expressions,
+       the DFAs of the cursor are freed with it, so a short text is searched by the exact search without building their states */
+    if (cursor->dfas != NULL && cursor->dfas->dfa.failed == 0 &&
+        (cursor->dfas != &cursor->own_dfas || cursor->dfas->dfa.num_states > 0 || cursor->text_length - cursor->read_position >= REGEX_DFA_MIN_TEXT_LENGTH) &&
+        (cursor->dfa_matches < REGEX_DFA_MIN_MATCHES || cursor->dfa_bytes >= REGEX_DFA_MIN_BYTES_PER_MATCH * cursor->dfa_matches))
+    {
+        match_end = _DFA__SEARCH(&cursor->dfas->dfa, cursor->text, cursor->read_position, cursor->text_length, cursor->eflags);
+
+        if (match_end == REGEX_DFA_NOMATCH)
+        {
+            cursor->finished = 1;
+            return REG_NOMATCH;
+        }
+
+        /* the DFAs only save time if they skip the text between the matches, dense matches are searched by the exact search */
+        if (match_end >= 0)
+        {
+            cursor->dfa_matches++;
+            cursor->dfa_bytes += match_end - cursor->read_position;
+        }
+
+        if (match_end >= 0 && cursor->dfas->dfa.program->single_line == 1)
+        {
+            match_end = _DFA__SEARCH_SPAN(&cursor->dfas->dfa, &cursor->dfas->reverse_dfa, &cursor->dfas->anchored_dfa,
+                cursor->text, match_end, cursor->read_position, cursor->text_length, cursor->eflags, &cursor->read_position);
+
+            if (match_end >= 0 && cursor->num_match_slots == 1)
+            {
+                cursor->match_offsets[0].rm_so = cursor->read_position;
+                cursor->match_offsets[0].rm_eo = match_end;
+                return_code = REGEX_MATCH_SUCCESS;
+            }
+        }
+    }
+
+    if (return_code == REGEX_MATCH_SUCCESS)
+    {
+        /* the match of the DFAs without sub-expressions */
+    }
+    else if (cursor->program != NULL)
+    {
+        /* the Pike VM searches in the bounds [read_position, text_length] like regexec() with REG_STARTEND */
+        return_code = _PIKE__EXEC(cursor->program, &cursor->workspace, cursor->text, cursor->read_position, cursor->text_length,
+            cursor->num_match_slots, cursor->match_offsets, cursor->eflags);
+    }
+#ifdef REG_STARTEND
+    else
+    {
+        /* search in the bounds [read_position, text_length], the context of "^" is taken from the preceding character
+           and the match offsets stay relative to the start of the input string */
+        cursor->match_offsets[0].rm_so = cursor->read_position;
+        cursor->match_offsets[0].rm_eo = cursor->text_length;
+        return_code = regexec(cursor->compiled_regex, cursor->text, cursor->num_match_slots, cursor->match_offsets, REG_STARTEND | cursor->eflags);
+    }
+#else
+    else
+    {
+        /* the read position is only a beginning of line at the text start or after a newline with REG_NEWLINE */
+        return_code = regexec(cursor->compiled_regex, cursor->text + cursor->read_position, cursor->num_match_slots, cursor->match_offsets,
+            ((cursor->read_position == 0 || (cursor->newline == 1 && cursor->text[cursor->read_position - 1] == '\n')) ? 0 : REG_NOTBOL) | cursor->eflags);
+
+        /* get start and end positions in original string */
+        for (i = 0; i < (int)cursor->num_match_slots; i++)
+        {
+            if (cursor->match_offsets[i].rm_so != -1)
+            {
+                cursor->match_offsets[i].rm_so += cursor->read_position;
+                cursor->match_offsets[i].rm_eo += cursor->read_position;
+            }
+        }
+    }
+#endif
+
+    if (return_code != REGEX_MATCH_SUCCESS)
+    {
+        cursor->finished = 1;
+        return return_code;
+    }
+
+    /* this match successful */
+    cursor->number_match += 1;
+    _EXEC__NUMBER_SUBMATCHES(cursor);
+
+    /* end position of match = next read positon */
+    cursor->read_position = cursor->match_offsets[0].rm_eo;
+
+    /* if "^" or "$": only start or end of string -> stop */
+    if (cursor->read_position >= cursor->text_length ||
+        cursor->match_offsets[0].rm_so == cursor->match_offsets[0].rm_eo)
+    {
+        cursor->finished = 1;
+    }
+
+    return return_code;
+}
+
+/* (Internal) Checks if a group of a match is a result by the REG_SUBEXP and REG_NOSUBEXP options. */
+static int _EXEC__IS_RESULT(RegEx regex_data, int number_submatch)
+{
+    return (number_submatch >= 0 &&
+            ((regex_data->flags.SUBEXP == 0 && regex_data->flags.NOSUBEXP == 0) ||                         /* add every result, if SUBEXP = 0 */
+             (regex_data->flags.SUBEXP == 0 && regex_data->flags.NOSUBEXP == 1 && number_submatch == 0) || /* add just the main matches, if NOSUBEXP = 1 */
+             (regex_data->flags.SUBEXP == 1 && number_submatch > 0)));
+}
+
+/* (Internal) Searches for all occurences of the regular expression pattern in the input text string. */
+static int _EXEC__SEARCH_GLOBAL(char* input_text_string, int input_text_length, RegEx regex_data, RegExResults results)
+{
+    int return_code_local = REG_NOMATCH;            /* return code for loop */
+    int return_code_global = -1;                    /* return code for function */ 
+    int return_code_append = REGEX_MATCH_SUCCESS;   /* REGEX_ERROR or REGEX_ERROR_MEMORY of the match arrays */
+    int i = 0;
+    cregcursor_t cursor;
+
+    if (_EXEC__INIT_CURSOR(&cursor, regex_data, input_text_string, input_text_length, &results->dfas) != REGEX_MATCH_SUCCESS)
+    {
+        results->return_code = REGEX_ERROR_MEMORY;
+        return REGEX_ERROR_MEMORY;
+    }
+
+    /* get next global match from the read position of the cursor */
+    while (return_code_append == REGEX_MATCH_SUCCESS &&
+           (return_code_local = _EXEC__NEXT_MATCH(&cursor)) == REGEX_MATCH_SUCCESS)
+    {
+        /* set function return code to 0 */
+        return_code_global = REGEX_MATCH_SUCCESS;
+
+        /* copy single iteration match with the match number and group number into regex_h matches */
+        for (i = 0; i < (int)cursor.num_match_slots; i++)
+        {
+            if (_EXEC__IS_RESULT(regex_data, cursor.submatch_numbers[i]) &&
+                (return_code_append = _EXEC__APPEND_MATCH(results, &cursor.match_offsets[i], cursor.number_match, cursor.submatch_numbers[i])) != REGEX_MATCH_SUCCESS)
+            {
+                results->return_code = return_code_append;
+                break;
+            }
+        }
+    }
+
+    _EXEC__FREE_CURSOR(&cursor);
+
+    /* copy substrings from input text with match_offsets data */
+    if (return_code_append != REGEX_MATCH_SUCCESS)
+    {
+        return_code_global = return_code_append;
+    }
+    else if (return_code_global == REGEX_MATCH_SUCCESS)
+    {
+        return_code_global = _EXEC__GET_MATCHED_STRINGS(input_text_string, results);
+    }
+    else
+    {
+        return_code_global = return_code_local;
+    }
+
+    return return_code_global;
+}
+
+/* (Internal) Searches with the result data outside of the compiled RegEx object. */
+static int _EXEC__SEARCH(char* input_text_string, int input_text_length, RegEx regex_data, RegExResults results)
+{
+    /* REG_GLOBAL set: search the whole text string for multiple matches of the regular expression */
+    if (regex_data->flags.GLOBAL == 0)
+    {
+        return _EXEC__SEARCH_LOCAL(input_text_string, input_text_length, regex_data, results);
+    }
+#ifdef REGEX_PARALLEL_SEARCH
+    /* REG_PARALLEL set: search text chunks with threads, if the matches can not span lines */
+    else if (regex_data->flags.PARALLEL == 1 && regex_data->flags.NEWLINE == 1)
+    {
+        return _EXEC__SEARCH_PARALLEL(input_text_string, input_text_length, regex_data, results);
+    }
+#endif
+    else
+    {
+        return _EXEC__SEARCH_GLOBAL(input_text_string, input_text_length, regex_data, results);
+    }
+}
+
+#ifdef REGEX_PARALLEL_SEARCH
+/* (Internal) Checks if no match of a REG_NEWLINE pattern can contain a newline character or depends on the text bounds. */
+static int _PARALLEL__IS_LINE_PATTERN(RegEx regex_data)
+{
+    int IS_LINE_PATTERN = 1;
+    char* read_ptr;
+    char* converted_regex_pattern_string = _COMPILE__CONVERT_SEQUENCES(regex_data->pattern);
+
+    /* without memory for the check: sequential search */
+    if (converted_regex_pattern_string == NULL)
+    {
+        return 0;
+    }
+
+    /* with REG_NEWLINE "." and non-matching lists do not match a newline, but a newline character,
+       a range from a control character or the classes [:space:] and [:cntrl:] can match it */
+    for (read_ptr = converted_regex_pattern_string; *read_ptr != '\0'; read_ptr++)
+    {
+        if (*read_ptr == '\n' ||
+            ((unsigned char)*read_ptr < 0x20 && *(read_ptr + 1) == '-'))
+        {
+            IS_LINE_PATTERN = 0;
+        }
+
+        /* the GNU anchors "\`" and "\'" would match at the bounds of each chunk instead of the bounds of the text */
+        if (*read_ptr == '\\' && (*(read_ptr + 1) == '`' || *(read_ptr + 1) == '\''))
+        {
+            IS_LINE_PATTERN = 0;
+        }
+    }
+
+    if (strstr(converted_regex_pattern_string, "[:space:]") != NULL ||
+        strstr(converted_regex_pattern_string, "[:cntrl:]") != NULL ||
+        strstr(converted_regex_pattern_string, "[.") != NULL ||
+        strstr(converted_regex_pattern_string, "[=") != NULL)
+    {
+        IS_LINE_PATTERN = 0;
+    }
+
+    __FREE(converted_regex_pattern_string);
+
+    return IS_LINE_PATTERN;
+}
+
+/* (Internal) Searches for all occurences of the regular expression pattern in a text chunk. */
+static void _PARALLEL__SEARCH_CHUNK(cregparallel_t* parallel, regex_t* compiled_regex, cregdfa_set_t* dfas, cregchunk_t* chunk)
+{
+    int i = 0;
+    cregcursor_t cursor;
+
+    regex_results_init(&chunk->results);
+    chunk->halted = 0;
+
+    /* search in the bounds [start, end] of the chunk, the contexts of "^" and "$" come from the whole text */
+    if (_EXEC__INIT_CURSOR(&cursor, parallel->regex, parallel->text, chunk->end, dfas) != REGEX_MATCH_SUCCESS)
+    {
+        chunk->results.return_code = REGEX_ERROR_MEMORY;
+        chunk->number_match = 0;
+        chunk->halted = 1;
+        return;
+    }
+
+    cursor.compiled_regex = compiled_regex;
+    cursor.read_position = chunk->start;
+
+    while (chunk->halted == 0 && _EXEC__NEXT_MATCH(&cursor) == REGEX_MATCH_SUCCESS)
+    {
+        /* the sequential search continues at the newline after a match ending at the chunk end,
+           where only an empty match is possible */
+        if (cursor.finished == 1 &&
+            cursor.read_position == chunk->end &&
+            chunk->end < parallel->text_length &&
+            cursor.match_offsets[0].rm_so != cursor.match_offsets[0].rm_eo)
+        {
+            cursor.finished = 0;
+        }
+
+        /* an empty match stops the global search */
+        if (cursor.match_offsets[0].rm_so == cursor.match_offsets[0].rm_eo)
+        {
+            chunk->halted = 1;
+        }
+
+        for (i = 0; i < (int)cursor.num_match_slots; i++)
+        {
+            /* without memory the merge stops at this chunk */
+            if (_EXEC__IS_RESULT(parallel->regex, cursor.submatch_numbers[i]) &&
+                _EXEC__APPEND_MATCH(&chunk->results, &cursor.match_offsets[i], cursor.number_match, cursor.submatch_numbers[i]) != REGEX_MATCH_SUCCESS)
+            {
+                chunk->results.return_code = REGEX_ERROR_MEMORY;
+                chunk->halted = 1;
+                break;
+            }
+        }
+    }
+
+    chunk->number_match = cursor.number_match;
+    _EXEC__FREE_CURSOR(&cursor);
+}
+
+/* (Internal) Searches the next chunks with a compiled pattern and the lazy DFAs of a thread until all chunks are searched. */
+static void _PARALLEL__SEARCH_CHUNKS(cregparallel_t* parallel, regex_t* compiled_regex, cregdfa_set_t* dfas)
+{
+    int chunk_index = 0;
+
+    RegExContext previous_context = regex_context_set(&parallel->context);
+
+    while (1)
+    {
+        pthread_mutex_lock(&parallel->mutex);
+        chunk_index = parallel->next_chunk++;
+        pthread_mutex_unlock(&parallel->mutex);
+
+        if (chunk_index >= parallel->num_chunks)
+        {
+            break;
+        }
+
+        _PARALLEL__SEARCH_CHUNK(parallel, compiled_regex, dfas, &parallel->chunks[chunk_index]);
+    }
+
+    regex_context_set(previous_context);
+}
+
+/* (Internal) Thread function, searches the next chunks until all chunks are searched. */
+static void* _PARALLEL__WORKER(void* parallel_data)
+{
+    cregparallel_t* parallel = parallel_data;
+    regex_t compiled_regex;
+    cregdfa_set_t dfas;
+
+    /* the states of the lazy DFAs are built by each thread and kept from chunk to chunk */
+    _DFA__INIT_SET(&dfas);
+
+    /* the regex.h library serializes the regexec() calls on one compiled pattern,
+       so the additional threads search with their own copy, the Pike VM program is shared */
+    if (parallel->converted_pattern != NULL &&
+        regcomp(&compiled_regex, parallel->converted_pattern, parallel->regex->regex_h.reglib_flags) == REGEX_COMP_SUCCESS)
+    {
+        _PARALLEL__SEARCH_CHUNKS(parallel, &compiled_regex, &dfas);
+        regfree(&compiled_regex);
+    }
+    else
+    {
+        _PARALLEL__SEARCH_CHUNKS(parallel, &parallel->regex->regex_h.compiled_regex, &dfas);
+    }
+
+    _DFA__FREE_SET(&dfas);
+
+    return NULL;
+}
+
+/* (Internal) Searches for all occurences of the regular expression pattern with threads on text chunks split at newlines. */
+static int _EXEC__SEARCH_PARALLEL(char* input_text_string, int input_text_length, RegEx regex_data, RegExResults results)
+{
+    int return_code = REG_NOMATCH;
+    int return_code_append = REGEX_MATCH_SUCCESS;
+    int i = 0;
+    int j = 0;
+    int num_threads = (int)_CONTEXT(num_threads, NUM_THREADS);
+    int num_started = 0;
+    int num_chunks = input_text_length / REGEX_PARALLEL_MIN_CHUNK_LENGTH;
+    int chunk_start = 0;
+    int NUMBER_MATCH_OFFSET = 0;
+    char* newline_ptr;
+    pthread_t* threads;
+    cregparallel_t parallel;
+
+    if (num_threads == 0)
+    {
+        num_threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    }
+
+    /* about four chunks per thread for an even load */
+    if (num_chunks > num_threads * 4)
+    {
+        num_chunks = num_threads * 4;
+    }
+
+    /* small texts and patterns which can match a newline: sequential search */
+    if (num_threads < 2 || num_chunks < 2 || !_PARALLEL__IS_LINE_PATTERN(regex_data))
+    {
+        return _EXEC__SEARCH_GLOBAL(input_text_string, input_text_length, regex_data, results);
+    }
+
+    parallel.chunks = __TRY_MALLOC(num_chunks * sizeof(cregchunk_t));
+    threads = __TRY_MALLOC(num_threads * sizeof(pthread_t));
+
+    /* without memory for the threads: sequential search */
+    if (parallel.chunks == NULL || threads == NULL)
+    {
+        if (parallel.chunks != NULL)
+        {
+            __FREE(parallel.chunks);
+        }
+        if (threads != NULL)
+        {
+            __FREE(threads);
+        }
+
+        return _EXEC__SEARCH_GLOBAL(input_text_string, input_text_length, regex_data, results);
+    }
+
+    parallel.regex = regex_data;
+    parallel.converted_pattern = (_PIKE__SEARCH_PROGRAM(regex_data) == NULL) ? _COMPILE__CONVERT_SEQUENCES(regex_data->pattern) : NULL;
+    parallel.text = input_text_string;
+    parallel.text_length = input_text_length;
+    parallel.num_chunks = 0;
+    parallel.next_chunk = 0;
+    pthread_mutex_init(&parallel.mutex, NULL);
+
+    /* the threads use the limits and options of the calling thread, MAX_NUM_MATCHES is checked by the merge */
+    if (_CONTEXT__GET() != NULL)
+    {
+        parallel.context = *_CONTEXT__GET();
+    }
+    else
+    {
+        regex_context_init(&parallel.context);
+    }
+
+    parallel.context.max_num_matches = 0;
+
+    /* split the text at the first newline after each chunk length */
+    while (chunk_start < input_text_length && parallel.num_chunks < num_chunks)
+    {
+        cregchunk_t* chunk = &parallel.chunks[parallel.num_chunks++];
+        int chunk_end = chunk_start + (input_text_length - chunk_start) / (num_chunks - parallel.num_chunks + 1);
+
+        newline_ptr = parallel.num_chunks < num_chunks ? memchr(input_text_string + chunk_end, '\n', input_text_length - chunk_end) : NULL;
+
+        chunk->start = chunk_start;
+        chunk->end = newline_ptr != NULL ? (int)(newline_ptr - input_text_string) : input_text_length;
+        chunk_start = chunk->end + 1;
+    }
+
+    /* search the chunks with the calling thread and up to num_threads - 1 additional threads,
+       the calling thread also takes the chunks of threads which could not be created */
+    for (num_started = 1; num_started < num_threads; num_started++)
+    {
+        if (pthread_create(&threads[num_started], NULL, _PARALLEL__WORKER, &parallel) != 0)
+        {
+            break;
+        }
+    }
+
+    _PARALLEL__SEARCH_CHUNKS(&parallel, &regex_data->regex_h.compiled_regex, &results->dfas);
+
+    for (i = 1; i < num_started; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+
+    if (parallel.converted_pattern != NULL)
+    {
+        __FREE(parallel.converted_pattern);
+    }
+
+    __FREE(threads);
+    pthread_mutex_destroy(&parallel.mutex);
+
+    /* merge the chunk results in offset order with the global match numbers */
+    for (i = 0; i < parallel.num_chunks; i++)
+    {
+        cregchunk_t* chunk = &parallel.chunks[i];
+
+        /* the matches of a chunk without memory are incomplete */
+        if (chunk->results.return_code == REGEX_ERROR_MEMORY && return_code_append == REGEX_MATCH_SUCCESS)
+        {
+            return_code_append = REGEX_ERROR_MEMORY;
+        }
+
+        for (j = 0; j < chunk->results.num_matches && return_code_append == REGEX_MATCH_SUCCESS; j++)
+        {
+            return_code_append = _EXEC__APPEND_MATCH(results, &chunk->results.match_offsets[j],
+                chunk->results.matches[j].number_match + NUMBER_MATCH_OFFSET, chunk->results.matches[j].number_submatch);
+        }
+
+        if (chunk->number_match > 0)
+        {
+            return_code = REGEX_MATCH_SUCCESS;
+        }
+
+        NUMBER_MATCH_OFFSET += chunk->number_match;
+        regex_results_free(&chunk->results);
+
+        /* an empty match stops the global search, the following chunks are not used */
+        if (chunk->halted == 1)
+        {
+            for (j = i + 1; j < parallel.num_chunks; j++)
+            {
+                regex_results_free(&parallel.chunks[j].results);
+            }
+            break;
+        }
+    }
+
+    __FREE(parallel.chunks);
+
+    if (return_code_append != REGEX_MATCH_SUCCESS)
+    {
+        results->return_code = return_code_append;
+        return_code = return_code_append;
+    }
+
+    /* copy substrings from input text */
+    if (return_code == REGEX_MATCH_SUCCESS)
+    {
+        return_code = _EXEC__GET_MATCHED_STRINGS(input_text_string, results);
+    }
+
+    return return_code;
+}
+#endif
+
+/* (Internal) Matches one text of a batch with the scratch cursor of a thread. */
+static void _BATCH__MATCH_TEXT(cregbatch_t* batch, cregcursor_t* cursor, size_t index)
+{
+    cregbatch_result_t* result = &batch->results[index];
+
+    result->num_matches = 0;
+    result->start = -1;
+    result->end = -1;
+
+    if (batch->texts[index] == NULL)
+    {
+        result->return_code = REGEX_ERROR;
+        return;
+    }
+
+    /* reuse the buffers of the cursor for each text */
+    cursor->text = (char*)batch->texts[index];
+    cursor->text_length = (int)strlen(batch->texts[index]);
+    cursor->read_position = 0;
+    cursor->number_match = 0;
+    cursor->finished = 0;
+    cursor->dfa_matches = 0;
+    cursor->dfa_bytes = 0;
+
+    /* the lazy DFAs of the thread keep their states from text to text */
+    if (cursor->dfas != NULL)
+    {
+        _DFA__PREPARE_SET(cursor->dfas, batch->regex->regex_h.program);
+    }
+
+    result->return_code = _EXEC__NEXT_MATCH(cursor);
+
+    if (result->return_code == REGEX_MATCH_SUCCESS)
+    {
+        result->start = (int)cursor->match_offsets[0].rm_so;
+        result->end = (int)cursor->match_offsets[0].rm_eo;
+
+        /* REG_GLOBAL set: count the further matches */
+        if (batch->regex->flags.GLOBAL == 1)
+        {
+            while (_EXEC__NEXT_MATCH(cursor) == REGEX_MATCH_SUCCESS);
+        }
+
+        result->num_matches = cursor->number_match;
+    }
+}
+
+/* (Internal) Takes the next block of texts of a thread or steals half of the remaining texts of another thread. */
+static int _BATCH__NEXT_BLOCK(cregbatch_worker_t* worker, size_t* block_start, size_t* block_end)
+{
+    cregbatch_t* batch = worker->batch;
+    cregbatch_worker_t* victim;
+    size_t steal_start = 0;
+    size_t num_stolen = 0;
+    int i = 0;
+
+    while (1)
+    {
+        _BATCH__LOCK(worker);
+
+        if (worker->next < worker->end)
+        {
+            *block_start = worker->next;
+            *block_end = (worker->end - worker->next > REGEX_BATCH_BLOCK_SIZE) ? worker->next + REGEX_BATCH_BLOCK_SIZE : worker->end;
+            worker->next = *block_end;
+            _BATCH__UNLOCK(worker);
+
+            return 1;
+        }
+
+        _BATCH__UNLOCK(worker);
+
+        /* own range finished: steal the second half of the remaining texts of the next thread with texts left,
+           only one lock is held at a time */
+        num_stolen = 0;
+
+        for (i = 1; i < batch->num_threads && num_stolen == 0; i++)
+        {
+            victim = &batch->workers[(worker->index + i) % batch->num_threads];
+
+            _BATCH__LOCK(victim);
+
+            if (victim->next < victim->end)
+            {
+                num_stolen = (victim->end - victim->next + 1) / 2;
+                victim->end -= num_stolen;
+                steal_start = victim->end;
+            }
+
+            _BATCH__UNLOCK(victim);
+        }
+
+        /* all texts taken */
+        if (num_stolen == 0)
+        {
+            return 0;
+        }
+
+        _BATCH__LOCK(worker);
+        worker->next = steal_start;
+        worker->end = steal_start + num_stolen;
+        _BATCH__UNLOCK(worker);
+    }
+}
+
+/* (Internal) Thread function, matches blocks of texts until all texts are matched. */
+static void* _BATCH__WORKER(void* worker_data)
+{
+    cregbatch_worker_t* worker = worker_data;
+    cregcursor_t cursor;
+    regex_t compiled_regex;
+    cregdfa_set_t dfas;
+    size_t block_start = 0;
+    size_t block_end = 0;
+    size_t i = 0;
+
+    /* scratch buffers and lazy DFAs of this thread, only the offsets of the main match are needed,
+       without memory the other threads take the texts of this thread */
+    _DFA__INIT_SET(&dfas);
+
+    if (_EXEC__INIT_CURSOR(&cursor, worker->batch->regex, "", 0, &dfas) != REGEX_MATCH_SUCCESS)
+    {
+        return NULL;
+    }
+
+    cursor.num_match_slots = 1;
+
+    /* the regex.h library serializes the regexec() calls on one compiled pattern,
+       so the additional threads search with their own copy, the Pike VM program is shared */
+    if (worker->index > 0 && worker->batch->converted_pattern != NULL && cursor.program == NULL &&
+        regcomp(&compiled_regex, worker->batch->converted_pattern, worker->batch->regex->regex_h.reglib_flags) == REGEX_COMP_SUCCESS)
+    {
+        cursor.compiled_regex = &compiled_regex;
+    }
+
+    while (_BATCH__NEXT_BLOCK(worker, &block_start, &block_end))
+    {
+        for (i = block_start; i < block_end; i++)
+        {
+            _BATCH__MATCH_TEXT(worker->batch, &cursor, i);
+        }
+    }
+
+    if (cursor.compiled_regex == &compiled_regex)
+    {
+        regfree(&compiled_regex);
+    }
+
+    _EXEC__FREE_CURSOR(&cursor);
+    _DFA__FREE_SET(&dfas);
+
+    return NULL;
+}
+
+/* (Internal) Replaces all group classifiers in a replacement string (\1, \2...) with the matched groups of a regular expression. */
+static char* _REPLACE__PREPROCESS_GROUPS(RegEx regex_data, char* replace_substring, int match_number)
+{
+    int n = 0;
+    int group_classifier = 1;
+    int top_match = 0;
+
+    char* converted_replace_substring = __MALLOC(_CONTEXT(max_pattern_length, MAX_PATTERN_LENGTH) * sizeof(char));
+    char* temp_string_1 = __MALLOC(_CONTEXT(max_pattern_length, MAX_PATTERN_LENGTH) * sizeof(char));
+    char* temp_string_2 = __MALLOC(8 * sizeof(char));
+
+    strcpy(converted_replace_substring, replace_substring);
+
+    /* \1 ... \99 */
+    for (group_classifier = 1; group_classifier <= 99; group_classifier++)
+    {
+        n = match_number + group_classifier;
+
+        strcpy(temp_string_1, "\\");
+        sprintf(temp_string_2, "%d", group_classifier);
+        strcat(temp_string_1, temp_string_2);
+
+        if (top_match == 0)
+        {
+            if (n >= regex_data->num_matches || regex_data->matches[n].number_submatch == 0)
+            {
+                top_match = 1;
+            }
+            else
+            {
+                converted_replace_substring = __SUBSTITUTE_STRING(converted_replace_substring, temp_string_1, regex_data->matches[n].string, REPLACE_NO_BRACKETS, REPLACE_GLOBAL, 0); 
+            }
+        }
+        if (top_match == 1)
+        {
+            converted_replace_substring = __SUBSTITUTE_STRING(converted_replace_substring, temp_string_1, "", REPLACE_NO_BRACKETS, REPLACE_GLOBAL, 0);
+        }
+    }
+
+    __FREE(temp_string_1);
+    __FREE(temp_string_2);
+
+    return converted_replace_substring;
+}
+
+/* (Internal) Initializes an empty output string. */
+static void _PRINT__STRING_INIT(cregstring_t* output, size_t capacity)
+{
+    output->data = __MALLOC(capacity * sizeof(char));
+    output->data[0] = '\0';
+    output->length = 0;
+    output->capacity = capacity;
+}
+
+/* (Internal) Appends a string to an output string, without rescanning the output string. */
+static void _PRINT__APPEND(cregstring_t* output, char* string)
+{
+    _PRINT__APPEND_LENGTH(output, string, strlen(string));
+}
+
+/* (Internal) Appends the first characters of a string to an output string. */
+static void _PRINT__APPEND_LENGTH(cregstring_t* output, const char* string, size_t length)
+{
+    /* double the capacity, so the output string is copied O(log n) times */
+    if (output->length + length + 1 > output->capacity)
+    {
+        while (output->length + length + 1 > output->capacity)
+        {
+            output->capacity *= 2;
+        }
+
+        output->data = __REALLOC(output->data, output->capacity * sizeof(char));
+    }
+
+    memcpy(output->data + output->length, string, length * sizeof(char));
+    output->length += length;
+    output->data[output->length] = '\0';
+}
+
+/* (Internal) Copies a string with escaped carriage return and newline characters, and escaped backslashes for JSON. */
+static char* _PRINT__ESCAPE_STRING(char* escaped_string, char* string, int escape_backslashes)
+{
+    char* ptr = NULL;
+
+    /* each character needs up to three characters */
+    escaped_string = __REALLOC(escaped_string, (3 * strlen(string) + 256) * sizeof(char));
+    ptr = escaped_string;
+
+    for (; *string != '\0'; string++)
+    {
+        if (*string == '\r' || *string == '\n')
+        {
+            *ptr++ = '\\';
+
+            /* the backslash of the sequence is escaped too */
+            if (escape_backslashes)
+            {
+                *ptr++ = '\\';
+            }
+
+            *ptr++ = (*string == '\r') ? 'r' : 'n';
+        }
+        else if (*string == '\\' && escape_backslashes)
+        {
+            *ptr++ = '\\';
+            *ptr++ = '\\';
+        }
+        else
+        {
+            *ptr++ = *string;
+        }
+    }
+
+    *ptr = '\0';
+
+    return escaped_string;
+}
+
+/* (Intenal) Concatinates substrings of option flag names to the option falgs string */
+static char* _PRINT__CONCAT_OPTION_FLAGS(RegEx regex_data)
+{
+    char* option_flags_string = __MALLOC(128 * sizeof(char));
+    strcpy(option_flags_string, "");
+
+    if (regex_data->flags.GLOBAL == 1)
+    {
+        strcpy(option_flags_string, "REG_GLOBAL");
+    }
+    if (regex_data->flags.EXTENDED == 1)
+    {
+        if (strcmp(option_flags_string, ""))
+        {
+            strcat(option_flags_string, " | ");
+        }
+        strcat(option_flags_string, "REG_EXTENDED");
+    }
+    if (regex_data->flags.ICASE == 1)
+    {
+        if (strcmp(option_flags_string, ""))
+        {
+            strcat(option_flags_string, " | ");
+        }
+        strcat(option_flags_string, "REG_ICASE");
+    }
+    if (regex_data->flags.MULTILINE == 1)
+    {
+        if (strcmp(option_flags_string, ""))
+        {
+            strcat(option_flags_string, " | ");
+        }
+        strcat(option_flags_string, "REG_MULTILINE");
+    }
+    if (regex_data->flags.NEWLINE == 1)
+    {
+        if (strcmp(option_flags_string, ""))
+        {
+            strcat(option_flags_string, " | ");
+        }
+        strcat(option_flags_string, "REG_NEWLINE");
+    }
+    if (regex_data->flags.NOSUB == 1)
+    {
+        if (strcmp(option_flags_string, ""))
+        {
+            strcat(option_flags_string, " | ");
+        }
+        strcat(option_flags_string, "!(REG_NOSUB)");
+    }
+    if (regex_data->flags.NOSUBEXP == 1)
+    {
+        if (strcmp(option_flags_string, ""))
+        {
+            strcat(option_flags_string, " | ");
+        }
+        strcat(option_flags_string, "REG_NOSUBEXP");
+    }
+    if (regex_data->flags.SUBEXP == 1)
+    {
+        if (strcmp(option_flags_string, ""))
+        {
+            strcat(option_flags_string, " | ");
+        }
+        strcat(option_flags_string, "REG_SUBEXP");
+    }
+    if (regex_data->flags.PARALLEL == 1)
+    {
+        if (strcmp(option_flags_string, ""))
+        {
+            strcat(option_flags_string, " | ");
+        }
+        strcat(option_flags_string, "REG_PARALLEL");
+    }
+    if (regex_data->flags.PIKEVM == 1)
+    {
+        if (strcmp(option_flags_string, ""))
+        {
+            strcat(option_flags_string, " | ");
+        }
+        strcat(option_flags_string, "REG_PIKEVM");
+    }
+    if (regex_data->flags.LAZYDFA == 1)
+    {
+        if (strcmp(option_flags_string, ""))
+        {
+            strcat(option_flags_string, " | ");
+        }
+        strcat(option_flags_string, "REG_LAZYDFA");
+    }
+
+    return option_flags_string;
+}
+
+/* (Internal) Returns the length of the input text string for printing or writing */
+static size_t _PRINT__TEXT_LENGTH(RegEx regex_data)
+{
+    /* the text of REG_NOCOPY has no terminating NUL byte, the placeholder of an unexecuted object has no length */
+    if (regex_data->regex_h.reglib_status == REGLIB_EXECUTED)
+    {
+        return (size_t)regex_data->text_length;
+    }
+
+    return strlen(regex_data->text);
+}
+
+/* (Internal) Appends the input text string for printing or writing  */
+static void _PRINT__APPEND_TEXT_STRING(RegEx regex_data, cregstring_t* output)
+{
+    char temp_string[128];
+    size_t text_length = _PRINT__TEXT_LENGTH(regex_data);
+
+    if (_CONTEXT(max_print_text_length, MAX_PRINT_TEXT_LENGTH) > 0 && text_length > _CONTEXT(max_print_text_length, MAX_PRINT_TEXT_LENGTH))
+    {
+        if (_CONTEXT(print_colored, PRINT_COLORED) == 1)
+        {
+            sprintf(temp_string, "\033[34mText (first %d characters):\033[0m\n", _CONTEXT(max_print_text_length, MAX_PRINT_TEXT_LENGTH));
+        }
+        else
+        {
+            sprintf(temp_string, "Text (first %d characters):\n", _CONTEXT(max_print_text_length, MAX_PRINT_TEXT_LENGTH));
+        }
+
+        _PRINT__APPEND(output, temp_string);
+        _PRINT__APPEND_LENGTH(output, regex_data->text, _CONTEXT(max_print_text_length, MAX_PRINT_TEXT_LENGTH));
+
+        if (_CONTEXT(print_colored, PRINT_COLORED) == 1)
+        {
+            _PRINT__APPEND(output, "\033[90m[...]\n[...]\033[0m");
+        }
+        else
+        {
+            _PRINT__APPEND(output, "[...]\n[...]");
+        }
+    }
+    else
+    {
+        if (_CONTEXT(print_colored, PRINT_COLORED) == 1)
+        {
+            _PRINT__APPEND(output, "\033[34mText:\033[0m\n");
+        }
+        else
+        {
+            _PRINT__APPEND(output, "Text:\n");
+        }
+
+        _PRINT__APPEND_LENGTH(output, regex_data->text, text_length);
+    }
+
+    if (_CONTEXT(print_colored, PRINT_COLORED) == 1)
+    {
+        sprintf(temp_string, "\n\n\033[36mString-length:\033[0m    %d\n\n", (int)text_length);
+    }
+    else
+    {
+        sprintf(temp_string, "\n\nString-length:    %d\n\n", (int)text_length);
+    }
+
+    _PRINT__APPEND(output, temp_string);
+}
+
+#if defined(REGEX_CONTEXT_KEY)
+/* (Internal) Creates the pthread key of the thread contexts */
+static void _CONTEXT__CREATE_KEY(void)
+{
+    pthread_key_create(&REGEX_THREAD_CONTEXT_KEY, NULL);
+}
+
+/* (Internal) Returns the context of the calling thread from the pthread key */
+static RegExContext _CONTEXT__GET_KEY(void)
+{
+    pthread_once(&REGEX_THREAD_CONTEXT_ONCE, _CONTEXT__CREATE_KEY);
+
+    return (RegExContext)pthread_getspecific(REGEX_THREAD_CONTEXT_KEY);
+}
+
+/* (Internal) Stores the context of the calling thread in the pthread key */
+static void _CONTEXT__SET_KEY(RegExContext context)
+{
+    pthread_once(&REGEX_THREAD_CONTEXT_ONCE, _CONTEXT__CREATE_KEY);
+    pthread_setspecific(REGEX_THREAD_CONTEXT_KEY, context);
+}
+#endif
+
+/* (Internal) Sets a copy of the current limits and options as the context of the calling thread. */
+static RegExContext _CONTEXT__OVERRIDE(RegExContext override_context)
+{
+    RegExContext previous_context = _CONTEXT__GET();
+
+    if (previous_context != NULL)
+    {
+        *override_context = *previous_context;
+    }
+    else
+    {
+        regex_context_init(override_context);
+    }
+
+    _CONTEXT__SET(override_context);
+
+    return previous_context;
+}
+
+/* (Internal) Processes the data string of the RegEx Object for printing or writing  */
+static char* _PRINT__GET_REGEX_STATS(RegEx regex_data, char* option_flags_string)
+{
+    char* regex_data_string = __MALLOC((_CONTEXT(max_pattern_length, MAX_PATTERN_LENGTH) + 512) * sizeof(char));
+    char* temp_string = __MALLOC((_CONTEXT(max_pattern_length, MAX_PATTERN_LENGTH) + 256) * sizeof(char));
+    char* filename_string;
+
+    strcpy(temp_string, regex_data->pattern);
+    temp_string = __SUBSTITUTE_STRING(temp_string, "\r", "\\r", REPLACE_NO_BRACKETS, REPLACE_GLOBAL, 0);
+    temp_string = __SUBSTITUTE_STRING(temp_string, "\n", "\\n", REPLACE_NO_BRACKETS, REPLACE_GLOBAL, 0);
+
+    if (_CONTEXT(print_colored, PRINT_COLORED) == 1)
+    {
+        sprintf(regex_data_string, "\
+\033[34mRegex-Pattern:\033[0m    %s\n\
+\033[36mRegex-Flags:\033[0m      %s\n\
+\033[36mSub-Expressions:\033[0m  %d\n\
+\033[36mTotal Matches:\033[0m    %d\n\
+\033[36mReturn Code:\033[0m      %i\n\
+\033[36mError Message:\033[0m    %s\n\n",
+temp_string,
+option_flags_string,
+regex_data->num_pattern_subexpr,
+regex_data->num_matches,
+regex_data->return_code,
+regex_data->error_message);
+    }
+    else
+    {
+        sprintf(regex_data_string, "\
+Regex-Pattern:    %s\n\
+Regex-Flags:      %s\n\
+Sub-Expressions:  %d\n\
+Total Matches:    %d\n\
+Return Code:      %i\n\
+Error Message:    %s\n\n",
+temp_string,
+option_flags_string,
+regex_data->num_pattern_subexpr,
+regex_data->num_matches,
+regex_data->return_code,
+regex_data->error_message);
+    }
+
+    if (regex_data->file != NULL && regex_data->file->length > 0)
+    {
+        filename_string = __MALLOC((_CONTEXT(max_filename_length, MAX_FILENAME_LENGTH)) * sizeof(char));
+        regex_data_string = __REALLOC(regex_data_string, (_CONTEXT(max_filename_length, MAX_FILENAME_LENGTH) + _CONTEXT(max_pattern_length, MAX_PATTERN_LENGTH) + 512) * sizeof(char));
+
+        /* shift and prepend */
+        if (_CONTEXT(print_colored, PRINT_COLORED) == 1)
+        {
+            sprintf(filename_string, "\033[36mFilename:\033[0m         %s\n\n", regex_data->file->name);
+        }
+        else
+        {
+            sprintf(filename_string, "Filename:         %s\n\n", regex_data->file->name);
+        }
+        
+        memmove(regex_data_string + strlen(filename_string), regex_data_string, strlen(regex_data_string) + 1);
+        memcpy(regex_data_string, filename_string, strlen(filename_string));
+    }
+
+    __FREE(option_flags_string);
+    __FREE(temp_string);
+
+    return regex_data_string;
+}
+
+/* (Internal) Processes the result data string of the RegEx Object for printing or writing  */
+static char* _PRINT__GET_RESULTS(RegEx regex_data, int PRINT_LAYOUT, int print_header, int print_position)
+{
+    int i;
+    char temp_str_buffer[4][32];
+    char PRINTF_FORMAT_STR[64];
+    cregstring_t result;
+    char* output_string = __MALLOC(256 * sizeof(char));
+    char* substring = __MALLOC(256 * sizeof(char));
+    
+    _PRINT__STRING_INIT(&result, 256);
+    
+    if (regex_data->num_matches > 0)
+    {
+        if (print_header == 1)
+        {
+            if (_CONTEXT(print_colored, PRINT_COLORED) == 1)
+            {
+                _PRINT__APPEND(&result, "\033[34mResults:\033[0m\n");
+            }
+            else
+            {
+                _PRINT__APPEND(&result, "Results:\n");
+            }
+        }
+        if (PRINT_LAYOUT == REGEX_PRINT_CSV)
+        {
+            if (print_position)
+            {
+                if (_CONTEXT(print_colored, PRINT_COLORED) == 1)
+                {
+                    _PRINT__APPEND(&result, "\033[36mnumber;match;submatch;start;end;substring;\033[0m\n");
+                }
+                else
+                {
+                    _PRINT__APPEND(&result, "number;match;submatch;start;end;substring;\n");
+                }
+            }
+            else
+            {
+                if (_CONTEXT(print_colored, PRINT_COLORED) == 1)
+                {
+                    _PRINT__APPEND(&result, "\033[36mnumber;match;submatch;substring;\033[0m\n");
+                }
+                else
+                {
+                    _PRINT__APPEND(&result, "number;match;submatch;substring;\n");
+                }
+            }       
+        }
+        if (PRINT_LAYOUT == REGEX_PRINT_TABLE)
+        {
+            /* count number of digits to set space holder */
+            sprintf(temp_str_buffer[0], "%d", regex_data->matches[regex_data->num_matches-1].end);
+            
+            if (print_position)
+            {
+                if (_CONTEXT(print_colored, PRINT_COLORED) == 1)
+                {
+                    sprintf(output_string, "\033[36m#   Match   Submatch    Start  %*sEnd     Substring\033[0m\n", (int)strlen(temp_str_buffer[0]), " ");
+                }
+                else
+                {
+                    sprintf(output_string, "#   Match   Submatch    Start  %*sEnd     Substring\n", (int)strlen(temp_str_buffer[0]), " ");
+                }
+            }
+            else
+            {
+                if (_CONTEXT(print_colored, PRINT_COLORED) == 1)
+                {
+                    sprintf(output_string, "\033[36m#   Match   Submatch     Substring\033[0m\n");
+                }
+                else
+                {
+                    sprintf(output_string, "#   Match   Submatch     Substring\n");
+                }
+            }
+
+            _PRINT__APPEND(&result, output_string);
+        }
+        if (PRINT_LAYOUT == REGEX_PRINT_JSON)
+        {
+            output_string = __REALLOC(output_string, (_CONTEXT(max_pattern_length, MAX_PATTERN_LENGTH) + 256) * sizeof(char));
+            substring = __REALLOC(substring, (_CONTEXT(max_pattern_length, MAX_PATTERN_LENGTH) + 256) * sizeof(char));
+            /* temporary: use substring for pattern substitution */
+            strcpy(substring, regex_data->pattern);
+            substring = __SUBSTITUTE_STRING(substring, "\r", "\\r", REPLACE_NO_BRACKETS, REPLACE_GLOBAL, 0);
+            substring = __SUBSTITUTE_STRING(substring, "\n", "\\n", REPLACE_NO_BRACKETS, REPLACE_GLOBAL, 0);
+            substring = __SUBSTITUTE_STRING(substring, "\\", "\\\\", REPLACE_NO_BRACKETS, REPLACE_GLOBAL, 0);
+
+            if (_CONTEXT(print_colored, PRINT_COLORED) == 1)
+            {
+                sprintf(output_string, "{\n\
+\t\033[36m\"text-length\":\033[0m %d\033[90m,\033[0m\n\
+\t\033[36m\"regular expression\":\033[0m \"%s\"\033[90m,\033[0m\n\
+\t\033[36m\"sub-expressions\":\033[0m %d\033[90m,\033[0m\n\
+\t\033[36m\"total matches\":\033[0m %d\033[90m,\033[0m\n\
+\t\033[36m\"matches\":\033[0m",
+                (int)_PRINT__TEXT_LENGTH(regex_data),
+                substring,
+                regex_data->num_pattern_subexpr,
+                regex_data->num_matches);
+                strcat(output_string, " [\n");
+                _PRINT__APPEND(&result, output_string);
+            }
+            else
+            {
+                sprintf(output_string, "{\n\
+\t\"text-length\": %d,\n\
+\t\"regular expression\": \"%s\",\n\
+\t\"sub-expressions\": %d,\n\
+\t\"total matches\": %d,\n\
+\t\"matches\":",
+                (int)_PRINT__TEXT_LENGTH(regex_data),
+                substring,
+                regex_data->num_pattern_subexpr,
+                regex_data->num_matches);
+                strcat(output_string, " [\n");
+                _PRINT__APPEND(&result, output_string);
+            }
+        }
+
+        for (i = 0; i < regex_data->num_matches; i++)
+        {
+            /* substitute newline characters in substring */
+            substring = _PRINT__ESCAPE_STRING(substring, regex_data->matches[i].string, PRINT_LAYOUT == REGEX_PRINT_JSON);
+
+            if (PRINT_LAYOUT == REGEX_PRINT_TABLE)
+            {
+                /* set placeholders for #   Match   Submatch */
+                if (i < 9)
+                {
+                    strcpy(PRINTF_FORMAT_STR, "%d    %4d       %4d");
+                }
+                if (i >= 9)
+                {
+                    strcpy(PRINTF_FORMAT_STR, "%d   %4d       %4d");
+                }
+                if (i >= 99)
+                {
+                    strcpy(PRINTF_FORMAT_STR, "%d  %4d       %4d");
+                }
+                if (i >= 999)
+                {
+                    strcpy(PRINTF_FORMAT_STR, "%d %4d       %4d");
+                }
+
+                if (print_position)
+                {
+                    /* set placeholders for Start  %*sEnd */
+                    if (_CONTEXT(print_colored, PRINT_COLORED) == 1)
+                    {
+                        sprintf(temp_str_buffer[0], "%d", regex_data->matches[regex_data->num_matches-1].end);
+                        strcat(PRINTF_FORMAT_STR, " \033[90m%8d -> %");
+                        sprintf(temp_str_buffer[1], "%d", 1 + (int)strlen(temp_str_buffer[0]));
+                        strcat(PRINTF_FORMAT_STR, temp_str_buffer[1]);
+                        if (regex_data->num_pattern_subexpr > 0 && regex_data->matches[i].number_submatch == 0)
+                        {
+                            strcat(PRINTF_FORMAT_STR, "d\033[0m  %c  \033[35m%s\033[0m\n");
+                        }
+                        else
+                        {
+                            strcat(PRINTF_FORMAT_STR, "d\033[0m  %c  %s\n");
+                        }
+                    }
+                    else
+                    {
+                        sprintf(temp_str_buffer[0], "%d", regex_data->matches[regex_data->num_matches-1].end);
+                        strcat(PRINTF_FORMAT_STR, " %8d -> %");
+                        sprintf(temp_str_buffer[1], "%d", 1 + (int)strlen(temp_str_buffer[0]));
+                        strcat(PRINTF_FORMAT_STR, temp_str_buffer[1]);
+                        strcat(PRINTF_FORMAT_STR, "d  %c  %s\n");
+                    }
+                }
+                else
+                {
+                    /* set placeholders for Start  %*sEnd */
+                    if (_CONTEXT(print_colored, PRINT_COLORED) == 1)
+                    {
+                        sprintf(temp_str_buffer[0], "%d", regex_data->matches[regex_data->num_matches-1].end);
+                        strcat(PRINTF_FORMAT_STR, " \033[90m");
+                        sprintf(temp_str_buffer[1], " ");
+                        strcat(PRINTF_FORMAT_STR, temp_str_buffer[1]);
+                        if (regex_data->num_pattern_subexpr > 0 && regex_data->matches[i].number_submatch == 0)
+                        {
+                            strcat(PRINTF_FORMAT_STR, "\033[0m%c  \033[35m%s\033[0m\n");
+                        }
+                        else
+                        {
+                            strcat(PRINTF_FORMAT_STR, "\033[0m%c  %s\n");
+                        }
+                    }
+                    else
+                    {
+                        sprintf(temp_str_buffer[0], "%d", regex_data->matches[regex_data->num_matches-1].end);
+                        strcat(PRINTF_FORMAT_STR, " ");
+                        sprintf(temp_str_buffer[1], " ");
+                        strcat(PRINTF_FORMAT_STR, temp_str_buffer[1]);
+                        strcat(PRINTF_FORMAT_STR, "%c  %s\n");
+                    }
+                }
+
+                /* set all values */
+                output_string = __REALLOC(output_string, (strlen(substring) + 512) * sizeof(char));
+                if (print_position)
+                {
+                    sprintf(output_string, PRINTF_FORMAT_STR,
+                        i + 1,
+                        regex_data->matches[i].number_match,
+                        regex_data->matches[i].number_submatch,
+                        regex_data->matches[i].start,
+                        regex_data->matches[i].end,
+                        (regex_data->num_pattern_subexpr > 0 && regex_data->matches[i].number_submatch == 0 ? '*' : ' '),
+                        substring
+                    );
+                }
+                else
+                {
+                    sprintf(output_string, PRINTF_FORMAT_STR,
+                        i + 1,
+                        regex_data->matches[i].number_match,
+                        regex_data->matches[i].number_submatch,
+                        (regex_data->num_pattern_subexpr > 0 && regex_data->matches[i].number_submatch == 0 ? '*' : ' '),
+                        substring
+                    );
+                }
+
+                /* concatinate strings to table row */
+                _PRINT__APPEND(&result, output_string);
+            }
+            else if (PRINT_LAYOUT == REGEX_PRINT_LIST)
+            {
+                /* set all values */
+                output_string = __REALLOC(output_string, (strlen(substring) + 256) * sizeof(char));
+
+                if (print_position)
+                {
+                    if (_CONTEXT(print_colored, PRINT_COLORED) == 1)
+                    {
+                        sprintf(temp_str_buffer[0], "\033[32m[%d]\033[0m", i+1);
+                        sprintf(temp_str_buffer[1], "\033[90m(%d-%d)\033[0m", regex_data->matches[i].start, regex_data->matches[i].end);
+
+                        if (regex_data->num_pattern_subexpr > 0 && regex_data->matches[i].number_submatch == 0)
+                        {
+                            sprintf(output_string, "%-4s %12s: \033[35m%s\033[0m", temp_str_buffer[0], temp_str_buffer[1], substring);
+                        }
+                        else
+                        {
+                            sprintf(output_string, "%-4s %12s: %s", temp_str_buffer[0], temp_str_buffer[1], substring);
+                        }
+                        
+                    }
+                    else
+                    {
+                        sprintf(temp_str_buffer[0], "[%d]", i+1);
+                        sprintf(temp_str_buffer[1], "(%d-%d)", regex_data->matches[i].start, regex_data->matches[i].end);
+                        sprintf(output_string, "%-4s %12s: %s", temp_str_buffer[0], temp_str_buffer[1], substring);
+                    }
+                }
+                else
+                {
+                    if (_CONTEXT(print_colored, PRINT_COLORED) == 1)
+                    {
+                        sprintf(temp_str_buffer[0], "\033[32m[%d]\033[0m", i+1);
+
+                        if (regex_data->num_pattern_subexpr > 0 && regex_data->matches[i].number_submatch == 0)
+                        {
+                            sprintf(output_string, "%-4s: \033[35m%s\033[0m", temp_str_buffer[0], substring);
+                        }
+                        else
+                        {
+                            sprintf(output_string, "%-4s: %s", temp_str_buffer[0], substring);
+                        }
+                        
+                    }
+                    else
+                    {
+                        sprintf(temp_str_buffer[0], "[%d]", i+1);
+                        sprintf(output_string, "%-4s: %s", temp_str_buffer[0], substring);
+                    }
+                }
+
+                
+                
+                /* add Substring */
+                strcat(output_string, "\n");
+
+                /* concatinate all strings to list entry */
+                _PRINT__APPEND(&result, output_string);
+            }
+            else if (PRINT_LAYOUT == REGEX_PRINT_LIST_FULL)
+            {
+                /* set all values and substring*/
+                output_string = __REALLOC(output_string, (strlen(substring) + 256) * sizeof(char));
+
+                if (print_position)
+                {
+                    if (_CONTEXT(print_colored, PRINT_COLORED) == 1)
+                    {
+                        if (regex_data->num_pattern_subexpr > 0 && regex_data->matches[i].number_submatch == 0)
+                        {
+                            sprintf(output_string, "\033[36m[%d]\033[0m\n\033[32mMatch:\033[0m     %d\n\033[32mSubmatch:\033[0m  %d\n\033[32mStart:\033[0m     %d\n\033[32mEnd:\033[0m       %d\n\033[32mSubstring:\033[0m \033[35m%s\033[0m\n",
+                                i + 1,
+                                regex_data->matches[i].number_match,
+                                regex_data->matches[i].number_submatch,
+                                regex_data->matches[i].start,
+                                regex_data->matches[i].end,
+                                regex_data->matches[i].string
+                            ); 
+                        }
+                        else
+                        {
+                            sprintf(output_string, "\033[36m[%d]\033[0m\n\033[32mMatch:\033[0m     %d\n\033[32mSubmatch:\033[0m  %d\n\033[32mStart:\033[0m     %d\n\033[32mEnd:\033[0m       %d\n\033[32mSubstring:\033[0m %s\n",
+                                i + 1,
+                                regex_data->matches[i].number_match,
+                                regex_data->matches[i].number_submatch,
+                                regex_data->matches[i].start,
+                                regex_data->matches[i].end,
+                                regex_data->matches[i].string
+                            ); 
+                        }
+                        
+                    }
+                    else
+                    {
+                        sprintf(output_string, "[%d]\nMatch      %d\nSubmatch:  %d\nStart:     %d\nEnd:       %d\nSubstring: %s\n",
+                            i + 1,
+                            regex_data->matches[i].number_match,
+                            regex_data->matches[i].number_submatch,
+                            regex_data->matches[i].start,
+                            regex_data->matches[i].end,
+                            regex_data->matches[i].string
+                        );
+                    } 
+                }
+                else
+                {
+                    if (_CONTEXT(print_colored, PRINT_COLORED) == 1)
+                    {
+                        if (regex_data->num_pattern_subexpr > 0 && regex_data->matches[i].number_submatch == 0)
+                        {
+                            sprintf(output_string, "\033[36m[%d]\033[0m\n\033[32mMatch:\033[0m     %d\n\033[32mSubmatch:\033[0m  %d\n\033[32mSubstring:\033[0m \033[35m%s\033[0m\n",
+                                i + 1,
+                                regex_data->matches[i].number_match,
+                                regex_data->matches[i].number_submatch,
+                                regex_data->matches[i].string
+                            ); 
+                        }
+                        else
+                        {
+                            sprintf(output_string, "\033[36m[%d]\033[0m\n\033[32mMatch:\033[0m     %d\n\033[32mSubmatch:\033[0m  %d\n\033[32mSubstring:\033[0m %s\n",
+                                i + 1,
+                                regex_data->matches[i].number_match,
+                                regex_data->matches[i].number_submatch,
+                                regex_data->matches[i].string
+                            ); 
+                        }
+                        
+                    }
+                    else
+                    {
+                        sprintf(output_string, "[%d]\nMatch      %d\nSubmatch:  %d\nSubstring: %s\n",
+                            i + 1,
+                            regex_data->matches[i].number_match,
+                            regex_data->matches[i].number_submatch,
+                            regex_data->matches[i].string
+                        );
+                    } 
+                }
+                
+
+                if (i < regex_data->num_matches-1)
+                {
+                    strcat(output_string, "\n");
+                }
+
+                /* concatinate all strings to list entry */
+                _PRINT__APPEND(&result, output_string);
+            }
+            else if (PRINT_LAYOUT == REGEX_PRINT_PLAIN)
+            {
+                /* copy substring*/
+                output_string = __REALLOC(output_string, (strlen(substring) + 256) * sizeof(char));
+                sprintf(output_string, "%s\n",
+                    regex_data->matches[i].string
+                );
+
+                /* concatinate result substring to output */
+                _PRINT__APPEND(&result, output_string);
+            }
+            else if (PRINT_LAYOUT == REGEX_PRINT_CSV)
+            {
+                /* set all values and substring*/
+                output_string = __REALLOC(output_string, (strlen(substring) + 256) * sizeof(char));
+
+                if (print_position)
+                {
+                    sprintf(output_string, "%d;%d;%d;%d;%d;%s;\n",
+                        i, regex_data->matches[i].number_match,
+                        regex_data->matches[i].number_submatch,
+                        regex_data->matches[i].start,
+                        regex_data->matches[i].end,
+                        substring
+                    );
+                }
+                else
+                {
+                    sprintf(output_string, "%d;%d;%d;%s;\n",
+                        i, regex_data->matches[i].number_match,
+                        regex_data->matches[i].number_submatch,
+                        substring
+                    );
+                }
+
+                /* concatinate result substring to output */
+                _PRINT__APPEND(&result, output_string);
+            }
+            else if (PRINT_LAYOUT == REGEX_PRINT_JSON)
+            {
+                /* set all values and substring*/
+                output_string = __REALLOC(output_string, (strlen(substring) + 256) * sizeof(char));
+
+                if (print_position)
+                {
+                    if (_CONTEXT(print_colored, PRINT_COLORED) == 1)
+                    {
+                        sprintf(output_string, "\t\t{\n\
+\t\t\t\033[32m\"match-number\":\033[0m %d\033[90m,\033[0m\n\
+\t\t\t\033[32m\"group-number\":\033[0m %d\033[90m,\033[0m\n\
+\t\t\t\033[32m\"sub-string\":\033[0m \"%s\"\033[90m,\033[0m\n\
+\t\t\t\033[32m\"start\":\033[0m %d\033[90m,\033[0m\n\
+\t\t\t\033[32m\"end\":\033[0m %d\n",
+                        regex_data->matches[i].number_match,
+                        regex_data->matches[i].number_submatch,
+                        substring,
+                        regex_data->matches[i].start,
+                        regex_data->matches[i].end);
+                    }
+                    else
+                    {
+                        sprintf(output_string, "\t\t{\n\
+\t\t\t\"match-number\": %d,\n\
+\t\t\t\"group-number\": %d,\n\
+\t\t\t\"sub-string\": \"%s\",\n\
+\t\t\t\"start\": %d,\n\
+\t\t\t\"end\": %d\n",
+                        regex_data->matches[i].number_match,
+                        regex_data->matches[i].number_submatch,
+                        substring,
+                        regex_data->matches[i].start,
+                        regex_data->matches[i].end);
+                    }
+                }
+                else
+                {
+                    if (_CONTEXT(print_colored, PRINT_COLORED) == 1)
+                    {
+                        sprintf(output_string, "\t\t{\n\
+\t\t\t\033[32m\"match-number\":\033[0m %d\033[90m,\033[0m\n\
+\t\t\t\033[32m\"group-number\":\033[0m %d\033[90m,\033[0m\n\
+\t\t\t\033[32m\"sub-string\":\033[0m \"%s\"\n",
+                        regex_data->matches[i].number_match,
+                        regex_data->matches[i].number_submatch,
+                        substring);
+                    }
+                    else
+                    {
+                        sprintf(output_string, "\t\t{\n\
+\t\t\t\"match-number\": %d,\n\
+\t\t\t\"group-number\": %d,\n\
+\t\t\t\"sub-string\": \"%s\"\n",
+                        regex_data->matches[i].number_match,
+                        regex_data->matches[i].number_submatch,
+                        substring);
+                    }
+                }
+
+                strcat(output_string, "\t\t}");
+                
+                if (i < regex_data->num_matches-1)
+                {
+                     if (_CONTEXT(print_colored, PRINT_COLORED) == 1)
+                    {
+                        strcat(output_string, "\033[90m,\033[0m\n");
+                    }
+                    else
+                    {
+                        strcat(output_string, ",\n");
+                    }
+                }
+                else
+                {
+                    strcat(output_string, "\n");
+                }
+
+                /* concatinate result substring to output */
+                _PRINT__APPEND(&result, output_string);
+            }
+        }
+        if (PRINT_LAYOUT == REGEX_PRINT_JSON)
+        {
+            _PRINT__APPEND(&result, "\t]\n}\n");
+        }
+    }
+    else
+    {
+        if (PRINT_LAYOUT != REGEX_PRINT_CSV &&
+            PRINT_LAYOUT != REGEX_PRINT_JSON)
+        {
+            _PRINT__APPEND(&result, "\nNo match\n");
+        }
+        else
+        {
+            _PRINT__APPEND(&result, "No match\n");
+        }
+    }
+    
+    __FREE(substring);
+    __FREE(output_string);
+    
+    return result.data;
+}
+
+/* (Internal) Processes the complete string (text + data + results) for printing or writing  */
+static char* _PRINT__GET_OUTPUT_STRING(RegEx regex_data, int PRINT_LAYOUT)
+{
+    int PRINT_OPTIONS = PRINT_LAYOUT;
+    cregstring_t output;
+    char* temp_string;
+
+    /* filter print options from print layout */
+    if ((PRINT_LAYOUT & REGEX_PRINT_FULLTEXT) == REGEX_PRINT_FULLTEXT)
+    {
+        PRINT_LAYOUT = PRINT_LAYOUT - REGEX_PRINT_FULLTEXT;
+    }
+    if ((PRINT_LAYOUT & REGEX_PRINT_NOTEXT) == REGEX_PRINT_NOTEXT)
+    {
+        PRINT_LAYOUT = PRINT_LAYOUT - REGEX_PRINT_NOTEXT;
+    }
+    if ((PRINT_LAYOUT & REGEX_PRINT_NOSTATS) == REGEX_PRINT_NOSTATS)
+    {
+        PRINT_LAYOUT = PRINT_LAYOUT - REGEX_PRINT_NOSTATS;
+    }
+    if ((PRINT_LAYOUT & REGEX_PRINT_NORESULTS) == REGEX_PRINT_NORESULTS)
+    {
+        PRINT_LAYOUT = PRINT_LAYOUT - REGEX_PRINT_NORESULTS;
+    }
+    if ((PRINT_LAYOUT & REGEX_PRINT_NOINDEX) == REGEX_PRINT_NOINDEX)
+    {
+        PRINT_LAYOUT = PRINT_LAYOUT - REGEX_PRINT_NOINDEX;
+    }
+    if ((PRINT_LAYOUT & REGEX_PRINT_FILTER) == REGEX_PRINT_FILTER)
+    {
+        PRINT_LAYOUT = PRINT_LAYOUT - REGEX_PRINT_FILTER;
+    }
+
+    if (1)
+    {
+        temp_string = _PRINT__CONCAT_OPTION_FLAGS(regex_data);
+        _PRINT__STRING_INIT(&output, 512);
+
+        if ((PRINT_OPTIONS & REGEX_PRINT_NOTEXT) != REGEX_PRINT_NOTEXT &&
+            (regex_data->return_code == REGEX_COMP_SUCCESS ||
+             regex_data->return_code == REGEX_MATCH_SUCCESS))
+        {
+            if ((PRINT_OPTIONS & REGEX_PRINT_FULLTEXT) == REGEX_PRINT_FULLTEXT)
+            {
+                /* print the full text without changing MAX_PRINT_TEXT_LENGTH */
+                cregcontext_t full_text_context;
+                RegExContext previous_context = _CONTEXT__OVERRIDE(&full_text_context);
+
+                full_text_context.max_print_text_length = 0;
+                _PRINT__APPEND_TEXT_STRING(regex_data, &output);
+                _CONTEXT__SET(previous_context);
+            }
+            else
+            {
+                _PRINT__APPEND_TEXT_STRING(regex_data, &output);
+            }
+        }
+
+        if ((PRINT_OPTIONS & REGEX_PRINT_NOSTATS) != REGEX_PRINT_NOSTATS)
+        {
+            temp_string = _PRINT__GET_REGEX_STATS(regex_data, temp_string);
+            _PRINT__APPEND(&output, temp_string);
+        }
+        
+        __FREE(temp_string);
+    }
+    else
+    {
+        _PRINT__STRING_INIT(&output, 32);
+    }
+    
+    if ((PRINT_OPTIONS & REGEX_PRINT_NORESULTS) != REGEX_PRINT_NORESULTS &&
+        (regex_data->return_code == REGEX_COMP_SUCCESS ||
+         regex_data->return_code == REGEX_MATCH_SUCCESS))
+    {
+        temp_string = _PRINT__GET_RESULTS(
+            regex_data,
+            PRINT_LAYOUT,
+            !((PRINT_OPTIONS & REGEX_PRINT_NOTEXT) == REGEX_PRINT_NOTEXT &&
+              (PRINT_OPTIONS & REGEX_PRINT_NOSTATS) == REGEX_PRINT_NOSTATS),    /* print header or not */
+            !((PRINT_OPTIONS & REGEX_PRINT_NOINDEX) == REGEX_PRINT_NOINDEX)         /* print match position or not */
+        );
+
+        _PRINT__APPEND(&output, temp_string);
+        __FREE(temp_string);
+    }
+
+    return output.data;
+}
+
+/* set_default_reg_flags() - Sets the default REG_ flags for regex_compile() and regcomp()
+   ---------------------------------------------------------------------------------------
+   regex.h-Library-Documentation:
+   REG_EXTENDED: Support extended regular expressions.
+   REG_ICASE:    Ignore case in match.
+   REG_NEWLINE:  Eliminate any special significance to the newline character.
+   REG_NOSUB:    Report only success or fail in regexec(), that is, verify the syntax of a regular expression.
+                 If this flag is set, the regcomp() function sets re_nsub to the number of parenthesized sub-expressions found in pattern.
+                 Otherwise, a sub-expression results in an error.
+                 (-> This option is not deactivated)
+
+   extended flags:
+   REG_GLOBAL    Uses global-search with multiple matches instead of single matching
+   REG_MULTILINE Catches the newline character, automaticly deactivates REG_NEWLINE
+   REG_NOSUBEXP  Ignore matching of grouped submatches by SUBEXPpressions */
+void set_default_reg_flags(int OPTION_FLAGS)
+{
+    int i;
+
+    for (i = 0; i < 7; i++)
+    {
+        DEFAULT_REG_FLAGS[i] = 0;
+    }
+
+    /* one pass, each set flag takes the next array element */
+    i = 0;
+
+    if ((OPTION_FLAGS & REG_GLOBAL) == REG_GLOBAL)
+    {
+        DEFAULT_REG_FLAGS[i] = REG_GLOBAL;
+        i++;
+    }
+    if ((OPTION_FLAGS & REG_EXTENDED) == REG_EXTENDED)
+    {
+        DEFAULT_REG_FLAGS[i] = REG_EXTENDED;
+        i++;
+    }
+    if ((OPTION_FLAGS & REG_ICASE) == REG_ICASE)
+    {
+        DEFAULT_REG_FLAGS[i] = REG_ICASE;
+        i++;
+    }
+    if ((OPTION_FLAGS & REG_NEWLINE) == REG_NEWLINE)
+    {
+        DEFAULT_REG_FLAGS[i] = REG_NEWLINE;
+        i++;
+    }
+    if ((OPTION_FLAGS & REG_NOSUB) == REG_NOSUB)
+    {
+        DEFAULT_REG_FLAGS[i] = REG_NOSUB;
+        i++;
+    }
+    if ((OPTION_FLAGS & REG_MULTILINE) == REG_MULTILINE)
+    {
+        DEFAULT_REG_FLAGS[i] = REG_MULTILINE;
+        i++;
+    }
+    if ((OPTION_FLAGS & REG_NOSUBEXP) == REG_NOSUBEXP)
+    {
+        DEFAULT_REG_FLAGS[i] = REG_NOSUBEXP;
+        i++;
+    }
+}
+
+/* regex_set_allocator(regex_malloc_t, regex_realloc_t, regex_free_t, void*) - Installs an allocator.
+   ---------------------------------------------------------------------------------------------------
+   Description:
+     Installs the functions for all memory of the library, like RegEx objects, match data, cursors
+     and output strings. The userdata pointer is passed to each call, e.g. for a memory pool or a
+     memory budget. If an allocation of regex_compile(), the exec, search and count functions or the
+     compiled-pattern cache fails, the functions return REGEX_ERROR_MEMORY or NULL instead of ending
+     the program. The print, replace and file functions still end the program without memory.
+     The allocator should be installed before any memory of the library is allocated, because
+     memory is freed by the free function which is installed at that time.
+
+   Parameters:
+     regex_malloc_t malloc_function:   void* malloc_function(size_t size, void* userdata), NULL = malloc()
+     regex_realloc_t realloc_function: void* realloc_function(void* ptr, size_t size, void* userdata), NULL = realloc()
+     regex_free_t free_function:       void free_function(void* ptr, void* userdata), NULL = free()
+     void* userdata:                   Pointer passed to each call of the allocation functions
+
+   Return Value:
+     returns:      0, or REGEX_ERROR if only some of the functions are given */
+int regex_set_allocator(regex_malloc_t malloc_function, regex_realloc_t realloc_function, regex_free_t free_function, void* userdata)
+{
+    /* all functions or the functions of the C library */
+    if ((malloc_function == NULL || realloc_function == NULL || free_function == NULL) &&
+        (malloc_function != NULL || realloc_function != NULL || free_function != NULL))
+    {
+        fprintf(stderr, "regex_set_allocator() error: The malloc, realloc and free functions must be set together.\n");
+        return REGEX_ERROR;
+    }
+
+    REGEX_ALLOCATOR.malloc_function = malloc_function;
+    REGEX_ALLOCATOR.realloc_function = realloc_function;
+    REGEX_ALLOCATOR.free_function = free_function;
+    REGEX_ALLOCATOR.userdata = userdata;
+
+    return 0;
+}
+
+/* regex_context_init(RegExContext) - Initializes a context with the global values.
+   ---------------------------------------------------------------------------------
+   Description:
+     Copies the current values of MAX_TEXT_LENGTH, MAX_PATTERN_LENGTH, MAX_NUM_MATCHES, MAX_PRINT_TEXT_LENGTH,
+     MAX_FILENAME_LENGTH, DEFAULT_REG_FLAGS, PRINT_COLORED and NUM_THREADS into a context, which can be changed
+     and set with regex_context_set() for a thread.
+
+   Parameters:
+     RegExContext context: The context */
+void regex_context_init(RegExContext context)
+{
+    int i;
+
+    __ASSERT_PARAM(context, "RegExContext context", ASSERT_TYPE_STRUCT);
+
+    context->max_text_length = MAX_TEXT_LENGTH;
+    context->max_pattern_length = MAX_PATTERN_LENGTH;
+    context->max_num_matches = MAX_NUM_MATCHES;
+    context->max_print_text_length = MAX_PRINT_TEXT_LENGTH;
+    context->max_filename_length = MAX_FILENAME_LENGTH;
+    context->print_colored = PRINT_COLORED;
+    context->num_threads = NUM_THREADS;
+
+    for (i = 0; i < (int)(sizeof(DEFAULT_REG_FLAGS) / sizeof(DEFAULT_REG_FLAGS[0])); i++)
+    {
+        context->default_reg_flags[i] = DEFAULT_REG_FLAGS[i];
+    }
+}
+
+/* regex_context_set(RegExContext) - Sets the context of the calling thread.
+   -------------------------------------------------------------------------
+   Description:
+     Sets the limits, default flags and print options of all following library calls of the calling thread,
+     instead of the global variables. Other threads are not affected. The context is not copied and has to
+     stay valid until it is replaced.
+
+   Parameters:
+     RegExContext context: The context, or NULL for the global variables
+
+   Return Value:
+     returns:      The previous context of the calling thread, or NULL */
+RegExContext regex_context_set(RegExContext context)
+{
+    RegExContext previous_context = _CONTEXT__GET();
+
+    _CONTEXT__SET(context);
+
+    return previous_context;
+}
+
+/* regex_compile(char*, int) - Compiles the regular expression pattern.
+   --------------------------------------------------------------------
+   Description:
+     Compiles a regular expression pattern with given option flags.
+
+   Parameters:
+     char* regex_pattern_string: The regular expression pattern
+     int option_flags:     The regular expression option flags:
+                           REG_EXTENDED: Support extended regular expressions.
+                           REG_ICASE:    Ignore case in match.
+                           REG_NEWLINE:  Eliminate any special significance to the newline character.
+
+   Return Value:
+     returns:              The unexecuted RegEx Object without the regular expression results,
+                           or NULL if the memory of the RegEx Object could not be allocated. */
+RegEx regex_compile(char* regex_pattern_string, int OPTION_FLAGS)
+{
+    RegEx regex_data = _COMPILE__INIT_REGEX(regex_pattern_string, OPTION_FLAGS);
+
+    __ASSERT_PARAM(regex_pattern_string, "regex_pattern_string", ASSERT_TYPE_PTR);
+    __ASSERT_PARAM(&OPTION_FLAGS, "OPTION_FLAGS", ASSERT_TYPE_INT);
+
+    if (regex_data == NULL)
+    {
+        fprintf(stderr, "regex_compile() error: Could not allocate memory.\n");
+        return NULL;
+    }
+
+    _COMPILE__REGEX(regex_data, regex_pattern_string);
+
+    return _COMPILE__CHECK_MEMORY(regex_data);
+}
+
+/* regex_error(RegEx) - Writes and prints the error message buffer.
+   ----------------------------------------------------------------
+   Description:
+     Writes the error code message of regerror() into the error message buffer
+     and prints the error message to stderr.
+
+   Parameters:
+     RegEx regex_data: The RegEx object
+
+   Return Value:
+     returns:     The return code of regerror() */
+int regex_error(RegEx regex_data)
+{
+    __ASSERT_PARAM(regex_data, "RegEx regex data", ASSERT_TYPE_STRUCT);
+
+    if (regex_data != NULL)
+    {
+        /*  size_t regerror(int errcode, const regex_t *preg, char* errbuf, size_t errbuf_size);
+            ------------------------------------------------------------------------------------
+            Finds the description for errcode. 
+
+            preg:        is a pointer to a compiled regular expression.
+            errbuf:      is the message string buffer for the error description.
+            errbuf_size: is the size of the message string buffer
+
+            return:      regerror() returns the integer value that is the size of the buffer needed to
+                         hold the generated description string for the error condition corresponding to errcode.
+
+            regerror() returns the following messages:
+
+                REG_BADBR:    Invalid \{ \} range exp
+                REG_BADPAT:   Invalid regular expression
+                REG_BADRPT:   ?*+ not preceded by valid RE
+                REG_EBOL:     ¬ anchor and not BOL
+                REG_EBRACE:   \{ \} or { } imbalance
+                REG_EBRACK:   [] imbalance
+                REG_ECHAR:    Invalid multibyte character
+                REG_ECOLLATE: Invalid collating element
+                REG_ECTYPE:   Invalid character class
+                REG_EEOL:     $ anchor and not EOL
+                REG_EESCAPE:  Last character is \
+                REG_EPAREN:   \( \) or () imbalance
+                REG_ERANGE:   Invalid range exp endpoint
+                REG_ESPACE:   Out of memory
+                REG_ESUBREG:  Invalid number in \digit
+                REG_NOMATCH:  RE pattern not found */
+        regerror(regex_data->return_code, &regex_data->regex_h.compiled_regex, regex_data->error_message, (size_t)sizeof(regex_data->error_message));
+        fprintf(stderr, "Error: %s\n\n", regex_data->error_message);
+        regex_data->regex_h.reglib_status = REGLIB_ERROR;
+    }
+    else
+    {
+        fprintf(stderr, "regex_error(): Regex object is not initialized.\n");
+    }
+
+    return regex_data->return_code;
+}
+
+/* regex_exec(char*, RegEx) - Executes a compiled regular expression pattern.
+   --------------------------------------------------------------------------
+   Description:
+     Executes a compiled regular expression pattern and compares it with a given text input string.
+
+   Parameters:
+     char* input_text_string: The text input string for the regular expression
+     RegEx regex_data:  The compiled RegEx object
+
+   Return Value:
+     returns:      The return code of regexec() */
+int regex_exec(char* input_text_string, RegEx regex_data)
+{
+    __ASSERT_PARAM(input_text_string, "input text string", ASSERT_TYPE_PTR);
+
+    return regex_exec_buffer(input_text_string, (int)strlen(input_text_string), regex_data);
+}
+
+/* regex_exec_buffer(char*, int, RegEx) - Executes a compiled regular expression pattern on a text buffer.
+   -----------------------------------------------------------------------------------------------------
+   Description:
+     Executes a compiled regular expression pattern and compares it with the given number of
+     bytes of a text buffer. The buffer does not need a terminating NUL byte and may contain
+     NUL bytes, like binary log files (requires REG_STARTEND of the GNU regex library).
+     An executed RegEx object can be executed again: the previous matches are removed with
+     regex_reset() and their memory and the text buffer are reused for the new matches.
+     With REG_NOCOPY the text buffer is not copied: the RegEx object only points to it, so the
+     buffer has to stay valid until regex_reset(), the next execution or regex_close(), as long
+     as regex_data->text is used, e.g. by regex_print().
+
+   Parameters:
+     char* input_text_buffer: The text buffer for the regular expression
+     int input_text_length:   The number of bytes of the text buffer
+     RegEx regex_data:        The compiled RegEx object
+
+   Return Value:
+     returns:      The return code of regexec() */
+int regex_exec_buffer(char* input_text_buffer, int input_text_length, RegEx regex_data)
+{
+    int return_code = -1;
+    char* text_copy;
+    cregresults_t results;
+
+    __ASSERT_PARAM(input_text_buffer, "input text buffer", ASSERT_TYPE_PTR);
+    __ASSERT_PARAM(regex_data, "RegEx regex data", ASSERT_TYPE_STRUCT);
+
+    if (regex_data != NULL)
+    {
+        if (regex_data->regex_h.reglib_status == REGLIB_COMPILED || regex_data->regex_h.reglib_status == REGLIB_EXECUTED)
+        {
+            /* remove the matches of a previous execution */
+            regex_reset(regex_data);
+
+            if (regex_data->flags.NOCOPY == 1)
+            {
+                /* REG_NOCOPY set: search the text buffer of the caller */
+                regex_data->text = input_text_buffer;
+            }
+            else
+            {
+                /* copy the input text with a terminating NUL byte, the text buffer only grows */
+                if (input_text_length + 1 > regex_data->text_capacity)
+                {
+                    text_copy = __TRY_REALLOC(regex_data->regex_h.text_buffer, (input_text_length + 1) * sizeof(char));
+
+                    if (text_copy == NULL)
+                    {
+                        fprintf(stderr, "regex_exec() error: Could not allocate memory for the input text.\n");
+                        return REGEX_ERROR_MEMORY;
+                    }
+
+                    regex_data->regex_h.text_buffer = text_copy;
+                    regex_data->text_capacity = input_text_length + 1;
+                }
+
+                regex_data->text = regex_data->regex_h.text_buffer;
+                memcpy(regex_data->text, input_text_buffer, input_text_length);
+                regex_data->text[input_text_length] = '\0';
+            }
+
+            regex_data->text_length = input_text_length;
+
+            /* search with the match arrays of the RegEx object as result data */
+            results.matches = regex_data->matches;
+            results.num_matches = regex_data->num_matches;
+            results.return_code = regex_data->return_code;
+            results.match_offsets = regex_data->regex_h.match_offsets;
+            results.match_strings = regex_data->regex_h.match_strings;
+            results.match_capacity = regex_data->regex_h.match_capacity;
+            results.arena = regex_data->regex_h.arena;
+            results.dfas = regex_data->regex_h.dfas;
+
+            return_code = _EXEC__SEARCH(regex_data->text, input_text_length, regex_data, &results);
+
+            regex_data->matches = results.matches;
+            regex_data->num_matches = results.num_matches;
+            regex_data->return_code = results.return_code;
+            regex_data->regex_h.match_offsets = results.match_offsets;
+            regex_data->regex_h.match_strings = results.match_strings;
+            regex_data->regex_h.match_capacity = results.match_capacity;
+            regex_data->regex_h.arena = results.arena;
+            regex_data->regex_h.dfas = results.dfas;
+
+            if (return_code == REGEX_MATCH_SUCCESS)
+            {
+                regex_data->regex_h.reglib_status = REGLIB_EXECUTED;
+            }
+        }
+        else
+        {
+            fprintf(stderr, "regex_exec() error: Regular expression is not compiled.\n");
+        }
+    }
+    else
+    {
+        fprintf(stderr, "regex_exec() error: RegEx object is not initialized.\n");
+    }
+    
+    return return_code;
+}
+
+/* regex_reset(RegEx) - Removes the matches of an executed RegEx object.
+   ----------------------------------------------------------------------
+   Description:
+     Removes the matches and the input text of a RegEx object and sets it back to the compiled
+     status. The compiled regular expression, the memory of the matches and the text buffer are
+     kept, so a RegEx object which is executed again and again in a loop does not allocate memory
+     after the matches of the largest text. regex_exec() calls it before each execution.
+
+   Parameters:
+     RegEx regex_data: The compiled RegEx object
+
+   Return Value:
+     returns:      REGEX_COMP_SUCCESS, or REGEX_ERROR if the RegEx object is not compiled */
+int regex_reset(RegEx regex_data)
+{
+    __ASSERT_PARAM(regex_data, "RegEx regex data", ASSERT_TYPE_STRUCT);
+
+    if (regex_data == NULL ||
+        (regex_data->regex_h.reglib_status != REGLIB_COMPILED && regex_data->regex_h.reglib_status != REGLIB_EXECUTED))
+    {
+        fprintf(stderr, "regex_reset() error: Regular expression is not compiled.\n");
+        return REGEX_ERROR;
+    }
+
+    /* keep the arena memory of the previous matches */
+    _ARENA__RESET(&regex_data->regex_h.arena);
+    regex_data->matches = NULL;
+    regex_data->num_matches = 0;
+    regex_data->regex_h.match_offsets = NULL;
+    regex_data->regex_h.match_strings = NULL;
+    regex_data->regex_h.match_capacity = 0;
+
+    /* release the input text of REG_NOCOPY */
+    regex_data->text = regex_data->regex_h.text_buffer;
+    strcpy(regex_data->text, "<No input text>");
+    regex_data->text_length = 0;
+
+    regex_data->return_code = REGEX_COMP_SUCCESS;
+    regex_data->regex_h.reglib_status = REGLIB_COMPILED;
+
+    return REGEX_COMP_SUCCESS;
+}
+
+/* regex_foreach(char*, RegEx, regex_callback_t, void*) - Calls a function for each match.
+   ---------------------------------------------------------------------------------------
+   Description:
+     Executes a compiled regular expression pattern on a given text input string and calls the
+     callback function for each match and group as soon as it is found, in the order and with the
+     numbering of the regex_exec() results. The matches are not stored in the RegEx object and the
+     input text string is not copied, so the memory use does not depend on the number of matches.
+     Without REG_GLOBAL only the first match is delivered.
+
+   Parameters:
+     char* input_text_string:   The text input string for the regular expression
+     RegEx regex_data:          The compiled RegEx object
+     regex_callback_t callback: int callback(int number_match, int number_submatch, int start, int end, void* userdata),
+                                returns 0 to continue or another value to stop the search
+     void* userdata:            Pointer passed to each call of the callback function
+
+   Return Value:
+     returns:      The number of callback calls, REGEX_ERROR or REGEX_ERROR_MEMORY */
+int regex_foreach(char* input_text_string, RegEx regex_data, regex_callback_t callback, void* userdata)
+{
+    int num_results = 0;
+    int STOP = 0;
+    int i = 0;
+    cregcursor_t cursor;
+
+    __ASSERT_PARAM(input_text_string, "input text string", ASSERT_TYPE_PTR);
+    __ASSERT_PARAM(regex_data, "RegEx regex data", ASSERT_TYPE_STRUCT);
+
+    if (regex_data == NULL || callback == NULL)
+    {
+        fprintf(stderr, "regex_foreach() error: RegEx object or callback function is not initialized.\n");
+        return REGEX_ERROR;
+    }
+
+    if ((regex_data->regex_h.reglib_status != REGLIB_COMPILED && regex_data->regex_h.reglib_status != REGLIB_EXECUTED) ||
+        regex_data->return_code == REGEX_ERROR)
+    {
+        fprintf(stderr, "regex_foreach() error: Regular expression is not compiled.\n");
+        return REGEX_ERROR;
+    }
+
+    if (_EXEC__INIT_CURSOR(&cursor, regex_data, input_text_string, (int)strlen(input_text_string), NULL) != REGEX_MATCH_SUCCESS)
+    {
+        return REGEX_ERROR_MEMORY;
+    }
+
+    while (STOP == 0 && _EXEC__NEXT_MATCH(&cursor) == REGEX_MATCH_SUCCESS)
+    {
+        for (i = 0; i < (int)cursor.num_match_slots && STOP == 0; i++)
+        {
+            if (_EXEC__IS_RESULT(regex_data, cursor.submatch_numbers[i]))
+            {
+                num_results += 1;
+                STOP = callback(cursor.number_match, cursor.submatch_numbers[i],
+                                (int)cursor.match_offsets[i].rm_so, (int)cursor.match_offsets[i].rm_eo, userdata);
+            }
+        }
+
+        /* without REG_GLOBAL just the first match */
+        if (regex_data->flags.GLOBAL == 0)
+        {
+            STOP = 1;
+        }
+    }
+
+    _EXEC__FREE_CURSOR(&cursor);
+
+    return num_results;
+}
+
+/* regex_results_init(RegExResults) - Initializes the result data for regex_exec_r().
+   -----------------------------------------------------------------------------------
+   Parameters:
+     RegExResults results: The result data */
+void regex_results_init(RegExResults results)
+{
+    __ASSERT_PARAM(results, "RegExResults results", ASSERT_TYPE_STRUCT);
+
+    results->matches = NULL;
+    results->num_matches = 0;
+    results->return_code = REGEX_INIT_SUCCESS;
+    results->match_offsets = NULL;
+    results->match_strings = NULL;
+    results->match_capacity = 0;
+    _ARENA__INIT(&results->arena);
+    _DFA__INIT_SET(&results->dfas);
+}
+
+/* regex_exec_r(char*, RegEx, RegExResults) - Executes a shared compiled regular expression pattern.
+   -------------------------------------------------------------------------------------------------
+   Description:
+     Executes a compiled regular expression pattern and writes the matches into the result data
+     instead of the RegEx object. The RegEx object is not changed, so one compiled pattern can be
+     executed by several threads at the same time, each with its own result data.
+     The memory of the previous matches of the result data is reused for the new matches.
+
+   Parameters:
+     char* input_text_string: The text input string for the regular expression
+     RegEx regex_data:        The compiled RegEx object
+     RegExResults results:    The result data, initialized by regex_results_init()
+
+   Return Value:
+     returns:      The return code of regexec() */
+int regex_exec_r(char* input_text_string, RegEx regex_data, RegExResults results)
+{
+    int return_code = -1;
+
+    __ASSERT_PARAM(input_text_string, "input text string", ASSERT_TYPE_PTR);
+    __ASSERT_PARAM(regex_data, "RegEx regex data", ASSERT_TYPE_STRUCT);
+    __ASSERT_PARAM(results, "RegExResults results", ASSERT_TYPE_STRUCT);
+
+    /* keep the arena memory of the previous matches */
+    _ARENA__RESET(&results->arena);
+    results->matches = NULL;
+    results->num_matches = 0;
+    results->match_offsets = NULL;
+    results->match_strings = NULL;
+    results->match_capacity = 0;
+
+    if ((regex_data->regex_h.reglib_status == REGLIB_COMPILED || regex_data->regex_h.reglib_status == REGLIB_EXECUTED) &&
+        regex_data->return_code != REGEX_ERROR)
+    {
+        results->return_code = REGEX_MATCH_SUCCESS;
+        return_code = _EXEC__SEARCH(input_text_string, (int)strlen(input_text_string), regex_data, results);
+
+        if (results->return_code != REGEX_ERROR)
+        {
+            results->return_code = return_code;
+        }
+    }
+    else
+    {
+        results->return_code = REGEX_ERROR;
+        fprintf(stderr, "regex_exec_r() error: Regular expression is not compiled.\n");
+    }
+
+    return return_code;
+}
+
+/* regex_results_free(RegExResults) - Frees the result data of regex_exec_r().
+   ---------------------------------------------------------------------------
+   Description:
+     Frees the matches of the result data and initializes it for the next regex_exec_r().
+
+   Parameters:
+     RegExResults results: The result data */
+void regex_results_free(RegExResults results)
+{
+    __ASSERT_PARAM(results, "RegExResults results", ASSERT_TYPE_STRUCT);
+
+    _ARENA__FREE(&results->arena);
+    _DFA__FREE_SET(&results->dfas);
+
+    regex_results_init(results);
+}
+
+/* regex_match_batch(RegEx, const char**, size_t, cregbatch_result_t*, int) - Matches many text strings.
+   -----------------------------------------------------------------------------------------------------
+   Description:
+     Executes a compiled regular expression pattern on each string of an array of text strings
+     and writes the match offsets into one result element per text string. The texts are split
+     into equal ranges for the threads, a thread which has finished its range steals half of the
+     remaining texts of another thread. The additional threads compile their own copy of the pattern,
+     because regex.h serializes the searches on one compiled pattern. The RegEx object is not changed
+     and the texts are not copied.
+     With REG_GLOBAL the matches of each text are counted. The offsets of sub-expressions and the
+     matched strings are not stored, regex_exec_r() returns them for single texts.
+     Without -pthread the texts are matched by the calling thread.
+
+   Parameters:
+     RegEx regex_data:                The compiled RegEx object
+     const char** input_text_strings: The text input strings for the regular expression
+     size_t num_texts:                Number of text input strings
+     cregbatch_result_t* results:     Array of num_texts result elements:
+                                      int return_code: REGEX_MATCH_SUCCESS, REG_NOMATCH, REGEX_ERROR for a NULL text
+                                                      or REGEX_ERROR_MEMORY
+                                      int num_matches: Number of matches
+                                      int start:       Start offset of the first match, -1 without match
+                                      int end:         End offset of the first match, -1 without match
+     int num_threads:                 Number of threads, 0 = NUM_THREADS or the number of processors
+
+   Return Value:
+     returns:      Number of matching text strings, REGEX_ERROR if the pattern is not compiled
+                   or REGEX_ERROR_MEMORY */
+int regex_match_batch(RegEx regex_data, const char** input_text_strings, size_t num_texts, cregbatch_result_t* results, int num_threads)
+{
+    int num_results = 0;
+    int i = 0;
+    size_t j = 0;
+    cregbatch_t batch;
+#ifdef _REENTRANT
+    int num_started = 1;
+    pthread_t* threads;
+#endif
+
+    __ASSERT_PARAM(regex_data, "RegEx regex data", ASSERT_TYPE_STRUCT);
+    __ASSERT_PARAM(input_text_strings, "input text strings", ASSERT_TYPE_STRUCT);
+    __ASSERT_PARAM(results, "batch results", ASSERT_TYPE_STRUCT);
+
+    if ((regex_data->regex_h.reglib_status != REGLIB_COMPILED && regex_data->regex_h.reglib_status != REGLIB_EXECUTED) ||
+        regex_data->return_code == REGEX_ERROR)
+    {
+        fprintf(stderr, "regex_match_batch() error: Regular expression is not compiled.\n");
+        return REGEX_ERROR;
+    }
+
+    if (num_texts == 0)
+    {
+        return 0;
+    }
+
+#ifdef _REENTRANT
+    if (num_threads <= 0)
+    {
+        num_threads = (int)_CONTEXT(num_threads, NUM_THREADS);
+    }
+    if (num_threads <= 0)
+    {
+        num_threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    }
+#else
+    num_threads = 1;
+#endif
+
+    /* at least one block of texts per thread */
+    if ((size_t)num_threads > num_texts / REGEX_BATCH_BLOCK_SIZE)
+    {
+        num_threads = (int)(num_texts / REGEX_BATCH_BLOCK_SIZE);
+    }
+    if (num_threads < 1)
+    {
+        num_threads = 1;
+    }
+
+#ifdef _REENTRANT
+    /* without memory for the threads the calling thread matches all texts */
+    threads = __TRY_MALLOC(num_threads * sizeof(pthread_t));
+
+    if (threads == NULL)
+    {
+        num_threads = 1;
+    }
+#endif
+
+    batch.workers = __TRY_MALLOC(num_threads * sizeof(cregbatch_worker_t));
+
+    if (batch.workers == NULL)
+    {
+#ifdef _REENTRANT
+        if (threads != NULL)
+        {
+            __FREE(threads);
+        }
+#endif
+        fprintf(stderr, "regex_match_batch() error: Could not allocate memory.\n");
+        return REGEX_ERROR_MEMORY;
+    }
+
+    batch.regex = regex_data;
+    batch.converted_pattern = num_threads > 1 ? _COMPILE__CONVERT_SEQUENCES(regex_data->pattern) : NULL;
+    batch.texts = input_text_strings;
+    batch.results = results;
+    batch.num_threads = num_threads;
+
+    /* equal ranges of texts for the threads */
+    for (i = 0; i < num_threads; i++)
+    {
+        batch.workers[i].next = num_texts / num_threads * i + (num_texts % num_threads) * i / num_threads;
+        batch.workers[i].end = num_texts / num_threads * (i + 1) + (num_texts % num_threads) * (i + 1) / num_threads;
+        batch.workers[i].index = i;
+        batch.workers[i].batch = &batch;
+#ifdef _REENTRANT
+        pthread_mutex_init(&batch.workers[i].mutex, NULL);
+#endif
+    }
+
+#ifdef _REENTRANT
+    /* match the texts with the calling thread and up to num_threads - 1 additional threads,
+       the calling thread steals the texts of threads which could not be created */
+    for (num_started = 1; num_started < num_threads; num_started++)
+    {
+        if (pthread_create(&threads[num_started], NULL, _BATCH__WORKER, &batch.workers[num_started]) != 0)
+        {
+            break;
+        }
+    }
+#endif
+
+    _BATCH__WORKER(&batch.workers[0]);
+
+#ifdef _REENTRANT
+    for (i = 1; i < num_started; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+
+    for (i = 0; i < num_threads; i++)
+    {
+        pthread_mutex_destroy(&batch.workers[i].mutex);
+    }
+
+    if (threads != NULL)
+    {
+        __FREE(threads);
+    }
+#endif
+
+    /* texts left by threads without memory for their buffers */
+    for (i = 0; i < num_threads; i++)
+    {
+        for (j = batch.workers[i].next; j < batch.workers[i].end; j++)
+        {
+            results[j].return_code = REGEX_ERROR_MEMORY;
+            results[j].num_matches = 0;
+            results[j].start = -1;
+            results[j].end = -1;
+        }
+    }
+
+    if (batch.converted_pattern != NULL)
+    {
+        __FREE(batch.converted_pattern);
+    }
+
+    __FREE(batch.workers);
+
+    for (j = 0; j < num_texts; j++)
+    {
+        if (results[j].return_code == REGEX_MATCH_SUCCESS)
+        {
+            num_results++;
+        }
+    }
+
+    return num_results;
+}
+
+/* regex_close(RegEx) - Frees the allocated memory.
+   ------------------------------------------------
+   Description:
+     Frees the memory of allocated regex.h buffers and sets the regfree status to 1
+
+   Parameters:
+     RegEx regex_data: The RegEx object */
+void regex_close(RegEx regex_data)
+{
+    __ASSERT_PARAM(regex_data, "RegEx regex data", ASSERT_TYPE_STRUCT);
+
+    if (regex_data != NULL &&
+        regex_data->regex_h.reglib_status != REGLIB_ERROR)
+    {
+        if (regex_data->regex_h.reglib_status == REGLIB_COMPILED ||
+            regex_data->regex_h.reglib_status == REGLIB_EXECUTED)
+        {
+            regex_data->regex_h.reglib_status = REGLIB_CLOSED;
+
+            if (regex_data->return_code != REGEX_ERROR)
+            {
+                _ARENA__FREE(&regex_data->regex_h.arena);
+                _DFA__FREE_SET(&regex_data->regex_h.dfas);
+                __FREE(regex_data->regex_h.text_buffer);
+                /*  void reg__FREE(regex_t *preg);
+                    ----------------------------
+                    Frees any memory that was allocated by regcomp() to implement preg.
+                    The expression defined by preg is no longer a compiled regular or extended expression. 
+                    
+                    preg: is a pointer to a compiled regular expression. */
+                if (regex_data->regex_h.cache_entry != NULL)
+                {
+                    _CACHE__RELEASE(regex_data);
+                }
+                else
+                {
+                    regfree(&regex_data->regex_h.compiled_regex);
+                    _PIKE__FREE(regex_data->regex_h.program);
+                }
+            }
+            __FREE(regex_data);            
+        }
+    }
+    else
+    {
+        fprintf(stderr, "regex_close() error: Regex object is not initialized.\n");
+    }
+}
+
+/* regex_match(char*, char*, int) - Matches regular expression pattern in a string.
+   --------------------------------------------------------------------------------
+   Description:
+     Compiles a regular expression pattern with given option flags, executes the
+     regular expression and returns the RegEx Object with the regular expression results.
+
+   Parameters:
+     char* input_text_string:    The string with the substrings to replace.
+     char* regex_pattern_string: The regular expression pattern
+     int OPTION_FLAGS:           The regular expression option flags:
+                                 REG_EXTENDED: Support extended regular expressions.
+                                 REG_ICASE:    Ignore case in match.
+                                 REG_NEWLINE:  Eliminate any special significance to the newline character.
+
+   Return Value:
+     returns:              The RegEx Object with the regular expression results,
+                           or NULL if the memory of the RegEx Object could not be allocated.
+
+     RegEx-Object:         matches[] matches:       The same array as match_offsets, but with sub-expression
+                                                    Strings of the matches and more readable offset variables
+                           int num_matches:         Number of matches
+                           int num_pattern_subexpr: Number of corresponding sub-expressions
+                           int return_code:         Return code of the expression string compilation
+                           char[] text;             The input text string 
+                           char[] pattern:          The regular expression string pattern
+                           char[] error_message:    Error message buffer
+                           regex_h_ref regex_h:     Reference to regex.h-variables */
+RegEx regex_match(char* input_text_string, char* regex_pattern_string, int OPTION_FLAGS)
+{
+    RegEx regex_data;
+
+    __ASSERT_PARAM(input_text_string, "input_text_string", ASSERT_TYPE_PTR);
+    __ASSERT_PARAM(regex_pattern_string, "regex_pattern_string", ASSERT_TYPE_PTR);
+    __ASSERT_PARAM(&OPTION_FLAGS, "OPTION_FLAGS", ASSERT_TYPE_INT);
+
+    regex_data = _CACHE__COMPILE(regex_pattern_string, OPTION_FLAGS, 0);
+
+    if (regex_data != NULL && regex_data->return_code != REGEX_ERROR)
+    {
+        if (regex_data->return_code == REGEX_COMP_SUCCESS)
+        {
+            regex_exec(input_text_string, regex_data);
+        }
+        else
+        {
+            regex_error(regex_data);
+        }
+    }
+
+    return regex_data;
+}
+
+/* regex_test(char*, char*, int) - Checks if a regular expression matches.
+   -----------------------------------------------------------------------
+   Description:
+     Compiles a regular expression pattern with REG_NOSUB and checks if it matches the input text string.
+     The search returns on the first match and no match data is stored.
+
+   Parameters:
+     char* input_text_string:    The text input string for the regular expression
+     char* regex_pattern_string: The regular expression string pattern
+     int OPTION_FLAGS:           The option flags
+
+   Return Value:
+     returns:      1 if the pattern matches, 0 if not, REGEX_ERROR or REGEX_ERROR_MEMORY */
+int regex_test(char* input_text_string, char* regex_pattern_string, int OPTION_FLAGS)
+{
+    int return_code = REGEX_ERROR;
+    RegEx regex_data;
+
+    __ASSERT_PARAM(input_text_string, "input_text_string", ASSERT_TYPE_PTR);
+    __ASSERT_PARAM(regex_pattern_string, "regex_pattern_string", ASSERT_TYPE_PTR);
+    __ASSERT_PARAM(&OPTION_FLAGS, "OPTION_FLAGS", ASSERT_TYPE_INT);
+
+    regex_data = _CACHE__COMPILE(regex_pattern_string, _DFA__SEARCH_FLAGS(input_text_string, OPTION_FLAGS), 1);
+
+    if (regex_data == NULL)
+    {
+        return REGEX_ERROR_MEMORY;
+    }
+
+    if (regex_data->return_code == REGEX_COMP_SUCCESS)
+    {
+        return_code = _EXEC__TEST(regex_data, input_text_string);
+    }
+    else
+    {
+        /* the RegEx object of a failed compilation is not closed by regex_close() */
+        regex_error(regex_data);
+        __FREE(regex_data->text);
+        __FREE(regex_data);
+
+        return REGEX_ERROR;
+    }
+
+    regex_close(regex_data);
+
+    return return_code;
+}
+
+/* regex_count(char*, char*, int) - Counts the matches of a regular expression.
+   ----------------------------------------------------------------------------
+   Description:
+     Compiles a regular expression pattern and counts its matches in the input text string,
+     without the matches of the sub-expressions and without storing match data.
+     Without REG_GLOBAL the pattern is compiled with REG_NOSUB and the result is 0 or 1.
+
+   Parameters:
+     char* input_text_string:    The text input string for the regular expression
+     char* regex_pattern_string: The regular expression string pattern
+     int OPTION_FLAGS:           The option flags
+
+   Return Value:
+     returns:      The number of matches, REGEX_ERROR or REGEX_ERROR_MEMORY */
+int regex_count(char* input_text_string, char* regex_pattern_string, int OPTION_FLAGS)
+{
+    int num_matches = REGEX_ERROR;
+    int GLOBAL = ((OPTION_FLAGS & REG_GLOBAL) == REG_GLOBAL);
+    int i = 0;
+    RegEx regex_data;
+    cregcursor_t cursor;
+
+    __ASSERT_PARAM(input_text_string, "input_text_string", ASSERT_TYPE_PTR);
+    __ASSERT_PARAM(regex_pattern_string, "regex_pattern_string", ASSERT_TYPE_PTR);
+    __ASSERT_PARAM(&OPTION_FLAGS, "OPTION_FLAGS", ASSERT_TYPE_INT);
+
+    /* get default REG_GLOBAL flag */
+    for (i = 0; i < (int)(sizeof(DEFAULT_REG_FLAGS) / sizeof(DEFAULT_REG_FLAGS[0])); i++)
+    {
+        if (_CONTEXT(default_reg_flags, DEFAULT_REG_FLAGS)[i] == REG_GLOBAL)
+        {
+            GLOBAL = 1;
+        }
+    }
+
+    /* the global search needs the match offsets, but not the offsets of the sub-expressions */
+    regex_data = _CACHE__COMPILE(regex_pattern_string, _DFA__SEARCH_FLAGS(input_text_string, (OPTION_FLAGS & ~REG_SUBEXP) | REG_NOSUBEXP), !GLOBAL);
+
+    if (regex_data == NULL)
+    {
+        return REGEX_ERROR_MEMORY;
+    }
+
+    if (regex_data->return_code == REGEX_COMP_SUCCESS)
+    {
+        if (regex_data->flags.GLOBAL == 0)
+        {
+            num_matches = _EXEC__TEST(regex_data, input_text_string);
+        }
+        else if (_EXEC__INIT_CURSOR(&cursor, regex_data, input_text_string, (int)strlen(input_text_string), NULL) == REGEX_MATCH_SUCCESS)
+        {
+            while (_EXEC__NEXT_MATCH(&cursor) == REGEX_MATCH_SUCCESS)
+            {
+                /* the cursor counts the matches */
+            }
+
+            num_matches = cursor.number_match;
+            _EXEC__FREE_CURSOR(&cursor);
+        }
+        else
+        {
+            num_matches = REGEX_ERROR_MEMORY;
+        }
+    }
+    else
+    {
+        /* the RegEx object of a failed compilation is not closed by regex_close() */
+        regex_error(regex_data);
+        __FREE(regex_data->text);
+        __FREE(regex_data);
+
+        return REGEX_ERROR;
+    }
+
+    regex_close(regex_data);
+
+    return num_matches;
+}
+
+/* regex_replace(char*, char*, char*,int) - Replaces regular expression matches with a substring.
+   ----------------------------------------------------------------------------------------------
+   Description:
+     Replaces words in a input text string found by the regular expression pattern with the
+     replacement substring.
+
+   Parameters:
+     char* input_text_string:    The string with the substrings to replace.
+     char* regex_pattern_string: The regular expression pattern
+     char* replace_substring:    The replcment substring
+     int option_flags:           The regular expression option flags:
+                                 REG_EXTENDED: Support extended regular expressions.
+                                 REG_ICASE:    Ignore case in match.
+                                 REG_NEWLINE:  Eliminate any special significance to the newline character.
+
+   Return Value:
+     returns:              The output string with the replaced substring values,
+                           or NULL if the memory of the RegEx Object could not be allocated */
+char* regex_replace(char* input_text_string, char* regex_pattern_string, char* replace_substring, int OPTION_FLAGS)
+{
+    int i = 0;
+    int start_position_difference = 0;
+    char* converted_input_text_string = __MALLOC((strlen(input_text_string) + 1) * sizeof(char)); 
+    char* converted_replace_substring;
+
+    RegEx regex_data = _CACHE__COMPILE(regex_pattern_string, OPTION_FLAGS, 0);
+
+    __ASSERT_PARAM(input_text_string, "input_text_string", ASSERT_TYPE_PTR);
+    __ASSERT_PARAM(replace_substring, "regex_pattern_string", ASSERT_TYPE_PTR);
+    __ASSERT_PARAM(replace_substring, "replace_substring", ASSERT_TYPE_PTR);
+    __ASSERT_PARAM(&OPTION_FLAGS, "OPTION_FLAGS", ASSERT_TYPE_INT);
+
+    if (regex_data == NULL)
+    {
+        __FREE(converted_input_text_string);
+        return NULL;
+    }
+
+    if (regex_data->return_code == REGEX_COMP_SUCCESS)
+    {
+        regex_exec(input_text_string, regex_data);
+        strcpy(converted_input_text_string, input_text_string);
+
+        /* replace the match with the replace substring */
+        for (i = 0; i < regex_data->num_matches; i++)
+        {
+            /* if match "$" = end of string: replace end of string with substring */
+            if (regex_data->matches[i].start == strlen(converted_input_text_string))
+            {
+                converted_input_text_string = __REALLOC(converted_input_text_string, (strlen(converted_input_text_string) + strlen(replace_substring) + 1) * sizeof(char));
+                strcat(converted_input_text_string, replace_substring);
+
+                break;
+            }
+
+            /* if match "^" = end of string: replace start of string with substring */
+            if (regex_data->matches[i].start == 0 &&
+                regex_data->matches[i].end == 0)
+            {
+                char* temp_string = __MALLOC((strlen(converted_input_text_string) + 1) * sizeof(char));
+                converted_input_text_string = __REALLOC(converted_input_text_string, (strlen(converted_input_text_string) + strlen(replace_substring) + 1) * sizeof(char));
+
+                strcpy(temp_string, converted_input_text_string);
+                converted_input_text_string[0] = '\0';
+                strcat(converted_input_text_string, replace_substring);
+                strcat(converted_input_text_string, temp_string);
+
+                __FREE(temp_string);
+
+                break;
+            }
+
+            if (regex_data->matches[i].start != regex_data->matches[i].end)
+            { 
+                if (regex_data->matches[i].number_submatch == 0)
+                {
+                    converted_replace_substring = _REPLACE__PREPROCESS_GROUPS(regex_data, replace_substring, i);
+                    converted_input_text_string = __SUBSTITUTE_STRING(converted_input_text_string, regex_data->matches[i].string, converted_replace_substring, REPLACE_NO_BRACKETS, REPLACE_LOCAL, regex_data->matches[i].start - start_position_difference);
+                    start_position_difference += strlen(regex_data->matches[i].string) - strlen(converted_replace_substring);
+                    __FREE(converted_replace_substring);
+                }
+            }
+        }
+    }
+    else
+    {
+        regex_error(regex_data);
+    }
+
+    regex_close(regex_data);
+    
+    return converted_input_text_string;
+}
+
+/* regex_cache_init(unsigned int) - Enables the compiled-pattern cache.
+   ---------------------------------------------------------------------
+   Description:
+     Enables the least recently used cache of compiled regular expressions for
+     regex_match() and regex_replace(). The patterns are cached by their pattern
+     string and option flags, so a repeated call skips the pattern conversion and regcomp().
+     Lowering the capacity removes the least recently used entries.
+
+   Parameters:
+     unsigned int capacity: The maximum number of cached patterns, 0 disables the cache */
+void regex_cache_init(unsigned int capacity)
+{
+    _CACHE__LOCK();
+    REGEX_CACHE_STATS.capacity = capacity;
+    _CACHE__EVICT(capacity);
+    _CACHE__UNLOCK();
+}
+
+/* regex_cache_stats() - Returns the status of the compiled-pattern cache.
+   -----------------------------------------------------------------------
+   Description:
+     Returns the capacity, the number of cached patterns and the hit and miss counters
+     of the compiled-pattern cache.
+
+   Return Value:
+     returns:     The cregcache_stats_t status object */
+cregcache_stats_t regex_cache_stats(void)
+{
+    cregcache_stats_t cache_stats;
+
+    _CACHE__LOCK();
+    cache_stats = REGEX_CACHE_STATS;
+    _CACHE__UNLOCK();
+
+    return cache_stats;
+}
+
+/* regex_cache_clear() - Clears the compiled-pattern cache.
+   --------------------------------------------------------
+   Description:
+     Removes all compiled patterns from the cache and resets the hit and miss counters.
+     The capacity of the cache is kept. */
+void regex_cache_clear(void)
+{
+    _CACHE__LOCK();
+    _CACHE__EVICT(0);
+    REGEX_CACHE_STATS.hits = 0;
+    REGEX_CACHE_STATS.misses = 0;
+    _CACHE__UNLOCK();
+}
+
+/* void regex_readfile(char*, char*, int): Reads a file and matches its contents.
+   ------------------------------------------------------------------------------
+   Description:
+     Reads the contentsfrom a file and matches its contents in the file-buffer.
+
+   Parameters:
+     file_name:                  The file-name of the file to read.
+     regex_data 
+
+   Return Value:
+     returns:                    The contents of a file as a pointer ot a char array */
+RegExFile regex_readfile(char* file_name)
+{
+    int error_code = 0;
+    RegExFile regex_file = __MALLOC(sizeof(cregfile_t));
+
+    __ASSERT_PARAM(file_name, "file_name", ASSERT_TYPE_PTR);
+
+    if (strlen(file_name) > _CONTEXT(max_filename_length, MAX_FILENAME_LENGTH))
+    {
+        fprintf(stderr, "Error: Length of Filename-Path exceeds maximum length of %d characters.\n", _CONTEXT(max_filename_length, MAX_FILENAME_LENGTH));
+        error_code = REGEX_ERROR;;
+    }
+
+    if (_CONTEXT(max_filename_length, MAX_FILENAME_LENGTH) > 1048576)
+    {
+        fprintf(stderr, "Error: MAX_FILENAME_LENGTH exceeds maximum size of 1048576 characters.\n");
+        error_code = REGEX_ERROR;
+    }
+
+    regex_file->ptr = NULL;
+    regex_file->name = "";
+    regex_file->length = 0;
+    regex_file->status = 0;
+    regex_file->mapped = 0;
+
+    if (error_code != REGEX_ERROR)
+    {
+        /* open file for reading */
+        regex_file->name = file_name;
+        regex_file->ptr = fopen(regex_file->name, "rb");
+
+        if (regex_file->ptr != NULL)
+        {
+            /* get filesize */
+            fseek(regex_file->ptr, 0, SEEK_END);
+            regex_file->length = ftell(regex_file->ptr);
+            rewind(regex_file->ptr);
 
-                /* concatinate all strings to list entry */
-                result_string = __REALLOC(result_string, (strlen(result_string) + strlen(output_string) + 32) * sizeof(char));
-                strcat(result_string, output_string);
-            }
-            else if (PRINT_LAYOUT == REGEX_PRINT_PLAIN)
+            if (_CONTEXT(max_text_length, MAX_TEXT_LENGTH) > 104857600)
             {
-                /* copy substring*/
-                output_string = __REALLOC(output_string, (strlen(regex_data->matches[i].string) + 256) * sizeof(char));
-                sprintf(output_string, "%s\n",
-                    regex_data->matches[i].string
-                );
-
-                /* concatinate result substring to output */
-                result_string = __REALLOC(result_string, (strlen(result_string) + strlen(output_string) + 32) * sizeof(char));
-                strcat(result_string, output_string);
+                fprintf(stderr, "Error: MAX_TEXT_LENGTH exceeds maximum size of 104857600 characters or 100 MB.\n");
+                regex_file->content = (char*)__MALLOC(1 * sizeof(char));
+                regex_file->status = 0;
             }
-            else if (PRINT_LAYOUT == REGEX_PRINT_CSV)
-            {
-                /* set all values and substring*/
-                output_string = __REALLOC(output_string, (strlen(regex_data->matches[i].string) + 256) * sizeof(char));
-
-                if (print_position)
+            else
+            {   
+                if (regex_file->length <= _CONTEXT(max_text_length, MAX_TEXT_LENGTH))
                 {
-                    sprintf(output_string, "%d;%d;%d;%d;%d;%s;\n",
-                        i, regex_data->matches[i].number_match,
-                        regex_data->matches[i].number_submatch,
-                        regex_data->matches[i].start,
-                        regex_data->matches[i].end,
-                        substring
-                    );
+                     /* read in file into buffer */
+                    regex_file->content = (char*)__MALLOC((regex_file->length + 1) * sizeof(char));
+                    regex_file->status = fread(regex_file->content,regex_file->length, 1, regex_file->ptr);
                 }
                 else
                 {
-                    sprintf(output_string, "%d;%d;%d;%s;\n",
-                        i, regex_data->matches[i].number_match,
-                        regex_data->matches[i].number_submatch,
-                        substring
-                    );
+                    fprintf(stderr, "Error: File length exceeds maximum length of %d characters.\n", _CONTEXT(max_text_length, MAX_TEXT_LENGTH));
+                    regex_file->content = (char*)__MALLOC(1 * sizeof(char));
+                    regex_file->status = 0;
                 }
+            }
 
-                /* concatinate result substring to output */
-                result_string = __REALLOC(result_string, (strlen(result_string) + strlen(output_string) + 32) * sizeof(char));
-                strcat(result_string, output_string);
+            if (regex_file->content != NULL &&
+                regex_file->status > 0)
+            {
+                regex_file->content[regex_file->length] = '\0';
             }
-            else if (PRINT_LAYOUT == REGEX_PRINT_JSON)
+            else
             {
-                substring = __SUBSTITUTE_STRING(substring, "\\", "\\\\", REPLACE_NO_BRACKETS, REPLACE_GLOBAL, 0);
+                strcpy(regex_file->content, "");
+            }
 
-                /* set all values and substring*/
-                output_string = __REALLOC(output_string, (strlen(regex_data->matches[i].string) + 256) * sizeof(char));
+            fclose(regex_file->ptr);
+        }
+        else
+        {
+            fprintf(stderr, "Error: File not found.\n");
+        }
+    }
+    else
+    {
+        fprintf(stderr, "regex_readfile() error: RegExFile object is not initialized.\n");
+    }
+    
+    return regex_file;
+}
 
-                if (print_position)
-                {
-                    if (PRINT_COLORED == 1)
-                    {
-                        sprintf(output_string, "\t\t{\n\
-\t\t\t\033[32m\"match-number\":\033[0m %d\033[90m,\033[0m\n\
-\t\t\t\033[32m\"group-number\":\033[0m %d\033[90m,\033[0m\n\
-\t\t\t\033[32m\"sub-string\":\033[0m \"%s\"\033[90m,\033[0m\n\
-\t\t\t\033[32m\"start\":\033[0m %d\033[90m,\033[0m\n\
-\t\t\t\033[32m\"end\":\033[0m %d\n",
-                        regex_data->matches[i].number_match,
-                        regex_data->matches[i].number_submatch,
-                        substring,
-                        regex_data->matches[i].start,
-                        regex_data->matches[i].end);
-                    }
-                    else
-                    {
-                        sprintf(output_string, "\t\t{\n\
-\t\t\t\"match-number\": %d,\n\
-\t\t\t\"group-number\": %d,\n\
-\t\t\t\"sub-string\": \"%s\",\n\
-\t\t\t\"start\": %d,\n\
-\t\t\t\"end\": %d\n",
-                        regex_data->matches[i].number_match,
-                        regex_data->matches[i].number_submatch,
-                        substring,
-                        regex_data->matches[i].start,
-                        regex_data->matches[i].end);
-                    }
-                }
-                else
-                {
-                    if (PRINT_COLORED == 1)
-                    {
-                        sprintf(output_string, "\t\t{\n\
-\t\t\t\033[32m\"match-number\":\033[0m %d\033[90m,\033[0m\n\
-\t\t\t\033[32m\"group-number\":\033[0m %d\033[90m,\033[0m\n\
-\t\t\t\033[32m\"sub-string\":\033[0m \"%s\"\n",
-                        regex_data->matches[i].number_match,
-                        regex_data->matches[i].number_submatch,
-                        substring);
-                    }
-                    else
-                    {
-                        sprintf(output_string, "\t\t{\n\
-\t\t\t\"match-number\": %d,\n\
-\t\t\t\"group-number\": %d,\n\
-\t\t\t\"sub-string\": \"%s\"\n",
-                        regex_data->matches[i].number_match,
-                        regex_data->matches[i].number_submatch,
-                        substring);
-                    }
-                }
+#ifdef REGEX_FILE_MAPPING
+/* (Internal) Size of the memory mapping of a file, which ends with at least one zero byte behind the file. */
+static size_t _FILE__MAPPING_LENGTH(int file_length)
+{
+    size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
 
-                strcat(output_string, "\t\t}");
-                
-                if (i < regex_data->num_matches-1)
-                {
-                     if (PRINT_COLORED == 1)
-                    {
-                        strcat(output_string, "\033[90m,\033[0m\n");
-                    }
-                    else
-                    {
-                        strcat(output_string, ",\n");
-                    }
-                }
-                else
-                {
-                    strcat(output_string, "\n");
-                }
+    return ((size_t)file_length / page_size + 1) * page_size;
+}
 
-                /* concatinate result substring to output */
-                result_string = __REALLOC(result_string, (strlen(result_string) + strlen(output_string) + 32) * sizeof(char));
-                strcat(result_string, output_string);
+/* regex_mapfile(char*) - Maps a file read-only into memory.
+   ---------------------------------------------------------
+   Description:
+     Maps the contents of a file read-only into memory instead of reading them into a buffer,
+     so the pages are read from the page cache when they are searched. The file length is not
+     limited by MAX_TEXT_LENGTH, but by the int offsets of regex.h (2 GB). The content is searched
+     with regex_exec_buffer() and REG_NOCOPY without a copy, the kernel is told that the pages are
+     read sequentially. The zero-filled rest of the last page, or a zero page for a file which ends
+     at a page boundary, terminates the content for the print functions.
+     The mapping is removed by regex_closefile().
+
+   Parameters:
+     char* file_name: The file-name of the file to map
+
+   Return Value:
+     returns:         The RegExFile object, the status is 1 if the file is mapped */
+RegExFile regex_mapfile(char* file_name)
+{
+    int file_descriptor;
+    int zero_descriptor;
+    struct stat file_stat;
+    size_t mapping_length;
+    void* mapping = MAP_FAILED;
+    RegExFile regex_file = __MALLOC(sizeof(cregfile_t));
+
+    __ASSERT_PARAM(file_name, "file_name", ASSERT_TYPE_PTR);
+
+    regex_file->ptr = NULL;
+    regex_file->name = file_name;
+    regex_file->content = "";
+    regex_file->length = 0;
+    regex_file->status = 0;
+    regex_file->mapped = 1;
+
+    if (strlen(file_name) > _CONTEXT(max_filename_length, MAX_FILENAME_LENGTH))
+    {
+        fprintf(stderr, "Error: Length of Filename-Path exceeds maximum length of %d characters.\n", _CONTEXT(max_filename_length, MAX_FILENAME_LENGTH));
+        return regex_file;
+    }
+
+    file_descriptor = open(file_name, O_RDONLY);
+
+    if (file_descriptor < 0)
+    {
+        fprintf(stderr, "Error: File not found.\n");
+        return regex_file;
+    }
+
+    if (fstat(file_descriptor, &file_stat) != 0 || !S_ISREG(file_stat.st_mode))
+    {
+        fprintf(stderr, "Error: File is not a regular file.\n");
+    }
+    else if (file_stat.st_size > INT_MAX)
+    {
+        fprintf(stderr, "Error: File length exceeds maximum length of %d characters.\n", INT_MAX);
+    }
+    else if (file_stat.st_size > 0)
+    {
+        mapping_length = _FILE__MAPPING_LENGTH((int)file_stat.st_size);
+
+        if (mapping_length - (size_t)file_stat.st_size < (size_t)sysconf(_SC_PAGESIZE))
+        {
+            /* the rest of the last page behind the file is filled with zero bytes */
+            mapping = mmap(NULL, (size_t)file_stat.st_size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+        }
+        else if ((zero_descriptor = open("/dev/zero", O_RDONLY)) >= 0)
+        {
+            /* the file ends at a page boundary: map it over the start of zero pages */
+            mapping = mmap(NULL, mapping_length, PROT_READ, MAP_PRIVATE, zero_descriptor, 0);
+            close(zero_descriptor);
+
+            if (mapping != MAP_FAILED &&
+                mmap(mapping, (size_t)file_stat.st_size, PROT_READ, MAP_PRIVATE | MAP_FIXED, file_descriptor, 0) == MAP_FAILED)
+            {
+                munmap(mapping, mapping_length);
+                mapping = MAP_FAILED;
             }
         }
-        if (PRINT_LAYOUT == REGEX_PRINT_JSON)
+
+        /* the mapping stays valid after the file is closed */
+        if (mapping != MAP_FAILED)
+        {
+#if defined(MADV_SEQUENTIAL)
+            madvise(mapping, (size_t)file_stat.st_size, MADV_SEQUENTIAL);
+#elif defined(POSIX_MADV_SEQUENTIAL)
+            posix_madvise(mapping, (size_t)file_stat.st_size, POSIX_MADV_SEQUENTIAL);
+#endif
+            regex_file->content = (char*)mapping;
+            regex_file->length = (int)file_stat.st_size;
+            regex_file->status = 1;
+        }
+        else
         {
-            strcat(result_string, "\t]\n}\n");
+            fprintf(stderr, "Error: Could not map file into memory.\n");
         }
     }
-    else
+
+    close(file_descriptor);
+
+    return regex_file;
+}
+#endif
+
+/* regex_closefile(RegExFile) - Frees the allocated memory for a input file.
+   -------------------------------------------------------------------------
+   Description:
+     Frees the memory of allocated buffers fór a file, or removes the memory mapping of regex_mapfile()
+
+   Parameters:
+     RegExFile regex_file: The RegExFile object */
+void regex_closefile(RegExFile regex_file)
+{
+    if (regex_file != NULL)
     {
-        if (PRINT_LAYOUT != REGEX_PRINT_CSV &&
-            PRINT_LAYOUT != REGEX_PRINT_JSON)
+#ifdef REGEX_FILE_MAPPING
+        if (regex_file->mapped == 1)
+        {
+            if (regex_file->length > 0)
+            {
+                munmap(regex_file->content, _FILE__MAPPING_LENGTH(regex_file->length));
+            }
+        }
+        else
+        {
+            __FREE(regex_file->content);
+        }
+#else
+        __FREE(regex_file->content);
+#endif
+        __FREE(regex_file);
+    }
+}
+
+/* (Internal) Appends the next chunk of a stream to the carried bytes of the buffer, returns the number of bytes read or REGEX_ERROR_MEMORY. */
+static int _STREAM__READ_CHUNK(RegExStream regex_stream)
+{
+    int num_bytes = 0;
+    char* buffer;
+
+    /* the buffer only grows for a line which is longer than a chunk */
+    if (regex_stream->buffer_length + regex_stream->chunk_size + 1 > regex_stream->buffer_size)
+    {
+        buffer = __TRY_REALLOC(regex_stream->buffer, (regex_stream->buffer_length + regex_stream->chunk_size + 1) * sizeof(char));
+
+        if (buffer == NULL)
+        {
+            return REGEX_ERROR_MEMORY;
+        }
+
+        regex_stream->buffer = buffer;
+        regex_stream->buffer_size = regex_stream->buffer_length + regex_stream->chunk_size + 1;
+    }
+
+    if (regex_stream->status == 1)
+    {
+        num_bytes = (int)fread(regex_stream->buffer + regex_stream->buffer_length, 1, regex_stream->chunk_size, regex_stream->ptr);
+        regex_stream->buffer_length += num_bytes;
+    }
+
+    return num_bytes;
+}
+
+/* (Internal) Searches a stream chunk by chunk with a compiled regular expression and calls a function for each match. */
+static long _STREAM__SEARCH(RegExStream regex_stream, RegEx regex_data, regex_t* compiled_regex, regex_stream_callback_t callback, void* userdata)
+{
+    long num_results = 0;
+    int number_match = 0;
+    int search_start = 0;
+    int search_length = 0;
+    int scan_position = 0;
+    int carry_position = 0;
+    int num_bytes = 0;
+    int STOP = 0;
+    int FINAL = 0;
+    int i = 0;
+    char saved_character;
+    cregcursor_t cursor;
+
+    if (_EXEC__INIT_CURSOR(&cursor, regex_data, "", 0, NULL) != REGEX_MATCH_SUCCESS)
+    {
+        return REGEX_ERROR_MEMORY;
+    }
+
+    cursor.compiled_regex = compiled_regex;
+
+    while (STOP == 0 && FINAL == 0)
+    {
+        num_bytes = _STREAM__READ_CHUNK(regex_stream);
+
+        /* without memory for a longer line the search stops with an error */
+        if (num_bytes == REGEX_ERROR_MEMORY)
+        {
+            fprintf(stderr, "regex_foreach_stream() error: Could not allocate memory for the stream buffer.\n");
+            num_results = REGEX_ERROR_MEMORY;
+            break;
+        }
+
+        /* search the complete lines of the buffer, or the rest at the end of the input */
+        if (num_bytes == 0)
         {
-            strcpy(result_string, "\nNo match\n");
+            FINAL = 1;
+            search_length = regex_stream->buffer_length;
         }
         else
         {
-            strcpy(result_string, "No match\n");
+            /* only the bytes after scan_position are new, the carried bytes have no newline character */
+            for (search_length = regex_stream->buffer_length; search_length > scan_position; search_length--)
+            {
+                if (regex_stream->buffer[search_length - 1] == '\n')
+                {
+                    break;
+                }
+            }
+
+            /* no complete line: read the next chunk, a line of max_line_length bytes is searched in parts
+               without the last chunk, so the last part at the end of the input is not empty */
+            if (search_length == scan_position &&
+                (regex_stream->buffer_length < regex_stream->max_line_length || scan_position <= search_start))
+            {
+                scan_position = regex_stream->buffer_length;
+                continue;
+            }
+        }
+
+        /* terminate the searched part for regexec() without REG_STARTEND */
+        saved_character = regex_stream->buffer[search_length];
+        regex_stream->buffer[search_length] = '\0';
+
+        cursor.text = regex_stream->buffer;
+        cursor.text_length = search_length;
+        cursor.read_position = search_start;
+        cursor.number_match = number_match;
+        cursor.finished = 0;
+
+        /* the search starts after the carried character before it, so "^" matches at a line start after a chunk boundary
+           only with REG_NEWLINE and "\`" only at the start of the input, "$" matches only at the end of the input */
+        cursor.eflags = ((search_start > 0 && regex_data->flags.NEWLINE == 0) ? REG_NOTBOL : 0) |
+                        (FINAL == 0 ? REG_NOTEOL : 0);
+
+        while (STOP == 0 && _EXEC__NEXT_MATCH(&cursor) == REGEX_MATCH_SUCCESS)
+        {
+            /* an empty match at the end of a search before the end of the input, like the one of "\'", is searched again by the next search */
+            if (FINAL == 0 && cursor.match_offsets[0].rm_so == search_length)
+            {
+                cursor.number_match -= 1;
+                break;
+            }
+
+            for (i = 0; i < (int)cursor.num_match_slots && STOP == 0; i++)
+            {
+                if (_EXEC__IS_RESULT(regex_data, cursor.submatch_numbers[i]))
+                {
+                    num_results += 1;
+                    STOP = callback(cursor.number_match, cursor.submatch_numbers[i],
+                                    regex_stream->offset + (long)cursor.match_offsets[i].rm_so,
+                                    regex_stream->offset + (long)cursor.match_offsets[i].rm_eo,
+                                    regex_stream->buffer + cursor.match_offsets[i].rm_so, userdata);
+                }
+            }
+
+            /* without REG_GLOBAL just the first match, an empty match stops the global search */
+            if (regex_data->flags.GLOBAL == 0 ||
+                cursor.match_offsets[0].rm_so == cursor.match_offsets[0].rm_eo)
+            {
+                STOP = 1;
+            }
         }
+
+        regex_stream->buffer[search_length] = saved_character;
+        number_match = cursor.number_match;
+
+        /* carry the unfinished last line over to the next chunk with the last searched character, the context of the next search start */
+        carry_position = (search_length > 0) ? search_length - 1 : 0;
+        search_start = (search_length > 0) ? 1 : search_start;
+
+        memmove(regex_stream->buffer, regex_stream->buffer + carry_position, regex_stream->buffer_length - carry_position);
+        regex_stream->buffer_length -= carry_position;
+        regex_stream->offset += carry_position;
+        scan_position = regex_stream->buffer_length;
     }
-    
-    __FREE(substring);
-    __FREE(output_string);
-    
-    return result_string;
+
+    /* the input is read to its end, or the search is stopped */
+    regex_stream->status = 2;
+
+    _EXEC__FREE_CURSOR(&cursor);
+
+    return num_results;
 }
 
-/* (Internal) Processes the complete string (text + data + results) for printing or writing  */
-static char* _PRINT__GET_OUTPUT_STRING(RegEx regex_data, int PRINT_LAYOUT)
+/* regex_openstream(char*) - Opens an input for reading in chunks.
+   ---------------------------------------------------------------
+   Description:
+     Opens a file, a named pipe or stdin for regex_foreach_stream(). The input is not read at
+     once, but in chunks of chunk_size bytes, which can be changed before the first search like
+     max_line_length, the length after which a line without a newline character is searched in parts.
+     The status is 2 when the input is read to its end.
+
+   Parameters:
+     char* file_name: The file-name of the file to read, "-" or NULL for stdin
+
+   Return Value:
+     returns:         The RegExStream object, the status is 1 if the input is open, or NULL without memory */
+RegExStream regex_openstream(char* file_name)
 {
-    int PRINT_OPTIONS = PRINT_LAYOUT;
-    char* output_string;
-    char* temp_string;
+    RegExStream regex_stream = __TRY_MALLOC(sizeof(cregstream_t));
 
-    /* filter print options from print layout */
-    if ((PRINT_LAYOUT & REGEX_PRINT_FULLTEXT) == REGEX_PRINT_FULLTEXT)
+    if (regex_stream == NULL)
     {
-        PRINT_LAYOUT = PRINT_LAYOUT - REGEX_PRINT_FULLTEXT;
-        MAX_PRINT_TEXT_LENGTH = 0;
+        fprintf(stderr, "regex_openstream() error: Could not allocate memory.\n");
+        return NULL;
     }
-    if ((PRINT_LAYOUT & REGEX_PRINT_NOTEXT) == REGEX_PRINT_NOTEXT)
+
+    regex_stream->name = (file_name != NULL) ? file_name : "-";
+    regex_stream->buffer = NULL;
+    regex_stream->buffer_size = 0;
+    regex_stream->buffer_length = 0;
+    regex_stream->chunk_size = REGEX_STREAM_CHUNK_SIZE;
+    regex_stream->max_line_length = REGEX_STREAM_MAX_LINE_LENGTH;
+    regex_stream->offset = 0;
+    regex_stream->status = 0;
+
+    if (strlen(regex_stream->name) > _CONTEXT(max_filename_length, MAX_FILENAME_LENGTH))
     {
-        PRINT_LAYOUT = PRINT_LAYOUT - REGEX_PRINT_NOTEXT;
+        fprintf(stderr, "Error: Length of Filename-Path exceeds maximum length of %d characters.\n", _CONTEXT(max_filename_length, MAX_FILENAME_LENGTH));
+        regex_stream->ptr = NULL;
+        return regex_stream;
     }
-    if ((PRINT_LAYOUT & REGEX_PRINT_NOSTATS) == REGEX_PRINT_NOSTATS)
+
+    regex_stream->ptr = (strcmp(regex_stream->name, "-") == 0) ? stdin : fopen(regex_stream->name, "rb");
+
+    if (regex_stream->ptr != NULL)
     {
-        PRINT_LAYOUT = PRINT_LAYOUT - REGEX_PRINT_NOSTATS;
+        regex_stream->status = 1;
     }
-    if ((PRINT_LAYOUT & REGEX_PRINT_NORESULTS) == REGEX_PRINT_NORESULTS)
+    else
     {
-        PRINT_LAYOUT = PRINT_LAYOUT - REGEX_PRINT_NORESULTS;
+        fprintf(stderr, "Error: File not found.\n");
     }
-    if ((PRINT_LAYOUT & REGEX_PRINT_NOINDEX) == REGEX_PRINT_NOINDEX)
+
+    return regex_stream;
+}
+
+/* regex_foreach_stream(RegExStream, RegEx, regex_stream_callback_t, void*) - Calls a function for each match in a stream.
+   ----------------------------------------------------------------------------------------------------------------------
+   Description:
+     Reads a stream in chunks and calls the callback function for each match and group like
+     regex_foreach(), with the offsets from the start of the input. Each search ends at the last
+     newline character of the buffer, the unfinished last line is carried over to the next chunk,
+     so the memory use stays at about two chunks for inputs of any length, unless a line is
+     longer than a chunk. Matches do not span the end of a line at a chunk boundary: the
+     pattern should be compiled with REG_NEWLINE and should not match a newline character.
+     The stream is read until its end, or until the callback or an empty match stops the search,
+     a stream is searched only once.
+
+   Parameters:
+     RegExStream regex_stream:         The stream of regex_openstream()
+     RegEx regex_data:                 The compiled RegEx object
+     regex_stream_callback_t callback: int callback(int number_match, int number_submatch, long start, long end,
+                                       char* match_text, void* userdata), returns 0 to continue or another value to stop
+     void* userdata:                   Pointer passed to each call of the callback function
+
+   Return Value:
+     returns:      The number of callback calls, REGEX_ERROR or REGEX_ERROR_MEMORY */
+long regex_foreach_stream(RegExStream regex_stream, RegEx regex_data, regex_stream_callback_t callback, void* userdata)
+{
+    __ASSERT_PARAM(regex_stream, "RegExStream regex_stream", ASSERT_TYPE_STRUCT);
+    __ASSERT_PARAM(regex_data, "RegEx regex data", ASSERT_TYPE_STRUCT);
+
+    if (regex_stream == NULL || regex_data == NULL || callback == NULL)
     {
-        PRINT_LAYOUT = PRINT_LAYOUT - REGEX_PRINT_NOINDEX;
+        fprintf(stderr, "regex_foreach_stream() error: RegExStream object, RegEx object or callback function is not initialized.\n");
+        return REGEX_ERROR;
     }
-    if ((PRINT_LAYOUT & REGEX_PRINT_FILTER) == REGEX_PRINT_FILTER)
+
+    if ((regex_data->regex_h.reglib_status != REGLIB_COMPILED && regex_data->regex_h.reglib_status != REGLIB_EXECUTED) ||
+        regex_data->return_code == REGEX_ERROR)
     {
-        PRINT_LAYOUT = PRINT_LAYOUT - REGEX_PRINT_FILTER;
+        fprintf(stderr, "regex_foreach_stream() error: Regular expression is not compiled.\n");
+        return REGEX_ERROR;
     }
 
-    if (1)
+    /* the input is not open or read to its end */
+    if (regex_stream->status != 1)
     {
-        temp_string = _PRINT__CONCAT_OPTION_FLAGS(regex_data);
+        return 0;
+    }
 
-        if ((PRINT_OPTIONS & REGEX_PRINT_NOTEXT) != REGEX_PRINT_NOTEXT &&
-            (regex_data->return_code == REGEX_COMP_SUCCESS ||
-             regex_data->return_code == REGEX_MATCH_SUCCESS))
-        {
-            output_string = _PRINT__GET_TEXT_STRING(regex_data);
-        }
-        else
+    return _STREAM__SEARCH(regex_stream, regex_data, &regex_data->regex_h.compiled_regex, callback, userdata);
+}
+
+/* regex_closestream(RegExStream) - Closes a stream.
+   -------------------------------------------------
+   Description:
+     Closes the file of a stream, but not stdin, and frees the buffer and the RegExStream object.
+
+   Parameters:
+     RegExStream regex_stream: The RegExStream object */
+void regex_closestream(RegExStream regex_stream)
+{
+    if (regex_stream != NULL)
+    {
+        if (regex_stream->ptr != NULL && regex_stream->ptr != stdin)
         {
-            output_string = __MALLOC(512 * sizeof(char)); 
-            strcpy(output_string, "");
+            fclose(regex_stream->ptr);
         }
 
-        if ((PRINT_OPTIONS & REGEX_PRINT_NOSTATS) != REGEX_PRINT_NOSTATS)
+        if (regex_stream->buffer != NULL)
         {
-            temp_string = _PRINT__GET_REGEX_STATS(regex_data, temp_string);
-            strcat(output_string, temp_string);
+            __FREE(regex_stream->buffer);
         }
-        
-        strcpy(temp_string, "");
-        __FREE(temp_string);
-    }
-    else
-    {
-        output_string = __MALLOC(32 * sizeof(char)); 
-        strcpy(output_string, "");
+
+        __FREE(regex_stream);
     }
-    
-    if ((PRINT_OPTIONS & REGEX_PRINT_NORESULTS) != REGEX_PRINT_NORESULTS &&
-        (regex_data->return_code == REGEX_COMP_SUCCESS ||
-         regex_data->return_code == REGEX_MATCH_SUCCESS))
-    {
-        temp_string = _PRINT__GET_RESULTS(
-            regex_data,
-            PRINT_LAYOUT,
-            !((PRINT_OPTIONS & REGEX_PRINT_NOTEXT) == REGEX_PRINT_NOTEXT &&
-              (PRINT_OPTIONS & REGEX_PRINT_NOSTATS) == REGEX_PRINT_NOSTATS),    /* print header or not */
-            !((PRINT_OPTIONS & REGEX_PRINT_NOINDEX) == REGEX_PRINT_NOINDEX)         /* print match position or not */
-        );
+}
 
-        output_string =__REALLOC(output_string, (strlen(output_string) + strlen(temp_string) + 32) * sizeof(char));
-        strcat(output_string, temp_string);
-        strcpy(temp_string, "");
-        __FREE(temp_string);
+#ifdef REGEX_TREE_SEARCH
+/* (Internal) Stops a tree search, the lock of the tree is held by the caller. */
+static void _TREE__STOP(cregtree_t* tree, int memory_error)
+{
+    tree->stopped = 1;
+
+    if (memory_error)
+    {
+        tree->memory_error = 1;
     }
 
-    return output_string;
+#ifdef _REENTRANT
+    pthread_cond_broadcast(&tree->file_cond);
+#endif
+#ifdef REGEX_TREE_PREFETCH
+    pthread_cond_signal(&tree->prefetch_cond);
+#endif
 }
 
-/* set_default_reg_flags() - Sets the default REG_ flags for regex_compile() and regcomp()
-   ---------------------------------------------------------------------------------------
-   regex.h-Library-Documentation:
-   REG_EXTENDED: Support extended regular expressions.
-   REG_ICASE:    Ignore case in match.
-   REG_NEWLINE:  Eliminate any special significance to the newline character.
-   REG_NOSUB:    Report only success or fail in regexec(), that is, verify the syntax of a regular expression.
-                 If this flag is set, the regcomp() function sets re_nsub to the number of parenthesized sub-expressions found in pattern.
-                 Otherwise, a sub-expression results in an error.
-                 (-> This option is not deactivated)
-
-   extended flags:
-   REG_GLOBAL    Uses global-search with multiple matches instead of single matching
-   REG_MULTILINE Catches the newline character, automaticly deactivates REG_NEWLINE
-   REG_NOSUBEXP  Ignore matching of grouped submatches by SUBEXPpressions */
-void set_default_reg_flags(int OPTION_FLAGS)
+/* (Internal) Adds a file or the files of a directory and its subdirectories to the files of a tree search. */
+static void _TREE__ADD_FILES(cregtree_t* tree, char* path, cregtree_directory_t* parent)
 {
-    int i;
-
-    for (i = 0; i < 7; i++)
+    struct stat path_stat;
+    struct dirent* entry;
+    cregtree_directory_t directory;
+    cregtree_directory_t* ancestor;
+    char* entry_path;
+    char* file_name;
+    char** file_names;
+    DIR* directory_ptr;
+    int stopped = 0;
+
+    if (stat(path, &path_stat) != 0)
     {
-        DEFAULT_REG_FLAGS[i] = 0;
+        return;
     }
 
-    for (i = 0; i < 7; i++)
+    if (S_ISREG(path_stat.st_mode))
     {
-        if ((OPTION_FLAGS & REG_GLOBAL) == REG_GLOBAL)
-        {
-            DEFAULT_REG_FLAGS[i] = REG_GLOBAL;
-            i++;
-        }
-        if ((OPTION_FLAGS & REG_EXTENDED) == REG_EXTENDED)
-        {
-            DEFAULT_REG_FLAGS[i] = REG_EXTENDED;
-            i++;
-        }
-        if ((OPTION_FLAGS & REG_ICASE) == REG_ICASE)
-        {
-            DEFAULT_REG_FLAGS[i] = REG_ICASE;
-            i++;
-        }
-        if ((OPTION_FLAGS & REG_NEWLINE) == REG_NEWLINE)
+        file_name = __TRY_MALLOC((strlen(path) + 1) * sizeof(char));
+
+        if (file_name != NULL)
         {
-            DEFAULT_REG_FLAGS[i] = REG_NEWLINE;
-            i++;
+            strcpy(file_name, path);
         }
-        if ((OPTION_FLAGS & REG_NOSUB) == REG_NOSUB)
+
+        /* the searching threads take the files while the walk goes on */
+        _TREE__LOCK(tree);
+
+        if (file_name != NULL && tree->num_files == tree->file_capacity)
         {
-            DEFAULT_REG_FLAGS[i] = REG_NOSUB;
-            i++;
+            file_names = __TRY_REALLOC(tree->file_names, ((tree->file_capacity > 0) ? tree->file_capacity * 2 : 64) * sizeof(char*));
+
+            if (file_names != NULL)
+            {
+                tree->file_names = file_names;
+                tree->file_capacity = (tree->file_capacity > 0) ? tree->file_capacity * 2 : 64;
+            }
+            else
+            {
+                __FREE(file_name);
+                file_name = NULL;
+            }
         }
-        if ((OPTION_FLAGS & REG_MULTILINE) == REG_MULTILINE)
+
+        if (file_name != NULL)
         {
-            DEFAULT_REG_FLAGS[i] = REG_MULTILINE;
-            i++;
+            tree->file_names[tree->num_files++] = file_name;
+#ifdef _REENTRANT
+            pthread_cond_signal(&tree->file_cond);
+#endif
+#ifdef REGEX_TREE_PREFETCH
+            pthread_cond_signal(&tree->prefetch_cond);
+#endif
         }
-        if ((OPTION_FLAGS & REG_NOSUBEXP) == REG_NOSUBEXP)
+        else
         {
-            DEFAULT_REG_FLAGS[i] = REG_NOSUBEXP;
-            i++;
+            _TREE__STOP(tree, 1);
         }
-    }
-}
-
-/* regex_compile(char*, int) - Compiles the regular expression pattern.
-   --------------------------------------------------------------------
-   Description:
-     Compiles a regular expression pattern with given option flags.
-
-   Parameters:
-     char* regex_pattern_string: The regular expression pattern
-     int option_flags:     The regular expression option flags:
-                           REG_EXTENDED: Support extended regular expressions.
-                           REG_ICASE:    Ignore case in match.
-                           REG_NEWLINE:  Eliminate any special significance to the newline character.
-
-   Return Value:
-     returns:              The unexecuted RegEx Object without the regular expression results. */
-RegEx regex_compile(char* regex_pattern_string, int OPTION_FLAGS)
-{
-    RegEx regex_data = _COMPILE__INIT_REGEX(regex_pattern_string, OPTION_FLAGS);
 
-    __ASSERT_PARAM(regex_pattern_string, "regex_pattern_string", ASSERT_TYPE_PTR);
-    __ASSERT_PARAM(&OPTION_FLAGS, "OPTION_FLAGS", ASSERT_TYPE_INT);
+        _TREE__UNLOCK(tree);
+        return;
+    }
 
-    if (MAX_PATTERN_LENGTH > 16384)
+    if (!S_ISDIR(path_stat.st_mode))
     {
-        sprintf(regex_data->error_message, "MAX_PATTERN_LENGTH exceeds maximum size of 16384\n");
-        regex_data->return_code = REGEX_ERROR;
+        return;
     }
 
-    if (regex_data != NULL && regex_data->return_code == REGEX_INIT_SUCCESS)
+    /* a symbolic link to a directory on the path would repeat the search endlessly */
+    for (ancestor = parent; ancestor != NULL; ancestor = ancestor->parent)
     {
-        /* compile regular expression */
-        if (strlen(regex_pattern_string) < MAX_PATTERN_LENGTH)
+        if (ancestor->device == path_stat.st_dev && ancestor->inode == path_stat.st_ino)
         {
-            /* convert regular expression character classes */
-            char* converted_regex_pattern_string = _COMPILE__CONVERT_SEQUENCES(regex_pattern_string);
+            return;
+        }
+    }
 
-            /*  int regcomp(regex_t * preg, const char*  pattern, int cflags);
-                --------------------------------------------------------------
-                Compiles the regular expression specified by pattern into an executable string of op-codes.
+    directory.parent = parent;
+    directory.device = path_stat.st_dev;
+    directory.inode = path_stat.st_ino;
 
-                preg:       is a pointer to a compiled regular expression.
-                pattern:    is a pointer to a character string defining a source regular expression (described below).
-                cflags:     is a bit flag defining configurable attributes of compilation process:
-                            REG_EXTENDED: Support extended regular expressions.
-                            REG_ICASE:    Ignore case in match.
-                            REG_NEWLINE:  Eliminate any special significance to the newline character.
-                            REG_NOSUB:    Report only success or fail in regexec(), that is, verify the syntax of a regular expression.
-                                          If this flag is set, the regcomp() function sets re_nsub to the number of parenthesized sub-expressions found in pattern.
-                                          Otherwise, a sub-expression results in an error.
+    if ((directory_ptr = opendir(path)) == NULL)
+    {
+        fprintf(stderr, "Error: Could not open directory %s.\n", path);
+        return;
+    }
 
-                return:     If successful, regcomp() returns 0.
-                            If unsuccessful, regcomp() returns nonzero, and the content of preg is undefined. */
-            regex_data->return_code = regcomp(&regex_data->regex_h.compiled_regex, converted_regex_pattern_string, regex_data->regex_h.reglib_flags);
-            regex_data->num_pattern_subexpr = (int)regex_data->regex_h.compiled_regex.re_nsub;
-            __FREE(converted_regex_pattern_string);
-        }
-        else
+    /* the walk ends when the callback or a memory error stops the search */
+    while (stopped == 0 && (entry = readdir(directory_ptr)) != NULL)
+    {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0 ||
+            (entry->d_name[0] == '.' && (tree->options & REGEX_TREE_HIDDEN) == 0))
         {
-            regex_data->return_code = REGEX_ERROR;
-            sprintf(regex_data->error_message, "Pattern string exceeds maximum length of %d\n", MAX_PATTERN_LENGTH);
+            continue;
         }
 
-        if (strlen(regex_pattern_string) == 0)
-        {
-            regex_data->return_code = REGEX_ERROR;
-            sprintf(regex_data->error_message, "Regular expression pattern is empty\n");
-        }
+        entry_path = __TRY_MALLOC((strlen(path) + strlen(entry->d_name) + 2) * sizeof(char));
 
-        /* set regex.h status */
-        if (regex_data->return_code == REGEX_COMP_SUCCESS)
+        if (entry_path != NULL)
         {
-            strcpy(regex_data->error_message, "No error");
-            regex_data->regex_h.reglib_status = REGLIB_COMPILED;
+            sprintf(entry_path, (path[strlen(path) - 1] == '/') ? "%s%s" : "%s/%s", path, entry->d_name);
+            _TREE__ADD_FILES(tree, entry_path, &directory);
+            __FREE(entry_path);
         }
-        else if (regex_data->return_code == REGEX_ERROR)
+
+        _TREE__LOCK(tree);
+
+        if (entry_path == NULL)
         {
-            regex_data->regex_h.reglib_status = REGLIB_ERROR;
+            _TREE__STOP(tree, 1);
         }
-    }
-    else
-    {
-        fprintf(stderr, "regex_compile() error: Regex object is not initialized.\n");
+
+        stopped = tree->stopped;
+        _TREE__UNLOCK(tree);
     }
 
-    return regex_data;
+    closedir(directory_ptr);
 }
 
-/* regex_error(RegEx) - Writes and prints the error message buffer.
-   ----------------------------------------------------------------
-   Description:
-     Writes the error code message of regerror() into the error message buffer
-     and prints the error message to stderr.
-
-   Parameters:
-     RegEx regex_data: The RegEx object
-
-   Return Value:
-     returns:     The return code of regerror() */
-int regex_error(RegEx regex_data)
+/* (Internal) Stream callback, appends a match to the matches of a file. */
+static int _TREE__COLLECT_MATCH(int number_match, int number_submatch, long start, long end, char* match_text, void* file_data)
 {
-    __ASSERT_PARAM(regex_data, "RegEx regex data", ASSERT_TYPE_STRUCT);
-
-    if (regex_data != NULL)
-    {
-        /*  size_t regerror(int errcode, const regex_t *preg, char* errbuf, size_t errbuf_size);
-            ------------------------------------------------------------------------------------
-            Finds the description for errcode. 
-
-            preg:        is a pointer to a compiled regular expression.
-            errbuf:      is the message string buffer for the error description.
-            errbuf_size: is the size of the message string buffer
+    cregtree_file_t* file = file_data;
+    cregtree_match_t* matches;
 
-            return:      regerror() returns the integer value that is the size of the buffer needed to
-                         hold the generated description string for the error condition corresponding to errcode.
-
-            regerror() returns the following messages:
+    (void)match_text;
 
-                REG_BADBR:    Invalid \{ \} range exp
-                REG_BADPAT:   Invalid regular expression
-                REG_BADRPT:   ?*+ not preceded by valid RE
-                REG_EBOL:     ¬ anchor and not BOL
-                REG_EBRACE:   \{ \} or { } imbalance
-                REG_EBRACK:   [] imbalance
-                REG_ECHAR:    Invalid multibyte character
-                REG_ECOLLATE: Invalid collating element
-                REG_ECTYPE:   Invalid character class
-                REG_EEOL:     $ anchor and not EOL
-                REG_EESCAPE:  Last character is \
-                REG_EPAREN:   \( \) or () imbalance
-                REG_ERANGE:   Invalid range exp endpoint
-                REG_ESPACE:   Out of memory
-                REG_ESUBREG:  Invalid number in \digit
-                REG_NOMATCH:  RE pattern not found */
-        regerror(regex_data->return_code, &regex_data->regex_h.compiled_regex, regex_data->error_message, (size_t)sizeof(regex_data->error_message));
-        fprintf(stderr, "Error: %s\n\n", regex_data->error_message);
-        regex_data->regex_h.reglib_status = REGLIB_ERROR;
-    }
-    else
+    /* without memory the search of the file stops */
+    if (file->num_matches == file->match_capacity)
     {
-        fprintf(stderr, "regex_error(): Regex object is not initialized.\n");
-    }
+        matches = __TRY_REALLOC(file->matches, ((file->match_capacity > 0) ? file->match_capacity * 2 : 16) * sizeof(cregtree_match_t));
 
-    return regex_data->return_code;
-}
+        if (matches == NULL)
+        {
+            file->memory_error = 1;
+            return 1;
+        }
+
+        file->matches = matches;
+        file->match_capacity = (file->match_capacity > 0) ? file->match_capacity * 2 : 16;
+    }
 
-/* regex_exec(char*, RegEx) - Executes a compiled regular expression pattern.
-   --------------------------------------------------------------------------
-   Description:
-     Executes a compiled regular expression pattern and compares it with a given text input string.
+    file->matches[file->num_matches].number_match = number_match;
+    file->matches[file->num_matches].number_submatch = number_submatch;
+    file->matches[file->num_matches].start = start;
+    file->matches[file->num_matches].end = end;
+    file->num_matches++;
 
-   Parameters:
-     char* input_text_string: The text input string for the regular expression
-     RegEx regex_data:  The compiled RegEx object
+    return 0;
+}
 
-   Return Value:
-     returns:      The return code of regexec() */
-int regex_exec(char* input_text_string, RegEx regex_data)
+/* (Internal) Searches a file of a tree search and calls the callback function with its matches. */
+static void _TREE__SEARCH_FILE(cregtree_t* tree, regex_t* compiled_regex, char* file_name)
 {
-    int return_code = -1;
+    cregtree_file_t file;
+    RegExStream regex_stream = regex_openstream(file_name);
 
-    __ASSERT_PARAM(input_text_string, "input text string", ASSERT_TYPE_PTR);
-    __ASSERT_PARAM(regex_data, "RegEx regex data", ASSERT_TYPE_STRUCT);
+    file.matches = NULL;
+    file.num_matches = 0;
+    file.match_capacity = 0;
+    file.memory_error = (regex_stream == NULL);
 
-    if (regex_data != NULL)
+    /* a file with a NUL byte in the first chunk is a binary file */
+    if (regex_stream != NULL && regex_stream->status == 1)
     {
-        if (MAX_NUM_MATCHES > 3200000)
+        if (_STREAM__READ_CHUNK(regex_stream) < 0)
         {
-            sprintf(regex_data->error_message, "MAX_NUM_MATCHES exceeds maximum size of 8192\n");
-            regex_data->return_code = REGEX_ERROR;
+            file.memory_error = 1;
         }
-
-        if (regex_data->regex_h.reglib_status == REGLIB_COMPILED && regex_data->return_code == REGEX_COMP_SUCCESS)
+        else if ((tree->options & REGEX_TREE_BINARY) == REGEX_TREE_BINARY ||
+                 memchr(regex_stream->buffer, '\0', regex_stream->buffer_length) == NULL)
         {
-            regex_data->text = __REALLOC(regex_data->text, (strlen(input_text_string) + 1) * sizeof(char));
-            strcpy(regex_data->text, input_text_string);
-
-            /* REG_GLOBAL set: search the whole text string for multiple matches of the regular expression */
-            if (regex_data->flags.GLOBAL == 0)
-            {
-                return_code = _EXEC__SEARCH_LOCAL(input_text_string, regex_data);
-            }
-            else
+            if (_STREAM__SEARCH(regex_stream, tree->regex, compiled_regex, _TREE__COLLECT_MATCH, &file) == REGEX_ERROR_MEMORY)
             {
-                return_code = _EXEC__SEARCH_GLOBAL(input_text_string, regex_data);
+                file.memory_error = 1;
             }
         }
-        else
+    }
+
+    regex_closestream(regex_stream);
+
+    /* the callback is called by one thread at a time, the incomplete matches of a memory error are not passed */
+    if (file.num_matches > 0 || file.memory_error == 1)
+    {
+        _TREE__LOCK(tree);
+
+        if (file.memory_error == 1)
         {
-            fprintf(stderr, "regex_exec() error: Regular expression is not compiled.\n");
+            _TREE__STOP(tree, 1);
+        }
+        else if (tree->stopped == 0)
+        {
+            tree->num_results += file.num_matches;
+
+            if (tree->callback(file_name, file.matches, file.num_matches, tree->userdata) != 0)
+            {
+                _TREE__STOP(tree, 0);
+            }
         }
+
+        _TREE__UNLOCK(tree);
     }
-    else
+
+    if (file.matches != NULL)
     {
-        fprintf(stderr, "regex_exec() error: RegEx object is not initialized.\n");
+        __FREE(file.matches);
     }
-    
-    return return_code;
 }
 
-/* regex_close(RegEx) - Frees the allocated memory.
-   ------------------------------------------------
-   Description:
-     Frees the memory of allocated regex.h buffers and sets the regfree status to 1
-
-   Parameters:
-     RegEx regex_data: The RegEx object */
-void regex_close(RegEx regex_data)
+/* (Internal) Thread function, searches the next files until all files are searched. */
+static void* _TREE__WORKER(void* tree_data)
 {
-    __ASSERT_PARAM(regex_data, "RegEx regex data", ASSERT_TYPE_STRUCT);
+    cregtree_t* tree = tree_data;
+    char* file_name = NULL;
+    regex_t compiled_regex;
+    regex_t* worker_regex = &tree->regex->regex_h.compiled_regex;
+    RegExContext previous_context = regex_context_set(&tree->context);
+
+    /* the regex.h library serializes the regexec() calls on one compiled pattern,
+       so each thread searches with its own copy, the Pike VM program is shared */
+    if (tree->converted_pattern != NULL && _PIKE__SEARCH_PROGRAM(tree->regex) == NULL &&
+        regcomp(&compiled_regex, tree->converted_pattern, tree->regex->regex_h.reglib_flags) == REGEX_COMP_SUCCESS)
+    {
+        worker_regex = &compiled_regex;
+    }
 
-    if (regex_data != NULL &&
-        regex_data->regex_h.reglib_status != REGLIB_ERROR)
+    while (1)
     {
-        if (regex_data->regex_h.reglib_status == REGLIB_COMPILED ||
-            regex_data->regex_h.reglib_status == REGLIB_EXECUTED)
+        _TREE__LOCK(tree);
+#ifdef _REENTRANT
+        /* wait for the next file of the directory walk */
+        while (tree->stopped == 0 && tree->next_file >= tree->num_files && tree->walking == 1)
         {
-            int i;
-            regex_data->regex_h.reglib_status = REGLIB_CLOSED;
-
-            if (regex_data->return_code != REGEX_ERROR)
-            {
-                for (i = 0; i < regex_data->num_matches; i++)
-                {
-                    __FREE(regex_data->matches[i].string);
-                }
-                __FREE(regex_data->matches);
-                __FREE(regex_data->text);
-                /*  void reg__FREE(regex_t *preg);
-                    ----------------------------
-                    Frees any memory that was allocated by regcomp() to implement preg.
-                    The expression defined by preg is no longer a compiled regular or extended expression. 
-                    
-                    preg: is a pointer to a compiled regular expression. */
-                __FREE(regex_data->regex_h.match_offsets);
-                regfree(&regex_data->regex_h.compiled_regex);
-            }
-            __FREE(regex_data);            
+            pthread_cond_wait(&tree->file_cond, &tree->mutex);
+        }
+#endif
+        file_name = (tree->stopped == 0 && tree->next_file < tree->num_files) ? tree->file_names[tree->next_file++] : NULL;
+#ifdef REGEX_TREE_PREFETCH
+        pthread_cond_signal(&tree->prefetch_cond);
+#endif
+        _TREE__UNLOCK(tree);
+
+        if (file_name == NULL)
+        {
+            break;
         }
+
+        _TREE__SEARCH_FILE(tree, worker_regex, file_name);
     }
-    else
+
+    if (worker_regex == &compiled_regex)
     {
-        fprintf(stderr, "regex_close() error: Regex object is not initialized.\n");
+        regfree(&compiled_regex);
     }
-}
-
-/* regex_match(char*, char*, int) - Matches regular expression pattern in a string.
-   --------------------------------------------------------------------------------
-   Description:
-     Compiles a regular expression pattern with given option flags, executes the
-     regular expression and returns the RegEx Object with the regular expression results.
 
-   Parameters:
-     char* input_text_string:    The string with the substrings to replace.
-     char* regex_pattern_string: The regular expression pattern
-     int OPTION_FLAGS:           The regular expression option flags:
-                                 REG_EXTENDED: Support extended regular expressions.
-                                 REG_ICASE:    Ignore case in match.
-                                 REG_NEWLINE:  Eliminate any special significance to the newline character.
+    regex_context_set(previous_context);
 
-   Return Value:
-     returns:              The RegEx Object with the regular expression results.
+    return NULL;
+}
 
-     RegEx-Object:         matches[] matches:       The same array as match_offsets, but with sub-expression
-                                                    Strings of the matches and more readable offset variables
-                           int num_matches:         Number of matches
-                           int num_pattern_subexpr: Number of corresponding sub-expressions
-                           int return_code:         Return code of the expression string compilation
-                           char[] text;             The input text string 
-                           char[] pattern:          The regular expression string pattern
-                           char[] error_message:    Error message buffer
-                           regex_h_ref regex_h:     Reference to regex.h-variables */
-RegEx regex_match(char* input_text_string, char* regex_pattern_string, int OPTION_FLAGS)
+#ifdef REGEX_TREE_PREFETCH
+/* (Internal) Starts the reading of the first bytes of a file into the page cache. */
+static void _TREE__PREFETCH_FILE(char* file_name)
 {
-    RegEx regex_data;
+    int file_descriptor = open(file_name, O_RDONLY);
 
-    __ASSERT_PARAM(input_text_string, "input_text_string", ASSERT_TYPE_PTR);
-    __ASSERT_PARAM(regex_pattern_string, "regex_pattern_string", ASSERT_TYPE_PTR);
-    __ASSERT_PARAM(&OPTION_FLAGS, "OPTION_FLAGS", ASSERT_TYPE_INT);
+    if (file_descriptor >= 0)
+    {
+        posix_fadvise(file_descriptor, 0, REGEX_TREE_PREFETCH_LENGTH, POSIX_FADV_WILLNEED);
+        close(file_descriptor);
+    }
+}
 
-    regex_data = regex_compile(regex_pattern_string, OPTION_FLAGS);
+/* (Internal) Thread function, reads the files ahead of the searching threads. */
+static void* _TREE__PREFETCHER(void* tree_data)
+{
+    cregtree_t* tree = tree_data;
+    char* file_name = NULL;
 
-    if (regex_data != NULL && regex_data->return_code != REGEX_ERROR)
+    pthread_mutex_lock(&tree->mutex);
+
+    while (tree->stopped == 0)
     {
-        if (regex_data->return_code == REGEX_COMP_SUCCESS)
+        /* the files which are already taken by the searching threads are not read ahead */
+        if (tree->prefetch_next < tree->next_file)
         {
-            regex_exec(input_text_string, regex_data);
+            tree->prefetch_next = tree->next_file;
         }
-        else
+
+        if (tree->prefetch_next >= tree->num_files && tree->walking == 0)
         {
-            regex_error(regex_data);
+            break;
+        }
+
+        /* keep REGEX_TREE_PREFETCH_DEPTH files in flight, and wait for the next file of the directory walk */
+        if (tree->prefetch_next >= tree->next_file + REGEX_TREE_PREFETCH_DEPTH || tree->prefetch_next >= tree->num_files)
+        {
+            pthread_cond_wait(&tree->prefetch_cond, &tree->mutex);
+            continue;
         }
+
+        file_name = tree->file_names[tree->prefetch_next++];
+
+        pthread_mutex_unlock(&tree->mutex);
+        _TREE__PREFETCH_FILE(file_name);
+        pthread_mutex_lock(&tree->mutex);
     }
 
-    return regex_data;
-}
+    pthread_mutex_unlock(&tree->mutex);
 
-/* regex_replace(char*, char*, char*,int) - Replaces regular expression matches with a substring.
-   ----------------------------------------------------------------------------------------------
-   Description:
-     Replaces words in a input text string found by the regular expression pattern with the
-     replacement substring.
+    return NULL;
+}
+#endif
 
-   Parameters:
-     char* input_text_string:    The string with the substrings to replace.
-     char* regex_pattern_string: The regular expression pattern
-     char* replace_substring:    The replcment substring
-     int option_flags:           The regular expression option flags:
-                                 REG_EXTENDED: Support extended regular expressions.
-                                 REG_ICASE:    Ignore case in match.
-                                 REG_NEWLINE:  Eliminate any special significance to the newline character.
+/* (Internal) Initializes the shared data of a tree search. */
+static void _TREE__INIT(cregtree_t* tree, RegEx regex_data, int options, regex_tree_callback_t callback, void* userdata)
+{
+    tree->regex = regex_data;
+    tree->converted_pattern = NULL;
+    tree->file_names = NULL;
+    tree->num_files = 0;
+    tree->file_capacity = 0;
+    tree->next_file = 0;
+    tree->walking = 0;
+    tree->options = options;
+    tree->callback = callback;
+    tree->userdata = userdata;
+    tree->stopped = 0;
+    tree->memory_error = 0;
+    tree->num_results = 0;
+    tree->prefetch_next = 0;
+
+    /* the threads use the limits and options of the calling thread */
+    if (_CONTEXT__GET() != NULL)
+    {
+        tree->context = *_CONTEXT__GET();
+    }
+    else
+    {
+        regex_context_init(&tree->context);
+    }
+}
 
-   Return Value:
-     returns:              The output string with the replaced substring values */
-char* regex_replace(char* input_text_string, char* regex_pattern_string, char* replace_substring, int OPTION_FLAGS)
+/* (Internal) Searches the files of a tree search with threads while the calling thread walks the directory, returns the number of matches. */
+static long _TREE__SEARCH(cregtree_t* tree, char* root_path)
 {
+#ifdef _REENTRANT
     int i = 0;
-    int start_position_difference = 0;
-    char* converted_input_text_string = __MALLOC((strlen(input_text_string) + 1) * sizeof(char)); 
-    char* converted_replace_substring;
+    int num_threads = (int)_CONTEXT(num_threads, NUM_THREADS);
+    int num_started = 1;
+    pthread_t* threads = NULL;
+#ifdef REGEX_TREE_PREFETCH
+    pthread_t prefetch_thread;
+    int prefetching = 0;
+#endif
+
+    if (num_threads == 0)
+    {
+        num_threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    }
 
-    RegEx regex_data = regex_compile(regex_pattern_string, OPTION_FLAGS);
+    /* the number of files of a directory walk is not known before the search */
+    if (root_path == NULL && num_threads > tree->num_files)
+    {
+        num_threads = tree->num_files;
+    }
 
-    __ASSERT_PARAM(input_text_string, "input_text_string", ASSERT_TYPE_PTR);
-    __ASSERT_PARAM(replace_substring, "regex_pattern_string", ASSERT_TYPE_PTR);
-    __ASSERT_PARAM(replace_substring, "replace_substring", ASSERT_TYPE_PTR);
-    __ASSERT_PARAM(&OPTION_FLAGS, "OPTION_FLAGS", ASSERT_TYPE_INT);
+    /* without memory for the threads: the calling thread searches all files */
+    if (num_threads > 1 && (threads = __TRY_MALLOC(num_threads * sizeof(pthread_t))) == NULL)
+    {
+        num_threads = 1;
+    }
 
-    if (regex_data->return_code == REGEX_COMP_SUCCESS)
+    if (num_threads > 1)
     {
-        regex_exec(input_text_string, regex_data);
-        strcpy(converted_input_text_string, input_text_string);
+        tree->converted_pattern = _COMPILE__CONVERT_SEQUENCES(tree->regex->pattern);
+    }
 
-        /* replace the match with the replace substring */
-        for (i = 0; i < regex_data->num_matches; i++)
+    tree->walking = (root_path != NULL);
+
+    pthread_mutex_init(&tree->mutex, NULL);
+    pthread_cond_init(&tree->file_cond, NULL);
+    pthread_cond_init(&tree->prefetch_cond, NULL);
+
+#ifdef REGEX_TREE_PREFETCH
+    /* the searching threads should not wait for the reads of the next files, without the thread the files are not read ahead */
+    prefetching = (pthread_create(&prefetch_thread, NULL, _TREE__PREFETCHER, tree) == 0);
+#endif
+
+    /* search the files with the calling thread and up to num_threads - 1 additional threads,
+       the calling thread also searches the files of threads which could not be created */
+    for (num_started = 1; num_started < num_threads; num_started++)
+    {
+        if (pthread_create(&threads[num_started], NULL, _TREE__WORKER, tree) != 0)
         {
-            /* if match "$" = end of string: replace end of string with substring */
-            if (regex_data->matches[i].start == strlen(converted_input_text_string))
-            {
-                converted_input_text_string = __REALLOC(converted_input_text_string, (strlen(converted_input_text_string) + strlen(replace_substring) + 1) * sizeof(char));
-                strcat(converted_input_text_string, replace_substring);
+            break;
+        }
+    }
 
-                break;
-            }
+    /* the calling thread walks the directory while the other threads search the files found so far,
+       and then searches the remaining files */
+    if (root_path != NULL)
+    {
+        _TREE__ADD_FILES(tree, root_path, NULL);
+
+        _TREE__LOCK(tree);
+        tree->walking = 0;
+        pthread_cond_broadcast(&tree->file_cond);
+#ifdef REGEX_TREE_PREFETCH
+        pthread_cond_signal(&tree->prefetch_cond);
+#endif
+        _TREE__UNLOCK(tree);
+    }
 
-            /* if match "^" = end of string: replace start of string with substring */
-            if (regex_data->matches[i].start == 0 &&
-                regex_data->matches[i].end == 0)
-            {
-                char* temp_string = __MALLOC((strlen(converted_input_text_string) + 1) * sizeof(char));
-                converted_input_text_string = __REALLOC(converted_input_text_string, (strlen(converted_input_text_string) + strlen(replace_substring) + 1) * sizeof(char));
+    _TREE__WORKER(tree);
 
-                strcpy(temp_string, converted_input_text_string);
-                converted_input_text_string[0] = '\0';
-                strcat(converted_input_text_string, replace_substring);
-                strcat(converted_input_text_string, temp_string);
+    for (i = 1; i < num_started; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
 
-                __FREE(temp_string);
+#ifdef REGEX_TREE_PREFETCH
+    if (prefetching)
+    {
+        pthread_join(prefetch_thread, NULL);
+    }
+#endif
 
-                break;
-            }
+    pthread_cond_destroy(&tree->prefetch_cond);
+    pthread_cond_destroy(&tree->file_cond);
+    pthread_mutex_destroy(&tree->mutex);
 
-            if (regex_data->matches[i].start != regex_data->matches[i].end)
-            { 
-                if (regex_data->matches[i].number_submatch == 0)
-                {
-                    converted_replace_substring = _REPLACE__PREPROCESS_GROUPS(regex_data, replace_substring, i);
-                    converted_input_text_string = __SUBSTITUTE_STRING(converted_input_text_string, regex_data->matches[i].string, converted_replace_substring, REPLACE_NO_BRACKETS, REPLACE_LOCAL, regex_data->matches[i].start - start_position_difference);
-                    start_position_difference += strlen(regex_data->matches[i].string) - strlen(converted_replace_substring);
-                    __FREE(converted_replace_substring);
-                }
-            }
-        }
+    if (threads != NULL)
+    {
+        __FREE(threads);
     }
-    else
+
+    if (tree->converted_pattern != NULL)
     {
-        regex_error(regex_data);
+        __FREE(tree->converted_pattern);
+    }
+#else
+    if (root_path != NULL)
+    {
+        _TREE__ADD_FILES(tree, root_path, NULL);
     }
 
-    regex_close(regex_data);
-    
-    return converted_input_text_string;
+    _TREE__WORKER(tree);
+#endif
+
+    return (tree->memory_error == 1) ? REGEX_ERROR_MEMORY : tree->num_results;
 }
 
-/* void regex_readfile(char*, char*, int): Reads a file and matches its contents.
-   ------------------------------------------------------------------------------
+/* regex_search_tree(char*, RegEx, int, regex_tree_callback_t, void*) - Searches the files of a directory tree.
+   -----------------------------------------------------------------------------------------------------------
    Description:
-     Reads the contentsfrom a file and matches its contents in the file-buffer.
+     Walks a directory and its subdirectories and searches each regular file with a RegExStream
+     like regex_foreach_stream(), with NUM_THREADS threads (0 = number of processors) which take
+     the next file until all files are searched. The calling thread walks the directory while the
+     other threads already search the files found so far. Hidden files and directories, whose names start
+     with a dot, and binary files with a NUL byte in the first chunk are skipped without options.
+     Symbolic links are followed, except to a directory on the path. The callback function is
+     called once for each file with matches, by one thread at a time and in no fixed order of
+     the files. Without -pthread the files are searched by the calling thread.
 
    Parameters:
-     file_name:                  The file-name of the file to read.
-     regex_data 
+     char* root_path:                The path of a directory or a file
+     RegEx regex_data:               The compiled RegEx object
+     int options:                    REGEX_TREE_DEFAULT or the flags:
+                                     REGEX_TREE_HIDDEN: Also search hidden files and directories
+                                     REGEX_TREE_BINARY: Also search binary files
+     regex_tree_callback_t callback: int callback(char* file_name, cregtree_match_t* matches, int num_matches, void* userdata),
+                                     returns 0 to continue or another value to stop the search
+     void* userdata:                 Pointer passed to each call of the callback function
 
    Return Value:
-     returns:                    The contents of a file as a pointer ot a char array */
-RegExFile regex_readfile(char* file_name)
+     returns:      The number of matches of the files passed to the callback function, REGEX_ERROR or REGEX_ERROR_MEMORY */
+long regex_search_tree(char* root_path, RegEx regex_data, int options, regex_tree_callback_t callback, void* userdata)
 {
-    int error_code = 0;
-    RegExFile regex_file = __MALLOC(sizeof(cregfile_t));
-
-    __ASSERT_PARAM(file_name, "file_name", ASSERT_TYPE_PTR);
+    int i = 0;
+    long num_results = 0;
+    cregtree_t tree;
 
-    if (strlen(file_name) > MAX_FILENAME_LENGTH)
-    {
-        fprintf(stderr, "Error: Length of Filename-Path exceeds maximum length of %d characters.\n", MAX_FILENAME_LENGTH);
-        error_code = REGEX_ERROR;;
-    }
+    __ASSERT_PARAM(root_path, "root path", ASSERT_TYPE_PTR);
+    __ASSERT_PARAM(regex_data, "RegEx regex data", ASSERT_TYPE_STRUCT);
 
-    if (MAX_FILENAME_LENGTH > 1048576)
+    if (root_path == NULL || regex_data == NULL || callback == NULL)
     {
-        fprintf(stderr, "Error: MAX_FILENAME_LENGTH exceeds maximum size of 1048576 characters.\n");
-        error_code = REGEX_ERROR;
+        fprintf(stderr, "regex_search_tree() error: Root path, RegEx object or callback function is not initialized.\n");
+        return REGEX_ERROR;
     }
 
-    regex_file->ptr = NULL;
-    regex_file->name = "";
-    regex_file->length = 0;
-    regex_file->status = 0;
-
-    if (error_code != REGEX_ERROR)
+    if ((regex_data->regex_h.reglib_status != REGLIB_COMPILED && regex_data->regex_h.reglib_status != REGLIB_EXECUTED) ||
+        regex_data->return_code == REGEX_ERROR)
     {
-        /* open file for reading */
-        regex_file->name = file_name;
-        regex_file->ptr = fopen(regex_file->name, "rb");
-
-        if (regex_file->ptr != NULL)
-        {
-            /* get filesize */
-            fseek(regex_file->ptr, 0, SEEK_END);
-            regex_file->length = ftell(regex_file->ptr);
-            rewind(regex_file->ptr);
+        fprintf(stderr, "regex_search_tree() error: Regular expression is not compiled.\n");
+        return REGEX_ERROR;
+    }
 
-            if (MAX_TEXT_LENGTH > 104857600)
-            {
-                fprintf(stderr, "Error: MAX_TEXT_LENGTH exceeds maximum size of 104857600 characters or 100 MB.\n");
-                regex_file->content = (char*)__MALLOC(1 * sizeof(char));
-                regex_file->status = 0;
-            }
-            else
-            {   
-                if (regex_file->length <= MAX_TEXT_LENGTH)
-                {
-                     /* read in file into buffer */
-                    regex_file->content = (char*)__MALLOC((regex_file->length + 1) * sizeof(char));
-                    regex_file->status = fread(regex_file->content,regex_file->length, 1, regex_file->ptr);
-                }
-                else
-                {
-                    fprintf(stderr, "Error: File length exceeds maximum length of %d characters.\n", MAX_TEXT_LENGTH);
-                    regex_file->content = (char*)__MALLOC(1 * sizeof(char));
-                    regex_file->status = 0;
-                }
-            }
+    _TREE__INIT(&tree, regex_data, options, callback, userdata);
 
-            if (regex_file->content != NULL &&
-                regex_file->status > 0)
-            {
-                regex_file->content[regex_file->length] = '\0';
-            }
-            else
-            {
-                strcpy(regex_file->content, "");
-            }
+    num_results = _TREE__SEARCH(&tree, root_path);
 
-            fclose(regex_file->ptr);
-        }
-        else
-        {
-            fprintf(stderr, "Error: File not found.\n");
-        }
+    for (i = 0; i < tree.num_files; i++)
+    {
+        __FREE(tree.file_names[i]);
     }
-    else
+
+    if (tree.file_names != NULL)
     {
-        fprintf(stderr, "regex_readfile() error: RegExFile object is not initialized.\n");
+        __FREE(tree.file_names);
     }
-    
-    return regex_file;
+
+    return num_results;
 }
 
-/* regex_closefile(RegExFile) - Frees the allocated memory for a input file.
-   -------------------------------------------------------------------------
+/* regex_search_files(char**, int, RegEx, int, regex_tree_callback_t, void*) - Searches a list of files.
+   ----------------------------------------------------------------------------------------------------
    Description:
-     Frees the memory of allocated buffers fór a file
+     Searches the files of a list like regex_search_tree() searches the files of a directory tree,
+     with NUM_THREADS threads and the files read ahead by a prefetch thread. The list is not copied
+     and files which can not be opened or read are skipped.
 
    Parameters:
-     RegExFile regex_file: The RegExFile object */
-void regex_closefile(RegExFile regex_file)
+     char** file_names:              The paths of the files
+     int num_files:                  Number of files
+     RegEx regex_data:               The compiled RegEx object
+     int options:                    REGEX_TREE_DEFAULT or REGEX_TREE_BINARY: Also search binary files
+     regex_tree_callback_t callback: int callback(char* file_name, cregtree_match_t* matches, int num_matches, void* userdata),
+                                     returns 0 to continue or another value to stop the search
+     void* userdata:                 Pointer passed to each call of the callback function
+
+   Return Value:
+     returns:      The number of matches of the files passed to the callback function, REGEX_ERROR or REGEX_ERROR_MEMORY */
+long regex_search_files(char** file_names, int num_files, RegEx regex_data, int options, regex_tree_callback_t callback, void* userdata)
 {
-    if (regex_file != NULL)
+    cregtree_t tree;
+
+    __ASSERT_PARAM(file_names, "file names", ASSERT_TYPE_PTR);
+    __ASSERT_PARAM(regex_data, "RegEx regex data", ASSERT_TYPE_STRUCT);
+
+    if (file_names == NULL || regex_data == NULL || callback == NULL)
     {
-        __FREE(regex_file->content);
-        __FREE(regex_file);
+        fprintf(stderr, "regex_search_files() error: File names, RegEx object or callback function is not initialized.\n");
+        return REGEX_ERROR;
+    }
+
+    if ((regex_data->regex_h.reglib_status != REGLIB_COMPILED && regex_data->regex_h.reglib_status != REGLIB_EXECUTED) ||
+        regex_data->return_code == REGEX_ERROR)
+    {
+        fprintf(stderr, "regex_search_files() error: Regular expression is not compiled.\n");
+        return REGEX_ERROR;
     }
+
+    _TREE__INIT(&tree, regex_data, options, callback, userdata);
+    tree.file_names = file_names;
+    tree.num_files = num_files;
+
+    return _TREE__SEARCH(&tree, NULL);
 }
+#endif
 
 /* int regex_writefile(RegEx, int, char*): Writes the contents of a RegEx Object into a file.
    ------------------------------------------------------------------------------------------
    Description:
      Writes the input text and the regular expression results and contents of a
-     RegEx Object as a table or table into a file.
+     RegEx Object as a table or table into a file. REGEX_PRINT_NDJSON and REGEX_PRINT_BINARY
+     write only the results, like regex_export().
 
    Parameters:
      regex_data    The regular expression RegEx Object of compact-regex.h
@@ -2032,13 +7267,15 @@ void regex_closefile(RegExFile regex_file)
 int regex_writefile(RegEx regex_data, int PRINT_LAYOUT, char* file_name)
 {
     char* output_string;
+    cregcontext_t file_context;
+    RegExContext previous_context;
     /* char *full_filepath; */
 
     __ASSERT_PARAM(regex_data, "RegEx regex_data", ASSERT_TYPE_STRUCT);
     __ASSERT_PARAM(&PRINT_LAYOUT, "PRINT_LAYOUT", ASSERT_TYPE_INT);
     __ASSERT_PARAM(file_name, "file_name", ASSERT_TYPE_PTR);
     
-    if (MAX_FILENAME_LENGTH > 1048576)
+    if (_CONTEXT(max_filename_length, MAX_FILENAME_LENGTH) > 1048576)
     {
         fprintf(stderr, "Error: MAX_FILENAME_LENGTH exceeds maximum size of 1048576 characters.\n");
         regex_data->return_code = REGEX_ERROR;
@@ -2050,7 +7287,31 @@ int regex_writefile(RegEx regex_data, int PRINT_LAYOUT, char* file_name)
             PRINT_LAYOUT != REGEX_PRINT_NONE &&
             regex_data->regex_h.reglib_status != REGLIB_ERROR)
         {
-            FILE* file_ptr = fopen(file_name, "w");
+            FILE* file_ptr = fopen(file_name, (PRINT_LAYOUT & REGEX_PRINT_BINARY) == REGEX_PRINT_BINARY ? "wb" : "w");
+
+            /* the layouts for downstream programs are written match by match */
+            if ((PRINT_LAYOUT & (REGEX_PRINT_NDJSON | REGEX_PRINT_BINARY)) != 0)
+            {
+                long num_results = _EXPORT__WRITE_RESULTS(regex_data, PRINT_LAYOUT, file_ptr, "regex_writefile");
+
+                if (file_ptr != NULL)
+                {
+                    if (num_results >= 0)
+                    {
+                        if (!((PRINT_LAYOUT & REGEX_PRINT_FILTER) == REGEX_PRINT_FILTER))
+                        {
+                            printf("\n");
+                        }
+
+                        printf("Output file:      %s\n", file_name);
+                        printf("Filesize:         %.2f KB\n", (double)(ftell(file_ptr) / 1024.0));
+                    }
+
+                    fclose(file_ptr);
+                }
+
+                return num_results >= 0;
+            }
 
             if (regex_data->regex_h.reglib_status == REGLIB_COMPILED ||
                 regex_data->regex_h.reglib_status == REGLIB_EXECUTED)
@@ -2060,10 +7321,9 @@ int regex_writefile(RegEx regex_data, int PRINT_LAYOUT, char* file_name)
                     printf("\n");
                 }
 
-                if (PRINT_COLORED == 1)
-                {
-                    PRINT_COLORED = 2;
-                }
+                /* write the output without colors */
+                previous_context = _CONTEXT__OVERRIDE(&file_context);
+                file_context.print_colored = 0;
 
                 /* full_filepath = realpath(file_name, NULL); // not ANSI or Windows compatible */
                 if ((PRINT_LAYOUT & REGEX_PRINT_JSON) == REGEX_PRINT_JSON)
@@ -2075,12 +7335,9 @@ int regex_writefile(RegEx regex_data, int PRINT_LAYOUT, char* file_name)
                     output_string = _PRINT__GET_OUTPUT_STRING(regex_data, PRINT_LAYOUT);
                 }
 
-                if (PRINT_COLORED == 2)
-                {
-                    PRINT_COLORED = 1;
-                }
+                _CONTEXT__SET(previous_context);
 
-                if (PRINT_COLORED == 1)
+                if (_CONTEXT(print_colored, PRINT_COLORED) == 1)
                 {
                     printf("\033[34mOutput file:\033[0m      %s\n", file_name);
                     printf("\033[34mFilesize:\033[0m         %.2f KB\n", (double)(strlen(output_string) / 1024.0));
@@ -2142,7 +7399,7 @@ int regex_writefile_string(char* output_string, char* file_name)
     __ASSERT_PARAM(output_string, "output_string", ASSERT_TYPE_PTR);
     __ASSERT_PARAM(file_name, "file_name", ASSERT_TYPE_PTR);
     
-    if (MAX_FILENAME_LENGTH > 1048576)
+    if (_CONTEXT(max_filename_length, MAX_FILENAME_LENGTH) > 1048576)
     {
         fprintf(stderr, "Error: MAX_FILENAME_LENGTH exceeds maximum size of 1048576 characters.\n");
     }
@@ -2164,6 +7421,398 @@ int regex_writefile_string(char* output_string, char* file_name)
     return 1;
 }
 
+/* (Internal) Writes a string with escaped carriage return and newline characters for CSV. */
+static void _EXPORT__WRITE_STRING(FILE* file_ptr, char* string, long length)
+{
+    long i;
+    long run_start = 0;
+
+    for (i = 0; i < length; i++)
+    {
+        if (string[i] == '\r' || string[i] == '\n')
+        {
+            /* write the characters before the escaped character at once */
+            fwrite(string + run_start, sizeof(char), i - run_start, file_ptr);
+            run_start = i + 1;
+
+            putc('\\', file_ptr);
+            putc((string[i] == '\r') ? 'r' : 'n', file_ptr);
+        }
+    }
+
+    fwrite(string + run_start, sizeof(char), length - run_start, file_ptr);
+}
+
+/* (Internal) Writes a JSON string with all special characters escaped. */
+static void _EXPORT__WRITE_JSON_STRING(FILE* file_ptr, char* string, long length)
+{
+    long i;
+    long run_start = 0;
+    unsigned char character;
+
+    for (i = 0; i < length; i++)
+    {
+        character = (unsigned char)string[i];
+
+        if (character == '"' || character == '\\' || character < 0x20)
+        {
+            /* write the characters before the escaped character at once */
+            fwrite(string + run_start, sizeof(char), i - run_start, file_ptr);
+            run_start = i + 1;
+
+            switch (character)
+            {
+                case '"':  fputs("\\\"", file_ptr); break;
+                case '\\': fputs("\\\\", file_ptr); break;
+                case '\n': fputs("\\n", file_ptr); break;
+                case '\r': fputs("\\r", file_ptr); break;
+                case '\t': fputs("\\t", file_ptr); break;
+                default:   fprintf(file_ptr, "\\u%04x", character); break;
+            }
+        }
+    }
+
+    fwrite(string + run_start, sizeof(char), length - run_start, file_ptr);
+}
+
+/* (Internal) Stores an unsigned number as little-endian bytes. */
+static void _EXPORT__PUT_NUMBER(unsigned char* bytes, unsigned long value, int num_bytes)
+{
+    int i;
+
+    /* shifted by 8 bits at a time, so the bytes above the width of unsigned long are 0 */
+    for (i = 0; i < num_bytes; i++)
+    {
+        bytes[i] = (unsigned char)(value & 0xFF);
+        value = value >> 8;
+    }
+}
+
+/* (Internal) Checks the parameters of an export and writes the JSON or binary header, returns 0 on errors. */
+static int _EXPORT__BEGIN(cregexport_t* export_data, RegEx regex_data, int PRINT_LAYOUT, FILE* file_ptr, char* function_name)
+{
+    unsigned char header[REGEX_BINARY_HEADER_SIZE];
+
+    export_data->file_ptr = file_ptr;
+    export_data->PRINT_LAYOUT = PRINT_LAYOUT & ~(REGEX_PRINT_FULLTEXT | REGEX_PRINT_NOTEXT | REGEX_PRINT_NOSTATS |
+                                                 REGEX_PRINT_NORESULTS | REGEX_PRINT_NOINDEX | REGEX_PRINT_FILTER);
+    export_data->print_position = !((PRINT_LAYOUT & REGEX_PRINT_NOINDEX) == REGEX_PRINT_NOINDEX);
+    export_data->text = NULL;
+    export_data->num_results = 0;
+    export_data->heap_ptr = NULL;
+    export_data->heap_size = 0;
+
+    if (regex_data == NULL || file_ptr == NULL)
+    {
+        fprintf(stderr, "%s() error: RegEx object or file is not initialized.\n", function_name);
+        return 0;
+    }
+
+    if (export_data->PRINT_LAYOUT != REGEX_PRINT_PLAIN &&
+        export_data->PRINT_LAYOUT != REGEX_PRINT_CSV &&
+        export_data->PRINT_LAYOUT != REGEX_PRINT_JSON &&
+        export_data->PRINT_LAYOUT != REGEX_PRINT_NDJSON &&
+        export_data->PRINT_LAYOUT != REGEX_PRINT_BINARY)
+    {
+        fprintf(stderr, "%s() error: Print layout is not REGEX_PRINT_PLAIN, _CSV, _JSON, _NDJSON or _BINARY.\n", function_name);
+        return 0;
+    }
+
+    if ((regex_data->regex_h.reglib_status != REGLIB_COMPILED && regex_data->regex_h.reglib_status != REGLIB_EXECUTED) ||
+        regex_data->return_code == REGEX_ERROR)
+    {
+        fprintf(stderr, "%s() error: Regular expression is not compiled.\n", function_name);
+        return 0;
+    }
+
+    /* the number of matches is written at the end */
+    if (export_data->PRINT_LAYOUT == REGEX_PRINT_JSON)
+    {
+        fprintf(file_ptr, "{\n\t\"regular expression\": \"");
+        _EXPORT__WRITE_JSON_STRING(file_ptr, regex_data->pattern, (long)strlen(regex_data->pattern));
+        fprintf(file_ptr, "\",\n\t\"sub-expressions\": %d,\n\t\"matches\": [\n", regex_data->num_pattern_subexpr);
+    }
+
+    /* the substrings are collected in a temporary file and appended after the records */
+    if (export_data->PRINT_LAYOUT == REGEX_PRINT_BINARY)
+    {
+        if ((PRINT_LAYOUT & REGEX_PRINT_NOTEXT) != REGEX_PRINT_NOTEXT &&
+            (export_data->heap_ptr = tmpfile()) == NULL)
+        {
+            fprintf(stderr, "%s() error: Temporary file of the string heap can not be created.\n", function_name);
+            return 0;
+        }
+
+        memcpy(header, "CRGX", 4);
+        _EXPORT__PUT_NUMBER(header + 4, REGEX_BINARY_VERSION, 2);
+        _EXPORT__PUT_NUMBER(header + 6, export_data->heap_ptr != NULL ? REGEX_BINARY_STRING_HEAP : 0, 2);
+        _EXPORT__PUT_NUMBER(header + 8, export_data->heap_ptr != NULL ? REGEX_BINARY_HEAP_RECORD_SIZE : REGEX_BINARY_RECORD_SIZE, 2);
+        _EXPORT__PUT_NUMBER(header + 10, (unsigned long)regex_data->num_pattern_subexpr, 2);
+        _EXPORT__PUT_NUMBER(header + 12, 0, 4);
+        fwrite(header, 1, REGEX_BINARY_HEADER_SIZE, file_ptr);
+    }
+
+    return 1;
+}
+
+/* (Internal) Writes a match in the layout of the export. */
+static void _EXPORT__WRITE_MATCH(cregexport_t* export_data, int number_match, int number_submatch, long start, long end, char* match_text)
+{
+    FILE* file_ptr = export_data->file_ptr;
+    unsigned char record[REGEX_BINARY_HEAP_RECORD_SIZE];
+
+    if (export_data->PRINT_LAYOUT == REGEX_PRINT_BINARY)
+    {
+        _EXPORT__PUT_NUMBER(record, (unsigned long)number_match, 4);
+        _EXPORT__PUT_NUMBER(record + 4, (unsigned long)number_submatch, 4);
+        _EXPORT__PUT_NUMBER(record + 8, (unsigned long)start, 8);
+        _EXPORT__PUT_NUMBER(record + 16, (unsigned long)end, 8);
+
+        if (export_data->heap_ptr != NULL)
+        {
+            _EXPORT__PUT_NUMBER(record + 24, export_data->heap_size, 8);
+            fwrite(record, 1, REGEX_BINARY_HEAP_RECORD_SIZE, file_ptr);
+            fwrite(match_text, sizeof(char), end - start, export_data->heap_ptr);
+            export_data->heap_size += (unsigned long)(end - start);
+        }
+        else
+        {
+            fwrite(record, 1, REGEX_BINARY_RECORD_SIZE, file_ptr);
+        }
+    }
+    else if (export_data->PRINT_LAYOUT == REGEX_PRINT_NDJSON)
+    {
+        fprintf(file_ptr, "{\"match-number\":%d,\"group-number\":%d,\"sub-string\":\"", number_match, number_submatch);
+        _EXPORT__WRITE_JSON_STRING(file_ptr, match_text, end - start);
+
+        if (export_data->print_position)
+        {
+            fprintf(file_ptr, "\",\"start\":%ld,\"end\":%ld}\n", start, end);
+        }
+        else
+        {
+            fputs("\"}\n", file_ptr);
+        }
+    }
+    else if (export_data->PRINT_LAYOUT == REGEX_PRINT_PLAIN)
+    {
+        fwrite(match_text, sizeof(char), end - start, file_ptr);
+        putc('\n', file_ptr);
+    }
+    else if (export_data->PRINT_LAYOUT == REGEX_PRINT_CSV)
+    {
+        if (export_data->num_results == 0)
+        {
+            fprintf(file_ptr, export_data->print_position ? "number;match;submatch;start;end;substring;\n" : "number;match;submatch;substring;\n");
+        }
+
+        if (export_data->print_position)
+        {
+            fprintf(file_ptr, "%ld;%d;%d;%ld;%ld;", export_data->num_results, number_match, number_submatch, start, end);
+        }
+        else
+        {
+            fprintf(file_ptr, "%ld;%d;%d;", export_data->num_results, number_match, number_submatch);
+        }
+
+        _EXPORT__WRITE_STRING(file_ptr, match_text, end - start);
+        fputs(";\n", file_ptr);
+    }
+    else if (export_data->PRINT_LAYOUT == REGEX_PRINT_JSON)
+    {
+        /* the separator of the previous match */
+        if (export_data->num_results > 0)
+        {
+            fprintf(file_ptr, ",\n");
+        }
+
+        fprintf(file_ptr, "\t\t{\n\t\t\t\"match-number\": %d,\n\t\t\t\"group-number\": %d,\n\t\t\t\"sub-string\": \"", number_match, number_submatch);
+        _EXPORT__WRITE_JSON_STRING(file_ptr, match_text, end - start);
+
+        if (export_data->print_position)
+        {
+            fprintf(file_ptr, "\",\n\t\t\t\"start\": %ld,\n\t\t\t\"end\": %ld\n\t\t}", start, end);
+        }
+        else
+        {
+            fprintf(file_ptr, "\"\n\t\t}");
+        }
+    }
+
+    export_data->num_results++;
+}
+
+/* (Internal) Callback function of regex_export(), stops the search on write errors. */
+static int _EXPORT__FOREACH_MATCH(int number_match, int number_submatch, int start, int end, void* userdata)
+{
+    cregexport_t* export_data = userdata;
+
+    _EXPORT__WRITE_MATCH(export_data, number_match, number_submatch, start, end, export_data->text + start);
+
+    return ferror(export_data->file_ptr) || (export_data->heap_ptr != NULL && ferror(export_data->heap_ptr));
+}
+
+/* (Internal) Callback function of regex_export_stream(), stops the search on write errors. */
+static int _EXPORT__STREAM_MATCH(int number_match, int number_submatch, long start, long end, char* match_text, void* userdata)
+{
+    cregexport_t* export_data = userdata;
+
+    _EXPORT__WRITE_MATCH(export_data, number_match, number_submatch, start, end, match_text);
+
+    return ferror(export_data->file_ptr) || (export_data->heap_ptr != NULL && ferror(export_data->heap_ptr));
+}
+
+/* (Internal) Writes the end of the export, returns the number of results or REGEX_ERROR on write errors. */
+static long _EXPORT__END(cregexport_t* export_data, long num_results, long text_length, char* function_name)
+{
+    FILE* file_ptr = export_data->file_ptr;
+    unsigned char trailer[REGEX_BINARY_TRAILER_SIZE];
+    char heap_buffer[4096];
+    size_t heap_length;
+    int heap_error = 0;
+
+    if (export_data->PRINT_LAYOUT == REGEX_PRINT_BINARY)
+    {
+        /* append the string heap and the trailer with the numbers, which are only known now */
+        if (export_data->heap_ptr != NULL)
+        {
+            heap_error = ferror(export_data->heap_ptr);
+            rewind(export_data->heap_ptr);
+
+            while ((heap_length = fread(heap_buffer, 1, sizeof(heap_buffer), export_data->heap_ptr)) > 0)
+            {
+                fwrite(heap_buffer, 1, heap_length, file_ptr);
+            }
+
+            fclose(export_data->heap_ptr);
+            export_data->heap_ptr = NULL;
+        }
+
+        _EXPORT__PUT_NUMBER(trailer, (unsigned long)export_data->num_results, 8);
+        _EXPORT__PUT_NUMBER(trailer + 8, export_data->heap_size, 8);
+        fwrite(trailer, 1, REGEX_BINARY_TRAILER_SIZE, file_ptr);
+    }
+    else if (export_data->PRINT_LAYOUT == REGEX_PRINT_NDJSON)
+    {
+        /* no output without matches */
+    }
+    else if (export_data->PRINT_LAYOUT == REGEX_PRINT_JSON)
+    {
+        fprintf(file_ptr, "%s\t],\n\t\"text-length\": %ld,\n\t\"total matches\": %ld\n}\n",
+            export_data->num_results > 0 ? "\n" : "", text_length, export_data->num_results);
+    }
+    else if (export_data->num_results == 0 && num_results >= 0)
+    {
+        fprintf(file_ptr, export_data->PRINT_LAYOUT == REGEX_PRINT_PLAIN ? "\nNo match\n" : "No match\n");
+    }
+
+    if (fflush(file_ptr) != 0 || ferror(file_ptr) || heap_error)
+    {
+        fprintf(stderr, "%s() error: File write error.\n", function_name);
+        return REGEX_ERROR;
+    }
+
+    return num_results;
+}
+
+/* (Internal) Writes the stored matches of an executed RegEx object in an export layout, returns the number of results or REGEX_ERROR. */
+static long _EXPORT__WRITE_RESULTS(RegEx regex_data, int PRINT_LAYOUT, FILE* file_ptr, char* function_name)
+{
+    int i;
+    cregexport_t export_data;
+
+    if (!_EXPORT__BEGIN(&export_data, regex_data, PRINT_LAYOUT, file_ptr, function_name))
+    {
+        return REGEX_ERROR;
+    }
+
+    for (i = 0; i < regex_data->num_matches && !ferror(file_ptr); i++)
+    {
+        _EXPORT__WRITE_MATCH(&export_data,
+            regex_data->matches[i].number_match,
+            regex_data->matches[i].number_submatch,
+            regex_data->matches[i].start,
+            regex_data->matches[i].end,
+            regex_data->matches[i].string);
+    }
+
+    return _EXPORT__END(&export_data, export_data.num_results, (long)_PRINT__TEXT_LENGTH(regex_data), function_name);
+}
+
+/* regex_export(char*, RegEx, int, FILE*) - Writes the matches of a text into a file.
+   ---------------------------------------------------------------------------------
+   Description:
+     Searches a text with regex_foreach() and writes each match and group into a file as soon as
+     it is found. The matches are not stored, so the memory use does not depend on the number of
+     matches. REGEX_PRINT_PLAIN and REGEX_PRINT_CSV write the results like regex_writefile() with
+     REGEX_PRINT_NOTEXT | REGEX_PRINT_NOSTATS. REGEX_PRINT_JSON writes the text length and the
+     number of matches after the matches. REGEX_PRINT_NDJSON writes one JSON object per line and
+     REGEX_PRINT_BINARY writes the binary records of REGEX_BINARY_VERSION, with the string heap
+     unless REGEX_PRINT_NOTEXT is set. The output is not colored.
+
+   Parameters:
+     char* input_text_string: The text input string for the regular expression
+     RegEx regex_data:        The compiled RegEx object
+     int PRINT_LAYOUT:        REGEX_PRINT_PLAIN, _CSV, _JSON, _NDJSON or _BINARY, with the option REGEX_PRINT_NOINDEX
+     FILE* file_ptr:          The output file, e.g. stdout, opened with "wb" for REGEX_PRINT_BINARY
+
+   Return Value:
+     returns:      The number of written results, REGEX_ERROR or REGEX_ERROR_MEMORY */
+long regex_export(char* input_text_string, RegEx regex_data, int PRINT_LAYOUT, FILE* file_ptr)
+{
+    cregexport_t export_data;
+    long num_results = 0;
+
+    __ASSERT_PARAM(input_text_string, "input text string", ASSERT_TYPE_PTR);
+    __ASSERT_PARAM(regex_data, "RegEx regex data", ASSERT_TYPE_STRUCT);
+
+    if (input_text_string == NULL ||
+        !_EXPORT__BEGIN(&export_data, regex_data, PRINT_LAYOUT, file_ptr, "regex_export"))
+    {
+        return REGEX_ERROR;
+    }
+
+    export_data.text = input_text_string;
+    num_results = regex_foreach(input_text_string, regex_data, _EXPORT__FOREACH_MATCH, &export_data);
+
+    return _EXPORT__END(&export_data, num_results, (long)strlen(input_text_string), "regex_export");
+}
+
+/* regex_export_stream(RegExStream, RegEx, int, FILE*) - Writes the matches of a stream into a file.
+   ------------------------------------------------------------------------------------------------
+   Description:
+     Reads a stream in chunks with regex_foreach_stream() and writes each match and group into a
+     file as soon as it is found, with the offsets from the start of the input. The memory use
+     stays at about two chunks for inputs and outputs of any length. The layouts are the same as
+     the layouts of regex_export().
+
+   Parameters:
+     RegExStream regex_stream: The stream of regex_openstream()
+     RegEx regex_data:         The compiled RegEx object
+     int PRINT_LAYOUT:         REGEX_PRINT_PLAIN, _CSV, _JSON, _NDJSON or _BINARY, with the option REGEX_PRINT_NOINDEX
+     FILE* file_ptr:           The output file, e.g. stdout, opened with "wb" for REGEX_PRINT_BINARY
+
+   Return Value:
+     returns:      The number of written results, REGEX_ERROR or REGEX_ERROR_MEMORY */
+long regex_export_stream(RegExStream regex_stream, RegEx regex_data, int PRINT_LAYOUT, FILE* file_ptr)
+{
+    cregexport_t export_data;
+    long num_results = 0;
+
+    __ASSERT_PARAM(regex_stream, "RegExStream regex stream", ASSERT_TYPE_STRUCT);
+    __ASSERT_PARAM(regex_data, "RegEx regex data", ASSERT_TYPE_STRUCT);
+
+    if (regex_stream == NULL ||
+        !_EXPORT__BEGIN(&export_data, regex_data, PRINT_LAYOUT, file_ptr, "regex_export_stream"))
+    {
+        return REGEX_ERROR;
+    }
+
+    num_results = regex_foreach_stream(regex_stream, regex_data, _EXPORT__STREAM_MATCH, &export_data);
+
+    return _EXPORT__END(&export_data, num_results, regex_stream->offset + regex_stream->buffer_length, "regex_export_stream");
+}
+
 /* void regex_print(RegEx): Prints the contents of a RegEx Object.
    ---------------------------------------------------------------
    Description:
@@ -2180,6 +7829,8 @@ int regex_writefile_string(char* output_string, char* file_name)
                    REGEX_PRINT_PLAIN      - only the result contents
                    REGEX_PRINT_CSV        - list with comma seperated values
                    REGEX_PRINT_JSON       - JavaScript Object Notation
+                   REGEX_PRINT_NDJSON     - one JSON object per result and line
+                   REGEX_PRINT_BINARY     - binary records, see REGEX_BINARY_VERSION
 
    Note:
      The variable RX_PRINT_TABLE determines the print style table or list. */
@@ -2194,7 +7845,11 @@ void regex_print(RegEx regex_data, int PRINT_LAYOUT)
         PRINT_LAYOUT != REGEX_PRINT_NONE &&
         regex_data->regex_h.reglib_status != REGLIB_ERROR)
     {
-        if (regex_data->regex_h.reglib_status == REGLIB_COMPILED ||
+        if ((PRINT_LAYOUT & (REGEX_PRINT_NDJSON | REGEX_PRINT_BINARY)) != 0)
+        {
+            _EXPORT__WRITE_RESULTS(regex_data, PRINT_LAYOUT, stdout, "regex_print");
+        }
+        else if (regex_data->regex_h.reglib_status == REGLIB_COMPILED ||
             regex_data->regex_h.reglib_status == REGLIB_EXECUTED)
         {
             output_string = _PRINT__GET_OUTPUT_STRING(regex_data, PRINT_LAYOUT);
@@ -32,21 +32,104 @@ extern "C" {
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <ctype.h>
 #include <regex.h>
 
+/* Compile with -pthread (defines _REENTRANT) to lock the compiled-pattern cache for threads
+   and to enable the parallel search of REG_PARALLEL */
+#ifdef _REENTRANT
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+/* Thread-local storage is no part of C89: the context of a thread is stored with _Thread_local of C11,
+   with the __thread extension of GCC/Clang, with a pthread key (-pthread) or in one static variable */
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_THREADS__)
+#define REGEX_THREAD_LOCAL _Thread_local
+#elif defined(__GNUC__)
+#define REGEX_THREAD_LOCAL __thread
+#elif defined(_REENTRANT)
+#define REGEX_CONTEXT_KEY 1
+#else
+#define REGEX_THREAD_LOCAL
+#endif
+
+/* The parallel search needs the REG_STARTEND extension of the GNU regex library */
+#if defined(_REENTRANT) && defined(REG_STARTEND)
+#define REGEX_PARALLEL_SEARCH 1
+#endif
+
+/* Memory-mapped files of regex_mapfile() need mmap() and the REG_STARTEND extension,
+   because the mapped file content has no terminating NUL byte */
+#if defined(__unix__) && defined(REG_STARTEND)
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define REGEX_FILE_MAPPING 1
+#endif
+
+/* The recursive search of regex_search_tree() needs the POSIX directory functions */
+#if defined(__unix__)
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define REGEX_TREE_SEARCH 1
+#endif
+
+/* The files of regex_search_tree() are read ahead by a thread with posix_fadvise() */
+#if defined(REGEX_TREE_SEARCH) && defined(_REENTRANT) && defined(POSIX_FADV_WILLNEED)
+#define REGEX_TREE_PREFETCH 1
+#endif
+
 /* Memory limiters */
 unsigned int MAX_TEXT_LENGTH = 8192;
 unsigned int MAX_PATTERN_LENGTH = 1024;
-unsigned int MAX_NUM_MATCHES = 1024;
+unsigned int MAX_NUM_MATCHES = 0;         /* optional limit of the number of matches, 0 = no limit */
 unsigned int MAX_PRINT_TEXT_LENGTH = 512;
 unsigned int MAX_FILENAME_LENGTH = 512;
 
+/* Number of threads of the parallel search, 0 = number of processors */
+unsigned int NUM_THREADS = 0;
+
+/* Minimum length of the text chunks of the parallel search */
+#define REGEX_PARALLEL_MIN_CHUNK_LENGTH (1 << 16)
+
+/* Number of records a thread of regex_match_batch() takes at once from its range */
+#define REGEX_BATCH_BLOCK_SIZE 64
+
+/* Size of the first memory block and alignment of the allocations of the result arenas */
+#define REGEX_ARENA_BLOCK_SIZE 4096
+#define REGEX_ARENA_ALIGNMENT 16
+
+/* Number of bytes a RegExStream reads at once */
+#define REGEX_STREAM_CHUNK_SIZE (1 << 16)
+
+/* Number of bytes of a line without a newline character after which a RegExStream searches it in parts */
+#define REGEX_STREAM_MAX_LINE_LENGTH (1 << 24)
+
+/* Options of regex_search_tree() */
+#define REGEX_TREE_DEFAULT 0
+#define REGEX_TREE_HIDDEN (1 << 0)  /* also search hidden files and directories */
+#define REGEX_TREE_BINARY (1 << 1)  /* also search files with NUL bytes in the first chunk */
+
+/* Number of files and bytes per file which are read ahead of the threads of regex_search_tree() */
+#define REGEX_TREE_PREFETCH_DEPTH 32
+#define REGEX_TREE_PREFETCH_LENGTH (1 << 20)
+
 /* Extended option flags */
 #define REG_DEFAULT 0
 #define REG_GLOBAL (1 << 4)
 #define REG_MULTILINE (1 << 5)
 #define REG_NOSUBEXP (1 << 6)
 #define REG_SUBEXP (1 << 7)
+#define REG_PARALLEL (1 << 8)
+#define REG_NOCOPY (1 << 9)
+#define REG_PIKEVM (1 << 10)
+#define REG_LAZYDFA (1 << 11)
 
 int DEFAULT_REG_FLAGS[7] = {
     REG_GLOBAL,
@@ -64,6 +147,10 @@ typedef struct t_substruct__flags {
     int NOSUB;           /* note: REG_NOSUB is deactivated in the program */
     int NOSUBEXP;
     int SUBEXP;
+    int PARALLEL;
+    int NOCOPY;
+    int PIKEVM;
+    int LAZYDFA;
 } cregflags_t;
 
 /* RegEx-subobject for result data of the regular expression matches */
@@ -72,6 +159,7 @@ typedef struct t_substruct__match_offsets {
     int number_submatch; /* number of the group or submatch */
     int start;           /* byte offset from string's start to substring's start. */
     int end;             /* byte offset from string's start to substring's end. */
+    int length;          /* length of the substring (end - start) */
     char* string;        /* string of the sub-expression match */
 } cregmatches_t;
 
@@ -81,6 +169,7 @@ typedef struct t_substruct__file {
     char* content;       /* file content */
     int status;          /* status of fread */
     int length;          /* file-length */
+    int mapped;          /* content is a read-only memory mapping of regex_mapfile() */
 } cregfile_t;
 
 /* regex.h processing status flags */
@@ -90,16 +179,276 @@ typedef struct t_substruct__file {
 #define REGLIB_CLOSED 3
 #define REGLIB_ERROR 4
 
+/* Instructions of the Pike VM programs of REG_PIKEVM, the first four consume a character or end a match */
+#define REGEX_PIKE_CHAR 0                /* character arg */
+#define REGEX_PIKE_ANY 1                 /* "." without NUL, and without newline with REG_NEWLINE */
+#define REGEX_PIKE_CLASS 2               /* character of the bracket expression arg */
+#define REGEX_PIKE_MATCH 3               /* end of a match */
+#define REGEX_PIKE_JUMP 4                /* continue at instruction arg */
+#define REGEX_PIKE_SPLIT 5               /* continue at instruction arg, with lower priority at instruction arg2 */
+#define REGEX_PIKE_SAVE 6                /* store the position in capture slot arg */
+#define REGEX_PIKE_LINE_START 7          /* "^" */
+#define REGEX_PIKE_LINE_END 8            /* "$" */
+#define REGEX_PIKE_WORD_BOUNDARY 9       /* "\b" */
+#define REGEX_PIKE_NOT_WORD_BOUNDARY 10  /* "\B" */
+#define REGEX_PIKE_WORD_START 11         /* "\<" */
+#define REGEX_PIKE_WORD_END 12           /* "\>" */
+#define REGEX_PIKE_BUFFER_START 13       /* "\`" */
+#define REGEX_PIKE_BUFFER_END 14         /* "\'" */
+
+/* Syntax tree nodes of a pattern for the Pike VM compiler */
+#define REGEX_PIKE_NODE_EMPTY 0          /* empty expression */
+#define REGEX_PIKE_NODE_INSTRUCTION 1    /* one instruction */
+#define REGEX_PIKE_NODE_SEQUENCE 2       /* concatenation of the child list */
+#define REGEX_PIKE_NODE_ALTERNATION 3    /* alternatives of the child list */
+#define REGEX_PIKE_NODE_REPEAT 4         /* repetition of the child */
+#define REGEX_PIKE_NODE_GROUP 5          /* sub-expression of the child */
+
+/* Maximum number of instructions of a Pike VM program, larger patterns are searched by regexec() */
+#define REGEX_PIKE_MAX_INSTRUCTIONS (1 << 16)
+
+/* Largest count of a repetition interval, regex.h declares RE_DUP_MAX only with the GNU extensions */
+#ifndef RE_DUP_MAX
+#define RE_DUP_MAX 0x7fff
+#endif
+
+/* Number of bytes of a bracket expression of a Pike VM program, one bit per character */
+#define REGEX_PIKE_CLASS_SIZE 32
+
+/* Instruction of a Pike VM program */
+typedef struct t_substruct__pike_instruction {
+    int opcode;                /* REGEX_PIKE_* */
+    int arg;                   /* character, bracket expression, target or capture slot */
+    int arg2;                  /* lower priority target of REGEX_PIKE_SPLIT */
+} cregpike_instruction_t;
+
+/* Compiled pattern of REG_PIKEVM, executed in O(pattern length * text length) time */
+typedef struct t_substruct__pike_program {
+    cregpike_instruction_t* instructions;
+    int num_instructions;
+    int instruction_capacity;  /* allocated number of instructions */
+    unsigned char* classes;    /* bracket expressions of REGEX_PIKE_CLASS_SIZE bytes */
+    int num_classes;
+    int num_captures;          /* 2 slots for the match and for each sub-expression */
+    int newline;               /* REG_NEWLINE set */
+    int single_line;           /* REG_NEWLINE set and no instruction takes a newline character */
+    unsigned char byte_classes[256]; /* class of each byte, the bytes of a class are not distinguished by the program */
+    int num_byte_classes;
+    struct t_substruct__pike_program* reverse; /* program of the reversed pattern of a single_line program, or NULL */
+    int reversed;              /* reversed pattern, which reads a text backwards */
+    unsigned long serial;      /* number of the compiled program, tells the lazy DFAs of a results object apart */
+} cregpike_t;
+
+/* Syntax tree node of a pattern */
+typedef struct t_substruct__pike_node {
+    int type;                  /* REGEX_PIKE_NODE_* */
+    int opcode;                /* instruction of REGEX_PIKE_NODE_INSTRUCTION */
+    int arg;                   /* argument of the instruction, or number of the sub-expression */
+    int min;                   /* minimum number of repetitions */
+    int max;                   /* maximum number of repetitions, -1 = no limit */
+    int child;                 /* first child node, or -1 */
+    int next;                  /* next node of the parent list, or -1 */
+} cregpike_node_t;
+
+/* Parser of a converted pattern for the Pike VM compiler */
+typedef struct t_substruct__pike_parser {
+    char* pattern;             /* converted extended regular expression */
+    int position;              /* read position in pattern */
+    int depth;                 /* number of open parentheses */
+    int num_groups;            /* number of sub-expressions */
+    int icase;                 /* REG_ICASE set */
+    int failed;                /* pattern not supported by the Pike VM, or no memory */
+    int reverse;               /* emit the pattern reversed for the reverse DFA */
+    cregpike_node_t* nodes;
+    int num_nodes;
+    int max_nodes;
+    cregpike_t* program;       /* program of the bracket expressions and the instructions */
+} cregpike_parser_t;
+
+/* Thread list of a Pike VM step, a sparse set of instructions in priority order */
+typedef struct t_substruct__pike_list {
+    int* dense;                /* keys of the threads in priority order, the instruction or after a "$" the instruction + num_instructions */
+    int* sparse;               /* index of a key in dense */
+    int* captures;             /* capture slots of the threads of the instructions with a character or a match */
+    int num_threads;
+} cregpike_list_t;
+
+/* Memory of the Pike VM executions of a search, allocated with the first execution */
+typedef struct t_substruct__pike_workspace {
+    int* memory;               /* one allocation of all arrays, or NULL */
+    cregpike_list_t lists[2];  /* threads of the current and of the next position */
+    int* stack;                /* instructions and saved capture slots of a thread */
+    int* seed;                 /* capture slots of a new thread */
+    int* best;                 /* capture slots of the leftmost-longest match */
+} cregpike_workspace_t;
+
+/* Memory of the states and transitions of a lazy DFA of REG_LAZYDFA, all states are flushed when it is full */
+#ifndef REGEX_DFA_CACHE_SIZE
+#define REGEX_DFA_CACHE_SIZE (2 * 1024 * 1024)
+#endif
+
+/* Minimum number of searched bytes per state between two flushes, a DFA with fewer bytes gives up */
+#define REGEX_DFA_MIN_BYTES_PER_STATE 10
+
+/* Texts shorter than this number of bytes are searched without a lazy DFA which has no states yet */
+#ifndef REGEX_DFA_MIN_TEXT_LENGTH
+#define REGEX_DFA_MIN_TEXT_LENGTH 256
+#endif
+
+/* Minimum number of scanned bytes per match of a global search with the lazy DFAs, denser matches are searched by the exact search */
+#ifndef REGEX_DFA_MIN_BYTES_PER_MATCH
+#define REGEX_DFA_MIN_BYTES_PER_MATCH 32
+#endif
+
+/* Number of matches of the lazy DFAs before their bytes per match are checked */
+#define REGEX_DFA_MIN_MATCHES 64
+
+/* Transitions of a DFA state besides the row of the next state */
+#define REGEX_DFA_UNKNOWN -1             /* not built yet */
+#define REGEX_DFA_DEAD -2                /* no thread left in an anchored DFA */
+#define REGEX_DFA_MATCH_ROW(row) (-4 - (row)) /* a match ends before the character, then the row of the next state */
+
+/* Results of a DFA search besides the end offset of a match */
+#define REGEX_DFA_NOMATCH -1
+#define REGEX_DFA_FAILED -3              /* given up, searched by the Pike VM or regexec(), also a result of a transition */
+
+/* Context of the character before a DFA state for the anchors and word boundaries */
+#define REGEX_DFA_CONTEXT_BEGIN (1 << 0)       /* text start without REG_NOTBOL */
+#define REGEX_DFA_CONTEXT_TEXT_START (1 << 1)  /* text start */
+#define REGEX_DFA_CONTEXT_NEWLINE (1 << 2)     /* after a newline character */
+#define REGEX_DFA_CONTEXT_WORD (1 << 3)        /* after a word character */
+#define REGEX_DFA_CONTEXT_START (1 << 4)       /* start state of an anchored DFA, the only state with a new thread */
+
+/* State of a lazy DFA, the instructions of a Pike VM program which continue after a character */
+typedef struct t_substruct__dfa_state {
+    int first_element;         /* index of the first instruction in the elements of the DFA */
+    int num_elements;          /* number of instructions */
+    int context;               /* REGEX_DFA_CONTEXT_* of the character */
+    unsigned long hash;        /* hash of the instructions and the context */
+    int next;                  /* next state of the hash bucket, or -1 */
+} cregdfa_state_t;
+
+/* Lazy DFA of a search, the states and transitions are built from the Pike VM program when the text needs them */
+typedef struct t_substruct__dfa {
+    cregpike_t* program;       /* Pike VM program of REG_LAZYDFA, or NULL */
+    int failed;                /* given up after flushing too often or without memory */
+    int anchored;              /* a new thread starts only at the start position */
+    int context_mask;          /* REGEX_DFA_CONTEXT_* flags read by the instructions of the program */
+    int num_columns;           /* number of byte classes */
+    cregdfa_state_t* states;
+    int num_states;
+    int state_capacity;        /* allocated number of states */
+    int max_states;            /* number of states of REGEX_DFA_CACHE_SIZE */
+    int* transitions;          /* num_columns per state: row of the next state, REGEX_DFA_UNKNOWN, REGEX_DFA_DEAD or REGEX_DFA_MATCH_ROW() */
+    int* elements;             /* instructions of the states */
+    int num_elements;
+    int element_capacity;      /* allocated number of instructions */
+    int max_elements;          /* number of instructions of REGEX_DFA_CACHE_SIZE */
+    int* buckets;              /* first state of each hash bucket, or -1, two buckets per allocated state */
+    int* work;                 /* sparse set and stack of a closure, the next instructions of a transition */
+    int num_keys;              /* keys of the sparse set of the last closure */
+    int flush_position;        /* number of searched bytes at the last flush, negative for the states of the previous searches */
+    int match_row;             /* row of the state of the last match end of _DFA__SEARCH() */
+    unsigned char class_bytes[256]; /* first byte of each byte class */
+} cregdfa_t;
+
+/* Lazy DFAs of a RegEx object, a results object or a thread, the states are kept from one search to the next */
+typedef struct t_substruct__dfa_set {
+    unsigned long serial;      /* serial number of the program of the DFAs, 0 = not built yet */
+    cregdfa_t dfa;             /* lazy DFA of REG_LAZYDFA */
+    cregdfa_t reverse_dfa;     /* DFA of the reversed pattern for the start of a match */
+    cregdfa_t anchored_dfa;    /* anchored DFA for the end of a match */
+} cregdfa_set_t;
+
+/* Entry of the compiled-pattern cache for regex_match() and regex_replace() */
+typedef struct t_substruct__cache_entry {
+    char* pattern;                         /* copy of the regular expression string pattern */
+    int reglib_flags;                      /* option flags value */
+    unsigned long hash;                    /* hash of pattern and option flags */
+    unsigned int references;               /* number of RegEx objects using the compiled regular expression */
+    int evicted;                           /* removed from the cache, freed by the last reference */
+    int num_pattern_subexpr;               /* number of corresponding sub-expressions */
+    regex_t compiled_regex;                /* compiled regular expression */
+    cregpike_t* program;                   /* Pike VM program of REG_PIKEVM and REG_LAZYDFA, or NULL */
+    int program_compiled;                  /* compiled with REG_PIKEVM or REG_LAZYDFA, the program is NULL for unsupported patterns */
+    struct t_substruct__cache_entry* prev; /* more recently used entry */
+    struct t_substruct__cache_entry* next; /* less recently used entry */
+} cregcache_entry_t;
+
+/* Status of the compiled-pattern cache */
+typedef struct t_substruct__cache_stats {
+    unsigned int capacity;     /* maximum number of cached patterns, 0 = disabled */
+    unsigned int size;         /* number of cached patterns */
+    unsigned long hits;        /* number of compilations served from the cache */
+    unsigned long misses;      /* number of compilations with regcomp() */
+} cregcache_stats_t;
+
+/* Memory block of a result arena, the allocations follow the block header */
+typedef struct t_substruct__arena_block {
+    struct t_substruct__arena_block* previous; /* previous, smaller block */
+    size_t size;                           /* number of bytes for allocations */
+    size_t used;                           /* number of allocated bytes */
+} cregarena_block_t;
+
+/* Bump allocator for the matches of an execution, freed at once */
+typedef struct t_substruct__arena {
+    cregarena_block_t* block;  /* current block, linked to the previous blocks */
+    void* last_allocation;     /* last allocation, which can grow in place */
+} cregarena_t;
+
+/* Output string of the print functions, which grows at the end */
+typedef struct t_substruct__string {
+    char* data;                /* NUL-terminated string */
+    size_t length;             /* length of the string without the NUL */
+    size_t capacity;           /* allocated size of data */
+} cregstring_t;
+
+/* Output of regex_export() and regex_export_stream(), written match by match */
+typedef struct t_substruct__export {
+    FILE* file_ptr;            /* output file */
+    int PRINT_LAYOUT;          /* REGEX_PRINT_PLAIN, _CSV, _JSON, _NDJSON or _BINARY */
+    int print_position;        /* 0 with REGEX_PRINT_NOINDEX */
+    char* text;                /* input text of regex_export() */
+    long num_results;          /* number of written results */
+    FILE* heap_ptr;            /* temporary file of the string heap of REGEX_PRINT_BINARY, or NULL */
+    unsigned long heap_size;   /* number of bytes in the string heap */
+} cregexport_t;
+
+/* Binary result format of REGEX_PRINT_BINARY, all numbers are little-endian:
+   header of REGEX_BINARY_HEADER_SIZE bytes:
+     "CRGX", uint16 version, uint16 flags (REGEX_BINARY_STRING_HEAP), uint16 record size,
+     uint16 number of sub-expressions, uint32 reserved
+   records of the record size in bytes:
+     uint32 match number, uint32 group number, uint64 start, uint64 end,
+     with REGEX_BINARY_STRING_HEAP: uint64 offset of the substring in the string heap
+   string heap: the substrings of the records without separators, the length of a substring is end - start
+   trailer of REGEX_BINARY_TRAILER_SIZE bytes:
+     uint64 number of records, uint64 size of the string heap */
+#define REGEX_BINARY_VERSION 1
+#define REGEX_BINARY_STRING_HEAP (1 << 0)
+#define REGEX_BINARY_HEADER_SIZE 16
+#define REGEX_BINARY_RECORD_SIZE 24
+#define REGEX_BINARY_HEAP_RECORD_SIZE 32
+#define REGEX_BINARY_TRAILER_SIZE 16
+
 /* RegEx-subobject for internal regex.h references */
 typedef struct t_substruct__regex_h_ref {
     int reglib_status;         /* status of regex.h memory */
     int reglib_flags;          /* option flags value */
     regex_t compiled_regex;    /* pointer to compiled regular expression */
+    cregpike_t* program;       /* Pike VM program of REG_PIKEVM and REG_LAZYDFA, or NULL */
     regmatch_t* match_offsets; /* array of offsets matching the corresponding sub-expressions in preg. */
+    char* match_strings;       /* buffer holding the strings of all matches */
+    int match_capacity;        /* allocated number of elements of match_offsets and matches */
+    cregcache_entry_t* cache_entry; /* cache entry owning compiled_regex, or NULL */
+    cregarena_t arena;         /* memory of match_offsets, matches and match_strings */
+    char* text_buffer;         /* allocated copy of the input text, text points to the input text with REG_NOCOPY */
+    cregdfa_set_t dfas;        /* lazy DFAs of REG_LAZYDFA, kept for the next execution */
 } regex_h_ref;
 
 /* Status flags for regex_compile and regex_exec */
 #define REGEX_ERROR -1
+#define REGEX_ERROR_MEMORY -2
 #define REGEX_INIT_SUCCESS 5
 #define REGEX_COMP_SUCCESS 0
 #define REGEX_MATCH_SUCCESS 0
@@ -114,6 +463,8 @@ typedef struct t_struct__compact_regex {
     int num_pattern_subexpr;    /* number of corresponding sub-expressions */
     int return_code;            /* return code of the expression string compilation */
     char* text;                 /* the regular expression input text string */
+    int text_length;            /* length of the input text string */
+    int text_capacity;          /* allocated size of regex_h.text_buffer */
     char* pattern;              /* the regular expression string pattern */
     char error_message[128];    /* error message buffer */
     regex_h_ref regex_h;        /* reference to internal regex.h-variables */
@@ -122,6 +473,206 @@ typedef struct t_struct__compact_regex {
 typedef compact_regex_t* RegEx;
 typedef cregfile_t* RegExFile;
 
+/* Result data of regex_exec_r(), kept outside of the shared compiled RegEx object */
+typedef struct t_struct__results {
+    cregmatches_t* matches;     /* array with the match start and end string positions and the substring */
+    int num_matches;            /* number of matches */
+    int return_code;            /* return code of the execution */
+    regmatch_t* match_offsets;  /* array of offsets matching the corresponding sub-expressions */
+    char* match_strings;        /* buffer holding the strings of all matches */
+    int match_capacity;         /* allocated number of elements of match_offsets and matches */
+    cregarena_t arena;          /* memory of match_offsets, matches and match_strings */
+    cregdfa_set_t dfas;         /* lazy DFAs of REG_LAZYDFA, kept for the next execution */
+} cregresults_t;
+
+/* Memory limiters, default option flags and print options of a thread */
+typedef struct t_struct__context {
+    unsigned int max_text_length;
+    unsigned int max_pattern_length;
+    unsigned int max_num_matches;         /* optional limit of the number of matches, 0 = no limit */
+    unsigned int max_print_text_length;
+    unsigned int max_filename_length;
+    int default_reg_flags[7];
+    unsigned int print_colored;
+    unsigned int num_threads;             /* number of threads of the parallel search, 0 = number of processors */
+} cregcontext_t;
+
+typedef cregresults_t* RegExResults;
+typedef cregcontext_t* RegExContext;
+
+/* Text chunk of the parallel search, which ends at a newline character or at the text end */
+typedef struct t_substruct__chunk {
+    int start;                 /* byte offset of the chunk start in the input text */
+    int end;                   /* byte offset of the newline character or the text end */
+    int number_match;          /* number of matches found in the chunk */
+    int halted;                /* search stopped by an empty match */
+    cregresults_t results;     /* matches of the chunk, numbered from 1 */
+} cregchunk_t;
+
+/* Shared data of the threads of the parallel search */
+typedef struct t_substruct__parallel {
+    RegEx regex;               /* compiled RegEx object, not changed by the threads */
+    char* converted_pattern;   /* pattern of the regex.h copies of the additional threads, NULL for the Pike VM */
+    char* text;                /* input text string */
+    int text_length;           /* length of the input text string */
+    cregchunk_t* chunks;       /* text chunks in offset order */
+    int num_chunks;            /* number of text chunks */
+    int next_chunk;            /* index of the next chunk to search */
+    cregcontext_t context;     /* limits and options of the calling thread */
+#ifdef _REENTRANT
+    pthread_mutex_t mutex;     /* lock of next_chunk */
+#endif
+} cregparallel_t;
+
+/* Number of match slots of a cursor without allocated buffers */
+#define REGEX_CURSOR_SLOTS 10
+
+/* Read position and offsets of a match-by-match search */
+typedef struct t_substruct__cursor {
+    regex_t* compiled_regex;   /* compiled regular expression of the RegEx object */
+    cregpike_t* program;       /* Pike VM program of the RegEx object, or NULL */
+    cregpike_workspace_t workspace; /* memory of the Pike VM */
+    cregdfa_set_t* dfas;       /* lazy DFAs of REG_LAZYDFA, own_dfas or the DFAs of the caller */
+    cregdfa_set_t own_dfas;    /* lazy DFAs of a cursor without DFAs of the caller, freed with the cursor */
+    char* text;                /* input text string, not copied */
+    int text_length;           /* length of the input text string */
+    int read_position;         /* byte offset of the next search */
+    int number_match;          /* number of the last match */
+    int newline;               /* REG_NEWLINE set */
+    int finished;              /* no further match possible */
+    size_t num_match_slots;    /* number of elements of match_offsets and submatch_numbers */
+    regmatch_t* match_offsets; /* offsets of the last match and its sub-expressions */
+    int* submatch_numbers;     /* group numbers of match_offsets, -1 if not a valid result */
+    int eflags;                /* REG_NOTBOL and REG_NOTEOL for a part of a text */
+    int dfa_matches;           /* number of matches found by the lazy DFAs */
+    int dfa_bytes;             /* number of bytes scanned by the lazy DFAs up to these matches */
+    regmatch_t fixed_offsets[REGEX_CURSOR_SLOTS]; /* match_offsets of patterns with few sub-expressions */
+    int fixed_numbers[REGEX_CURSOR_SLOTS];        /* submatch_numbers of patterns with few sub-expressions */
+} cregcursor_t;
+
+/* Callback function of regex_foreach(), returns 0 to continue or another value to stop the search */
+typedef int (*regex_callback_t)(int number_match, int number_submatch, int start, int end, void* userdata);
+
+/* Input of regex_foreach_stream(), read in chunks with the unfinished last line carried over */
+typedef struct t_substruct__stream {
+    FILE* ptr;                 /* file or stdin */
+    char* name;                /* filename string, "-" for stdin */
+    char* buffer;              /* carried last line with the character before it, and the next chunk */
+    int buffer_size;           /* allocated size of the buffer */
+    int buffer_length;         /* number of bytes in the buffer */
+    int chunk_size;            /* number of bytes read at once, REGEX_STREAM_CHUNK_SIZE */
+    int max_line_length;       /* number of bytes after which a line is searched in parts, REGEX_STREAM_MAX_LINE_LENGTH */
+    long offset;               /* absolute offset of the buffer start in the input */
+    int status;                /* 1 if the input is open, 2 if it is read to its end */
+} cregstream_t;
+
+typedef cregstream_t* RegExStream;
+
+/* Callback function of regex_foreach_stream() with absolute offsets, match_text points to the match
+   in the chunk buffer and is only valid during the call, returns 0 to continue or another value to stop */
+typedef int (*regex_stream_callback_t)(int number_match, int number_submatch, long start, long end, char* match_text, void* userdata);
+
+#ifdef REGEX_TREE_SEARCH
+/* Match in a file of regex_search_tree() */
+typedef struct t_substruct__tree_match {
+    int number_match;          /* number of the match */
+    int number_submatch;       /* number of the group or submatch */
+    long start;                /* offset from the start of the file to the start of the match */
+    long end;                  /* offset from the start of the file to the end of the match */
+} cregtree_match_t;
+
+/* Callback function of regex_search_tree(), called once for each file with matches,
+   returns 0 to continue or another value to stop the search */
+typedef int (*regex_tree_callback_t)(char* file_name, cregtree_match_t* matches, int num_matches, void* userdata);
+
+/* Directory on the path of the recursive search, to skip cycles of symbolic links */
+typedef struct t_substruct__tree_directory {
+    struct t_substruct__tree_directory* parent;
+    dev_t device;
+    ino_t inode;
+} cregtree_directory_t;
+
+/* Matches of one file of regex_search_tree() */
+typedef struct t_substruct__tree_file {
+    cregtree_match_t* matches; /* matches in offset order */
+    int num_matches;           /* number of matches */
+    int match_capacity;        /* allocated number of elements of matches */
+    int memory_error;          /* the matches could not be stored */
+} cregtree_file_t;
+
+/* Shared data of the threads of regex_search_tree() */
+typedef struct t_substruct__tree {
+    RegEx regex;               /* compiled RegEx object, not changed by the threads */
+    char* converted_pattern;   /* converted pattern for the compiled copies of the threads */
+    char** file_names;         /* paths of the files to search */
+    int num_files;             /* number of files */
+    int file_capacity;         /* allocated number of elements of file_names */
+    int next_file;             /* index of the next file to search */
+    int walking;               /* the calling thread still adds the files of the directory walk */
+    int options;               /* REGEX_TREE_ options */
+    regex_tree_callback_t callback;
+    void* userdata;
+    int stopped;               /* the callback or a memory error stopped the search */
+    int memory_error;          /* a file name or the matches of a file could not be stored */
+    long num_results;          /* number of matches of all delivered files */
+    cregcontext_t context;     /* limits and options of the calling thread */
+    int prefetch_next;         /* index of the next file to read ahead */
+#ifdef _REENTRANT
+    pthread_mutex_t mutex;     /* lock of the file names, next_file, prefetch_next, the callback and num_results */
+    pthread_cond_t file_cond;  /* wakes the searching threads when a file is added or the search ends */
+    pthread_cond_t prefetch_cond; /* wakes the prefetch thread when a file is added or taken */
+#endif
+} cregtree_t;
+#endif
+
+/* Result of a text of regex_match_batch() */
+typedef struct t_substruct__batch_result {
+    int return_code;           /* REGEX_MATCH_SUCCESS if the text matches, REG_NOMATCH, REGEX_ERROR or REGEX_ERROR_MEMORY */
+    int num_matches;           /* number of matches, more than one only with REG_GLOBAL */
+    int start;                 /* byte offset of the first match start, -1 without match */
+    int end;                   /* byte offset of the first match end, -1 without match */
+} cregbatch_result_t;
+
+/* Range of texts of a thread of regex_match_batch(), other threads steal from its end */
+typedef struct t_substruct__batch_worker {
+    size_t next;               /* index of the next text */
+    size_t end;                /* index after the last text */
+    int index;                 /* number of the thread */
+    struct t_substruct__batch* batch;
+#ifdef _REENTRANT
+    pthread_mutex_t mutex;     /* lock of next and end */
+#endif
+} cregbatch_worker_t;
+
+/* Shared data of the threads of regex_match_batch() */
+typedef struct t_substruct__batch {
+    RegEx regex;               /* compiled RegEx object, not changed by the threads */
+    char* converted_pattern;   /* pattern of the regex.h copies of the additional threads */
+    const char** texts;        /* input text strings */
+    cregbatch_result_t* results;
+    cregbatch_worker_t* workers;
+    int num_threads;
+} cregbatch_t;
+
+/* Allocation functions of regex_set_allocator(), userdata is the pointer given to regex_set_allocator() */
+typedef void* (*regex_malloc_t)(size_t size, void* userdata);
+typedef void* (*regex_realloc_t)(void* ptr, size_t size, void* userdata);
+typedef void (*regex_free_t)(void* ptr, void* userdata);
+
+/* Allocator of the library memory, NULL functions = malloc(), realloc() and free() */
+typedef struct t_substruct__allocator {
+    regex_malloc_t malloc_function;
+    regex_realloc_t realloc_function;
+    regex_free_t free_function;
+    void* userdata;
+} cregallocator_t;
+
+/* (Internal) Memory allocation with the installed allocator, returns NULL on failure */
+static void* __TRY_MALLOC(size_t MEM_SIZE);
+
+/* (Internal) Memory re-allocation with the installed allocator, returns NULL on failure */
+static void* __TRY_REALLOC(void* ptr, size_t MEM_SIZE);
+
 /* (Internal) Memory allocation */
 static void* __MALLOC(size_t MEM_SIZE);
 
@@ -131,6 +682,21 @@ static void *__REALLOC(void* ptr, size_t MEM_SIZE);
 /* (Internal) Memory de-allocation */
 static void __FREE(void* ptr);
 
+/* (Internal) Initializes an empty arena. */
+static void _ARENA__INIT(cregarena_t* arena);
+
+/* (Internal) Allocates memory from the current block of an arena or from a new block, returns NULL on failure. */
+static void* _ARENA__ALLOC(cregarena_t* arena, size_t MEM_SIZE);
+
+/* (Internal) Re-allocates arena memory, the last allocation grows in place. */
+static void* _ARENA__REALLOC(cregarena_t* arena, void* ptr, size_t OLD_SIZE, size_t MEM_SIZE);
+
+/* (Internal) Marks all arena memory as unused and keeps one block of the total size for the next execution. */
+static void _ARENA__RESET(cregarena_t* arena);
+
+/* (Internal) Frees all blocks of an arena. */
+static void _ARENA__FREE(cregarena_t* arena);
+
 #define ASSERT_TYPE_PTR 0
 #define ASSERT_TYPE_INT 1
 #define ASSERT_TYPE_STRUCT 2
@@ -146,28 +712,294 @@ static void __ASSERT_PARAM(void* parameter, char* name, int TYPE);
 /* (Internal) Replaces the character class with a compatible substring. */
 static char* __SUBSTITUTE_STRING(char* input_text_string, char* search_substring, char* replace_substring, int SET_BRACKETS, int GLOBAL, int start_position);
 
-/* (Internal) Converts the character classes in the regular expression. */
+/* (Internal) Converts the character classes in the regular expression, returns NULL without memory. */
 static char* _COMPILE__CONVERT_SEQUENCES(char* regex_pattern_string);
 
-/* (Internal) Initializes a RegEx object. */
+/* (Internal) Initializes a RegEx object, returns NULL without memory. */
 static RegEx _COMPILE__INIT_REGEX(char* regex_pattern_string, int OPTION_FLAGS);
 
-/* (Internal) Copies the strings from regex_h of regexec into RegEx-subobject. */
-static void _EXEC__GET_MATCHED_STRINGS(char* input_text_string, RegEx regex);
+/* (Internal) Frees a RegEx object whose compilation failed without memory and returns NULL, otherwise the RegEx object. */
+static RegEx _COMPILE__CHECK_MEMORY(RegEx regex_data);
+
+/* (Internal) Compiles the regular expression pattern of an initialized RegEx object. */
+static void _COMPILE__REGEX(RegEx regex_data, char* regex_pattern_string);
+
+/* (Internal) Hashes a pattern string together with its option flags. */
+static unsigned long _CACHE__HASH(char* regex_pattern_string, int reglib_flags);
+
+/* (Internal) Unlinks an entry from the recently used list of the compiled-pattern cache. */
+static void _CACHE__UNLINK(cregcache_entry_t* cache_entry);
+
+/* (Internal) Removes the least recently used entries until the cache fits into its capacity. */
+static void _CACHE__EVICT(unsigned int capacity);
+
+/* (Internal) Compiles a regular expression pattern, optionally with REG_NOSUB, or takes it from the compiled-pattern cache. */
+static RegEx _CACHE__COMPILE(char* regex_pattern_string, int OPTION_FLAGS, int NOSUB);
+
+/* (Internal) Releases the cache entry of a RegEx object. */
+static void _CACHE__RELEASE(RegEx regex);
+
+/* (Internal) Adds a node to the syntax tree of the Pike VM parser, returns -1 if the pattern is not supported. */
+static int _PIKE__NODE(cregpike_parser_t* parser, int type, int opcode, int arg, int child);
+
+/* (Internal) Adds an empty bracket expression to the Pike VM program, returns its index or -1 without memory. */
+static int _PIKE__NEW_CLASS(cregpike_parser_t* parser);
+
+/* (Internal) Adds the characters of a character class name like "alpha" to a bracket expression, returns 0 for an unknown name. */
+static int _PIKE__ADD_POSIX_CLASS(unsigned char* class_set, char* name, int length);
+
+/* (Internal) Completes a bracket expression with REG_ICASE, a negation and REG_NEWLINE, returns its instruction node. */
+static int _PIKE__CLASS_NODE(cregpike_parser_t* parser, int class_index, int negate);
+
+/* (Internal) Returns the instruction node of a literal character, a bracket expression of both cases with REG_ICASE. */
+static int _PIKE__CHARACTER_NODE(cregpike_parser_t* parser, int c);
+
+/* (Internal) Parses a bracket expression after its "[", collating elements and equivalence classes are not supported. */
+static int _PIKE__PARSE_BRACKET(cregpike_parser_t* parser);
+
+/* (Internal) Returns the node of a "\w", "\W", "\s" or "\S" class escape. */
+static int _PIKE__ESCAPE_CLASS_NODE(cregpike_parser_t* parser, int escape);
+
+/* (Internal) Parses a parenthesized expression, a bracket expression, an anchor, an escape or a literal character. */
+static int _PIKE__PARSE_ATOM(cregpike_parser_t* parser);
+
+/* (Internal) Parses the number of a repetition interval, returns -1 without digits. */
+static int _PIKE__PARSE_NUMBER(cregpike_parser_t* parser);
+
+/* (Internal) Parses an atom and its repetition operators "*", "+", "?" and "{m,n}". */
+static int _PIKE__PARSE_PIECE(cregpike_parser_t* parser);
+
+/* (Internal) Parses a concatenation of pieces until "|", a closing ")" or the pattern end. */
+static int _PIKE__PARSE_SEQUENCE(cregpike_parser_t* parser);
+
+/* (Internal) Parses alternatives separated by "|". */
+static int _PIKE__PARSE_ALTERNATION(cregpike_parser_t* parser);
+
+/* (Internal) Appends an instruction to the Pike VM program, returns its index or -1 if the program is too large. */
+static int _PIKE__EMIT(cregpike_parser_t* parser, int opcode, int arg, int arg2);
+
+/* (Internal) Appends the instructions of a syntax tree node to the Pike VM program. */
+static void _PIKE__EMIT_NODE(cregpike_parser_t* parser, int node_index);
+
+/* (Internal) Reverses the child list of a sequence node, returns the new first child. */
+static int _PIKE__REVERSE_LIST(cregpike_parser_t* parser, int first_child);
+
+/* (Internal) Compiles the syntax tree of a single-line pattern reversed for the reverse DFA, returns NULL without memory. */
+static cregpike_t* _PIKE__COMPILE_REVERSE(cregpike_parser_t* parser, int root);
+
+/* (Internal) Compiles a converted extended regular expression into a Pike VM program, returns NULL if the pattern is not supported. */
+static cregpike_t* _PIKE__COMPILE(char* converted_pattern_string, int reglib_flags, int num_pattern_subexpr);
+
+/* (Internal) Frees a Pike VM program. */
+static void _PIKE__FREE(cregpike_t* program);
+
+/* (Internal) Initializes the workspace of a search, the memory is allocated by the first execution. */
+static void _PIKE__INIT_WORKSPACE(cregpike_workspace_t* workspace);
+
+/* (Internal) Frees the memory of a workspace. */
+static void _PIKE__FREE_WORKSPACE(cregpike_workspace_t* workspace);
+
+/* (Internal) Allocates the thread lists of a workspace for a Pike VM program, returns REGEX_ERROR_MEMORY without memory. */
+static int _PIKE__ALLOC_WORKSPACE(cregpike_t* program, cregpike_workspace_t* workspace);
+
+/* (Internal) Checks a position of a match against an anchor or a word boundary instruction, returns 2 for a "$" whose newline character the match has to consume. */
+static int _PIKE__ASSERT(cregpike_t* program, int opcode, char* text, int match_start, int position, int end, int eflags);
+
+/* (Internal) Adds a thread and the threads of its following jumps, splits, capture slots and assertions to a thread list. */
+static void _PIKE__ADD_THREAD(cregpike_t* program, cregpike_workspace_t* workspace, cregpike_list_t* list, int pc, int* captures, int num_captures, char* text, int position, int end, int eflags);
+
+/* (Internal) Searches the leftmost-longest match of a Pike VM program in the bounds [start, end] of a text, like regexec() with REG_STARTEND. */
+static int _PIKE__EXEC(cregpike_t* program, cregpike_workspace_t* workspace, char* text, int start, int end, size_t nmatch, regmatch_t* pmatch, int eflags);
+
+/* (Internal) Checks if an instruction of a Pike VM program takes a character. */
+static int _PIKE__TAKES(cregpike_t* program, cregpike_instruction_t* instruction, int c);
+
+/* (Internal) Splits the bytes into the classes of bytes which the instructions of a Pike VM program do not distinguish. */
+static void _PIKE__BYTE_CLASSES(cregpike_t* program);
+
+/* (Internal) Returns the Pike VM program which searches a RegEx object instead of regexec(), or NULL. */
+static cregpike_t* _PIKE__SEARCH_PROGRAM(RegEx regex);
+
+/* (Internal) Removes REG_LAZYDFA from the option flags of a single search in a short text, which would not use the DFA. */
+static int _DFA__SEARCH_FLAGS(char* input_text_string, int OPTION_FLAGS);
+
+/* (Internal) Initializes the lazy DFA of a search, the memory is allocated by the first search. */
+static void _DFA__INIT(cregdfa_t* dfa, cregpike_t* program, int anchored);
+
+/* (Internal) Frees the memory of a lazy DFA. */
+static void _DFA__FREE(cregdfa_t* dfa);
+
+/* (Internal) Initializes the lazy DFAs of a RegEx object, a results object or a thread without a program. */
+static void _DFA__INIT_SET(cregdfa_set_t* dfas);
+
+/* (Internal) Frees the memory of the lazy DFAs of a set. */
+static void _DFA__FREE_SET(cregdfa_set_t* dfas);
+
+/* (Internal) Prepares the lazy DFAs of a set for a search with a Pike VM program, the states of the previous searches with the program are kept. */
+static void _DFA__PREPARE_SET(cregdfa_set_t* dfas, cregpike_t* program);
+
+/* (Internal) Allocates the first states of a lazy DFA, returns REGEX_ERROR_MEMORY without memory. */
+static int _DFA__ALLOC(cregdfa_t* dfa);
+
+/* (Internal) Removes all states and transitions of a lazy DFA. */
+static void _DFA__FLUSH(cregdfa_t* dfa);
+
+/* (Internal) Returns the row of the DFA state of a sorted instruction list and a context, REGEX_DFA_FAILED if the DFA is full. */
+static int _DFA__ADD_STATE(cregdfa_t* dfa, int* elements, int num_elements, int context);
+
+/* (Internal) Checks an anchor or a word boundary instruction between the context of a DFA state and the next character, -1 at the text end. */
+static int _DFA__ASSERT(cregdfa_t* dfa, int opcode, int context, int next_byte, int older, int eflags);
+
+/* (Internal) Follows the instructions without a character of a DFA state and of a new thread before the next character, returns 1 if a match ends there. */
+static int _DFA__CLOSURE(cregdfa_t* dfa, int row, int next_byte, int eflags);
+
+/* (Internal) Builds the transition of a DFA state by a byte class, returns the row of the next state, REGEX_DFA_MATCH_ROW(), REGEX_DFA_DEAD or REGEX_DFA_FAILED. */
+static int _DFA__TRANSITION(cregdfa_t* dfa, int row, int byte_class, int num_searched, int eflags);
+
+/* (Internal) Searches the end of the first match in the bounds [start, end] of a text, returns REGEX_DFA_NOMATCH or REGEX_DFA_FAILED without it. */
+static int _DFA__SEARCH(cregdfa_t* dfa, char* text, int start, int end, int eflags);
+
+/* (Internal) Scans a text from the position from to the position to, backwards with a reversed program, returns the farthest position where a match ends, REGEX_DFA_NOMATCH or REGEX_DFA_FAILED. */
+static int _DFA__SEARCH_LONGEST(cregdfa_t* dfa, char* text, int from, int to, int end, int eflags, int* elements, int num_elements);
+
+/* (Internal) Finds the start and the end of the leftmost-longest match of a single-line pattern after a match end of _DFA__SEARCH(), returns the end or REGEX_DFA_FAILED. */
+static int _DFA__SEARCH_SPAN(cregdfa_t* dfa, cregdfa_t* reverse_dfa, cregdfa_t* anchored_dfa, char* text, int match_end, int start, int end, int eflags, int* match_start);
+
+/* (Internal) Copies the strings of the regexec offsets into the result data. */
+static int _EXEC__GET_MATCHED_STRINGS(char* input_text_string, RegExResults results);
+
+/* (Internal) Appends a match to the growable match arrays of the result data. */
+static int _EXEC__APPEND_MATCH(RegExResults results, regmatch_t* match_offset, int number_match, int number_submatch);
+
+/* (Internal) Returns the number of regmatch_t slots for regexec(). */
+static size_t _EXEC__NUM_MATCH_SLOTS(RegEx regex);
+
+/* (Internal) Initializes a cursor for the global search of a compiled RegEx object in a text, returns REGEX_ERROR_MEMORY without memory. */
+static int _EXEC__INIT_CURSOR(cregcursor_t* cursor, RegEx regex, char* input_text_string, int input_text_length, cregdfa_set_t* dfas);
+
+/* (Internal) Frees the buffers of a cursor. */
+static void _EXEC__FREE_CURSOR(cregcursor_t* cursor);
+
+/* (Internal) Sets the group numbers of the valid offsets of the last match, -1 for invalid offsets. */
+static void _EXEC__NUMBER_SUBMATCHES(cregcursor_t* cursor);
+
+/* (Internal) Searches for the next occurence of the regular expression pattern from the read position of a cursor. */
+static int _EXEC__NEXT_MATCH(cregcursor_t* cursor);
+
+/* (Internal) Checks if a group of a match is a result by the REG_SUBEXP and REG_NOSUBEXP options. */
+static int _EXEC__IS_RESULT(RegEx regex, int number_submatch);
+
+/* (Internal) Checks if the regular expression pattern matches the input text string, returns 0 or 1. */
+static int _EXEC__TEST(RegEx regex, char* input_text_string);
 
 /* (Internal) Searches for the first occurence of the regular expression pattern in the input text string. */
-static int _EXEC__SEARCH_LOCAL(char* input_text_string, RegEx regex);
+static int _EXEC__SEARCH_LOCAL(char* input_text_string, int input_text_length, RegEx regex, RegExResults results);
 
 /* (Internal) Searches for all occurences of the regular expression pattern in the input text string. */
-static int _EXEC__SEARCH_GLOBAL(char* input_text_string, RegEx regex);
+static int _EXEC__SEARCH_GLOBAL(char* input_text_string, int input_text_length, RegEx regex, RegExResults results);
+
+/* (Internal) Searches with the result data outside of the compiled RegEx object. */
+static int _EXEC__SEARCH(char* input_text_string, int input_text_length, RegEx regex, RegExResults results);
+
+#ifdef REGEX_PARALLEL_SEARCH
+/* (Internal) Checks if no match of a REG_NEWLINE pattern can contain a newline character or depends on the text bounds. */
+static int _PARALLEL__IS_LINE_PATTERN(RegEx regex);
+
+/* (Internal) Searches for all occurences of the regular expression pattern in a text chunk. */
+static void _PARALLEL__SEARCH_CHUNK(cregparallel_t* parallel, regex_t* compiled_regex, cregdfa_set_t* dfas, cregchunk_t* chunk);
+
+/* (Internal) Searches the next chunks with a compiled pattern and the lazy DFAs of a thread until all chunks are searched. */
+static void _PARALLEL__SEARCH_CHUNKS(cregparallel_t* parallel, regex_t* compiled_regex, cregdfa_set_t* dfas);
+
+/* (Internal) Thread function, searches the next chunks until all chunks are searched. */
+static void* _PARALLEL__WORKER(void* parallel_data);
+
+/* (Internal) Searches for all occurences of the regular expression pattern with threads on text chunks split at newlines. */
+static int _EXEC__SEARCH_PARALLEL(char* input_text_string, int input_text_length, RegEx regex, RegExResults results);
+#endif
+
+/* (Internal) Matches one text of a batch with the scratch cursor of a thread. */
+static void _BATCH__MATCH_TEXT(cregbatch_t* batch, cregcursor_t* cursor, size_t index);
+
+/* (Internal) Takes the next block of texts of a thread or steals half of the remaining texts of another thread. */
+static int _BATCH__NEXT_BLOCK(cregbatch_worker_t* worker, size_t* block_start, size_t* block_end);
+
+/* (Internal) Thread function, matches blocks of texts until all texts are matched. */
+static void* _BATCH__WORKER(void* worker_data);
+
+/* (Internal) Appends the next chunk of a stream to the carried bytes of the buffer, returns the number of bytes read or REGEX_ERROR_MEMORY. */
+static int _STREAM__READ_CHUNK(RegExStream regex_stream);
+
+/* (Internal) Searches a stream chunk by chunk with a compiled regular expression and calls a function for each match. */
+static long _STREAM__SEARCH(RegExStream regex_stream, RegEx regex_data, regex_t* compiled_regex, regex_stream_callback_t callback, void* userdata);
+
+#ifdef REGEX_TREE_SEARCH
+/* (Internal) Stops a tree search, the lock of the tree is held by the caller. */
+static void _TREE__STOP(cregtree_t* tree, int memory_error);
+
+/* (Internal) Adds a file or the files of a directory and its subdirectories to the files of a tree search. */
+static void _TREE__ADD_FILES(cregtree_t* tree, char* path, cregtree_directory_t* parent);
+
+/* (Internal) Stream callback, appends a match to the matches of a file. */
+static int _TREE__COLLECT_MATCH(int number_match, int number_submatch, long start, long end, char* match_text, void* file_data);
+
+/* (Internal) Searches a file of a tree search and calls the callback function with its matches. */
+static void _TREE__SEARCH_FILE(cregtree_t* tree, regex_t* compiled_regex, char* file_name);
+
+/* (Internal) Thread function, searches the next files until all files are searched. */
+static void* _TREE__WORKER(void* tree_data);
+
+#ifdef REGEX_TREE_PREFETCH
+/* (Internal) Starts the reading of the first bytes of a file into the page cache. */
+static void _TREE__PREFETCH_FILE(char* file_name);
+
+/* (Internal) Thread function, reads the files ahead of the searching threads. */
+static void* _TREE__PREFETCHER(void* tree_data);
+#endif
+
+/* (Internal) Initializes the shared data of a tree search. */
+static void _TREE__INIT(cregtree_t* tree, RegEx regex_data, int options, regex_tree_callback_t callback, void* userdata);
+
+/* (Internal) Searches the files of a tree search with threads while the calling thread walks the directory, returns the number of matches. */
+static long _TREE__SEARCH(cregtree_t* tree, char* root_path);
+#endif
 
 static char* _REPLACE__PREPROCESS_GROUPS(RegEx regex_data, char* replace_substring, int i);
 
+/* (Internal) Initializes an empty output string. */
+static void _PRINT__STRING_INIT(cregstring_t* output, size_t capacity);
+
+/* (Internal) Appends a string to an output string, without rescanning the output string. */
+static void _PRINT__APPEND(cregstring_t* output, char* string);
+
+/* (Internal) Appends the first characters of a string to an output string. */
+static void _PRINT__APPEND_LENGTH(cregstring_t* output, const char* string, size_t length);
+
+/* (Internal) Copies a string with escaped carriage return and newline characters, and escaped backslashes for JSON. */
+static char* _PRINT__ESCAPE_STRING(char* escaped_string, char* string, int escape_backslashes);
+
 /* (Intenal) Concatinates substrings of option flag names to the option falgs string */
 static char* _PRINT__CONCAT_OPTION_FLAGS(RegEx regex_data);
 
-/* (Internal) Processes the input text string for printing or writing  */
-static char* _PRINT__GET_TEXT_STRING(RegEx regex_data);
+/* (Internal) Returns the length of the input text string for printing or writing */
+static size_t _PRINT__TEXT_LENGTH(RegEx regex_data);
+
+/* (Internal) Appends the input text string for printing or writing  */
+static void _PRINT__APPEND_TEXT_STRING(RegEx regex_data, cregstring_t* output);
+
+#if defined(REGEX_CONTEXT_KEY)
+/* (Internal) Creates the pthread key of the thread contexts */
+static void _CONTEXT__CREATE_KEY(void);
+
+/* (Internal) Returns the context of the calling thread from the pthread key */
+static RegExContext _CONTEXT__GET_KEY(void);
+
+/* (Internal) Stores the context of the calling thread in the pthread key */
+static void _CONTEXT__SET_KEY(RegExContext context);
+#endif
+
+/* (Internal) Sets a copy of the current limits and options as the context of the calling thread. */
+static RegExContext _CONTEXT__OVERRIDE(RegExContext override_context);
 
 /* (Internal) Processes the data string of the RegEx Object for printing or writing  */
 static char* _PRINT__GET_REGEX_STATS(RegEx regex_data, char* option_flags_string);
@@ -178,6 +1010,38 @@ static char* _PRINT__GET_RESULTS(RegEx regex_data, int PRINT_LAYOUT, int print_h
 /* (Internal) Processes the complete string (text + data + results) for printing or writing  */
 static char* _PRINT__GET_OUTPUT_STRING(RegEx regex_data, int PRINT_LAYOUT);
 
+/* (Internal) Writes a string with escaped carriage return and newline characters for CSV. */
+static void _EXPORT__WRITE_STRING(FILE* file_ptr, char* string, long length);
+
+/* (Internal) Writes a JSON string with all special characters escaped. */
+static void _EXPORT__WRITE_JSON_STRING(FILE* file_ptr, char* string, long length);
+
+/* (Internal) Stores an unsigned number as little-endian bytes. */
+static void _EXPORT__PUT_NUMBER(unsigned char* bytes, unsigned long value, int num_bytes);
+
+/* (Internal) Checks the parameters of an export and writes the JSON or binary header, returns 0 on errors. */
+static int _EXPORT__BEGIN(cregexport_t* export_data, RegEx regex_data, int PRINT_LAYOUT, FILE* file_ptr, char* function_name);
+
+/* (Internal) Writes a match in the layout of the export. */
+static void _EXPORT__WRITE_MATCH(cregexport_t* export_data, int number_match, int number_submatch, long start, long end, char* match_text);
+
+/* (Internal) Callback function of regex_export(), stops the search on write errors. */
+static int _EXPORT__FOREACH_MATCH(int number_match, int number_submatch, int start, int end, void* userdata);
+
+/* (Internal) Callback function of regex_export_stream(), stops the search on write errors. */
+static int _EXPORT__STREAM_MATCH(int number_match, int number_submatch, long start, long end, char* match_text, void* userdata);
+
+/* (Internal) Writes the end of the export, returns the number of results or REGEX_ERROR on write errors. */
+static long _EXPORT__END(cregexport_t* export_data, long num_results, long text_length, char* function_name);
+
+/* (Internal) Writes the stored matches of an executed RegEx object in an export layout, returns the number of results or REGEX_ERROR. */
+static long _EXPORT__WRITE_RESULTS(RegEx regex_data, int PRINT_LAYOUT, FILE* file_ptr, char* function_name);
+
+#ifdef REGEX_FILE_MAPPING
+/* (Internal) Size of the memory mapping of a file, which ends with at least one zero byte behind the file. */
+static size_t _FILE__MAPPING_LENGTH(int file_length);
+#endif
+
 /* Sets the default REG_ flags for regex_compile() and regcomp() */
 void set_default_reg_flags(int OPTION_FLAGS);
 
@@ -191,6 +1055,27 @@ extern int regex_error(RegEx regex);
 /* Executes a compiled regular expression pattern and compares it with a given text input string. */
 extern int regex_exec(char* input_text_string, RegEx regex);
 
+/* Executes a compiled regular expression pattern on a text buffer with a given length. */
+extern int regex_exec_buffer(char* input_text_buffer, int input_text_length, RegEx regex);
+
+/* Removes the matches of a RegEx object and keeps its memory for the next execution */
+extern int regex_reset(RegEx regex);
+
+/* Calls a function for each match of a compiled regular expression pattern without storing the matches. */
+extern int regex_foreach(char* input_text_string, RegEx regex, regex_callback_t callback, void* userdata);
+
+/* Initializes the result data for regex_exec_r(). */
+extern void regex_results_init(RegExResults results);
+
+/* Executes a shared compiled regular expression pattern and writes the matches into separate result data. */
+extern int regex_exec_r(char* input_text_string, RegEx regex, RegExResults results);
+
+/* Frees the allocated memory of the result data of regex_exec_r(). */
+extern void regex_results_free(RegExResults results);
+
+/* Matches a shared compiled regular expression pattern with many text strings on a thread pool. */
+extern int regex_match_batch(RegEx regex, const char** input_text_strings, size_t num_texts, cregbatch_result_t* results, int num_threads);
+
 /* Frees the memory of allocated regex.h buffers and sets the regfree status to 1. */
 extern void regex_close(RegEx regex);
 
@@ -198,21 +1083,73 @@ extern void regex_close(RegEx regex);
    regular expression and returns the RegEx Object with the regular expression results. */
 extern RegEx regex_match(char* input_text_string, char* regex_pattern_string, int OPTION_FLAGS);
 
+/* Checks if a regular expression pattern matches the input text string, without storing match data. */
+extern int regex_test(char* input_text_string, char* regex_pattern_string, int OPTION_FLAGS);
+
+/* Counts the matches of a regular expression pattern in the input text string, without storing match data. */
+extern int regex_count(char* input_text_string, char* regex_pattern_string, int OPTION_FLAGS);
+
 /* Replaces regular expression matches with a substring. */
 extern char* regex_replace(char* input_text_string, char* regex_pattern_string, char* replace_substring, int OPTION_FLAGS);
 
+/* Enables the compiled-pattern cache of regex_match() and regex_replace() with a capacity (0 disables it). */
+extern void regex_cache_init(unsigned int capacity);
+
+/* Returns the capacity, size and hit/miss counters of the compiled-pattern cache. */
+extern cregcache_stats_t regex_cache_stats(void);
+
+/* Removes all compiled patterns from the cache and resets its counters. */
+extern void regex_cache_clear(void);
+
+/* Installs the allocation functions of the library memory (NULL = malloc(), realloc() and free()). */
+extern int regex_set_allocator(regex_malloc_t malloc_function, regex_realloc_t realloc_function, regex_free_t free_function, void* userdata);
+
+/* Initializes a context with the current values of the global limits, default flags and print options. */
+extern void regex_context_init(RegExContext context);
+
+/* Sets the context of the calling thread (NULL = global values) and returns the previous context. */
+extern RegExContext regex_context_set(RegExContext context);
+
 /* Reads a file and matches its contents. */
 extern RegExFile regex_readfile(char* file_name);
 
+#ifdef REGEX_FILE_MAPPING
+/* Maps a file read-only into memory without a copy of its contents. */
+extern RegExFile regex_mapfile(char* file_name);
+#endif
+
 /* Frees the allocated memory for a input file. */
 extern void regex_closefile(RegExFile regex_file);
 
+/* Opens a file, a pipe or stdin ("-") for reading in chunks. */
+extern RegExStream regex_openstream(char* file_name);
+
+/* Calls a function for each match of a line-oriented pattern in a stream with absolute offsets. */
+extern long regex_foreach_stream(RegExStream regex_stream, RegEx regex, regex_stream_callback_t callback, void* userdata);
+
+/* Closes a stream and frees its buffer. */
+extern void regex_closestream(RegExStream regex_stream);
+
+#ifdef REGEX_TREE_SEARCH
+/* Searches the files of a directory tree with threads and calls a function with the matches of each file. */
+extern long regex_search_tree(char* root_path, RegEx regex, int options, regex_tree_callback_t callback, void* userdata);
+
+/* Searches a list of files with threads and calls a function with the matches of each file. */
+extern long regex_search_files(char** file_names, int num_files, RegEx regex, int options, regex_tree_callback_t callback, void* userdata);
+#endif
+
 /* Writes the contents of a RegEx Object into a file. */
 extern int regex_writefile(RegEx regex_data, int PRINT_LAYOUT, char* file_name);
 
 /* int regex_writefile_string(char*, char*): Writes a string into a file. */
 extern int regex_writefile_string(char* output_string, char* file_name);
 
+/* Searches a text and writes each match into a file as soon as it is found. */
+extern long regex_export(char* input_text_string, RegEx regex, int PRINT_LAYOUT, FILE* file_ptr);
+
+/* Searches a stream and writes each match into a file as soon as it is found. */
+extern long regex_export_stream(RegExStream regex_stream, RegEx regex, int PRINT_LAYOUT, FILE* file_ptr);
+
 /* Option flags for regex_print */
 #define REGEX_PRINT_NONE -1
 #define REGEX_PRINT_TABLE (1 << 1)
@@ -230,6 +1167,10 @@ extern int regex_writefile_string(char* output_string, char* file_name);
 #define REGEX_PRINT_NOINDEX (1 << 12)
 #define REGEX_PRINT_FILTER (1 << 13)
 
+/* Layouts for downstream programs */
+#define REGEX_PRINT_NDJSON (1 << 14)
+#define REGEX_PRINT_BINARY (1 << 15)
+
 unsigned int PRINT_COLORED = 0;
 
 /* Prints the input text and the regular expression results and contents of a